@@ -191,4 +191,25 @@ if(xrpld)
       src/test/ledger/Invariants_test.cpp
       PROPERTIES SKIP_UNITY_BUILD_INCLUSION TRUE)
   endif()
+
+  if(benchmarks)
+    # The node store benchmark drives the node store alone, so it is built
+    # from the node store sources rather than linked against rippled.
+    add_executable(xrpl.bench.nodestore)
+    target_include_directories(xrpl.bench.nodestore
+      PRIVATE
+        $<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/src>
+    )
+    file(GLOB_RECURSE sources CONFIGURE_DEPENDS
+      "${CMAKE_CURRENT_SOURCE_DIR}/src/xrpld/nodestore/*.cpp"
+      "${CMAKE_CURRENT_SOURCE_DIR}/src/bench/nodestore/*.cpp"
+    )
+    target_sources(xrpl.bench.nodestore PRIVATE ${sources})
+    target_link_libraries(xrpl.bench.nodestore
+      Ripple::boost
+      Ripple::opts
+      Ripple::libs
+      xrpl.libxrpl
+    )
+  endif()
 endif()
@@ -18,6 +18,8 @@ if(tests)
   endif()
 endif()
 
+option(benchmarks "Build benchmarks" OFF)
+
 option(unity "Creates a build using UNITY support in cmake. This is the default" ON)
 if(unity)
   if(NOT is_ci)
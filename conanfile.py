@@ -83,6 +83,7 @@ class Xrpl(ConanFile):
         'soci/*:with_sqlite3': True,
         'soci/*:with_boost': True,
         'xxhash/*:shared': False,
+        'zstd/*:shared': False,
     }
 
     def set_version(self):
@@ -110,6 +111,7 @@ class Xrpl(ConanFile):
         if self.options.rocksdb:
             self.requires('rocksdb/9.7.3')
         self.requires('xxhash/0.8.2', **transitive_headers_opt)
+        self.requires('zstd/1.5.6', force=True)
 
     exports_sources = (
         'CMakeLists.txt',
@@ -176,6 +178,7 @@ class Xrpl(ConanFile):
             'sqlite3::sqlite',
             'xxhash::xxhash',
             'zlib::zlib',
+            'zstd::zstd',
         ]
         if self.options.rocksdb:
             libxrpl.requires.append('rocksdb::librocksdb')
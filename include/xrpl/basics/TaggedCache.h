@@ -31,6 +31,7 @@
 #include <atomic>
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -46,6 +47,11 @@ namespace ripple {
     If it stays in memory even after it is ejected from the cache,
     the map will track it.
 
+    The map is split into partitions, each with its own lock. Finding an
+    object that is in the cache only takes a shared lock on one partition,
+    and a sweep locks one partition at a time, so lookups are not stopped
+    by each other or by sweeps.
+
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
 */
@@ -111,6 +117,7 @@ public:
 
     using SweptPointersVector = std::vector<SharedWeakUnionPointerType>;
 
+    /** Expire old entries, one partition at a time. */
     void
     sweep();
 
@@ -170,6 +177,11 @@ public:
     bool
     retrieve(key_type const& key, T& data);
 
+    /** Return a mutex for callers that need several operations on the
+        cache, and on their own data, to happen together.
+
+        The cache does not lock this mutex itself.
+    */
     mutex_type&
     peekMutex();
 
@@ -192,8 +204,22 @@ public:
     // End CachedSLEs functions.
 
 private:
+    using partition_lock = std::shared_mutex;
+
+    // Enough partitions that threads rarely meet on the same lock, even on
+    // machines with few cores
+    static constexpr std::size_t minimumPartitions = 16;
+
+    // Return the strong pointer for a key if it is cached, counting a hit.
+    // A weakly held object is revived, which takes an exclusive lock.
+    SharedPointerType
+    initialFetch(key_type const& key);
+
     SharedPointerType
-    initialFetch(key_type const& key, std::lock_guard<mutex_type> const& l);
+    initialFetch(
+        key_type const& key,
+        std::size_t partition,
+        std::lock_guard<partition_lock> const&);
 
     void
     collect_metrics();
@@ -218,14 +244,16 @@ private:
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
 
-        std::size_t hits;
-        std::size_t misses;
+        std::atomic<std::size_t> hits;
+        std::atomic<std::size_t> misses;
     };
 
+    // The access time is atomic so that it can be refreshed while only
+    // holding a shared lock on the partition.
     class KeyOnlyEntry
     {
     public:
-        clock_type::time_point last_access;
+        std::atomic<clock_type::time_point> last_access;
 
         explicit KeyOnlyEntry(clock_type::time_point const& last_access_)
             : last_access(last_access_)
@@ -235,7 +263,7 @@ private:
         void
         touch(clock_type::time_point const& now)
         {
-            last_access = now;
+            last_access.store(now, std::memory_order_relaxed);
         }
     };
 
@@ -243,7 +271,7 @@ private:
     {
     public:
         shared_weak_combo_pointer_type ptr;
-        clock_type::time_point last_access;
+        std::atomic<clock_type::time_point> last_access;
 
         ValueEntry(
             clock_type::time_point const& last_access_,
@@ -277,7 +305,7 @@ private:
         void
         touch(clock_type::time_point const& now)
         {
-            last_access = now;
+            last_access.store(now, std::memory_order_relaxed);
         }
     };
 
@@ -294,28 +322,41 @@ private:
     using cache_type =
         hardened_partitioned_hash_map<key_type, Entry, Hash, KeyEqual>;
 
-    [[nodiscard]] std::thread
+    // Sweep one partition, returning the number of objects removed from
+    // the cache
+    int
     sweepHelper(
         clock_type::time_point const& when_expire,
         [[maybe_unused]] clock_type::time_point const& now,
         typename KeyValueCacheType::map_type& partition,
         SweptPointersVector& stuffToSweep,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&);
+        std::lock_guard<partition_lock> const&);
 
-    [[nodiscard]] std::thread
+    int
     sweepHelper(
         clock_type::time_point const& when_expire,
         clock_type::time_point const& now,
         typename KeyOnlyCacheType::map_type& partition,
         SweptPointersVector&,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&);
+        std::lock_guard<partition_lock> const&);
+
+    // Remove every entry from a partition, returning the number that were
+    // cached
+    int
+    clearPartition(std::size_t partition);
+
+    // Padded so that partitions used by different threads do not share a
+    // cache line
+    struct alignas(64) PartitionLock
+    {
+        partition_lock mutable mutex;
+    };
 
     beast::Journal m_journal;
     clock_type& m_clock;
     Stats m_stats;
 
+    // Not used by the cache itself, see peekMutex()
     mutex_type mutable m_mutex;
 
     // Used for logging
@@ -328,10 +369,11 @@ private:
     clock_type::duration const m_target_age;
 
     // Number of items cached
-    int m_cache_count;
+    std::atomic<int> m_cache_count;
     cache_type m_cache;  // Hold strong reference to recent objects
-    std::uint64_t m_hits;
-    std::uint64_t m_misses;
+    std::vector<PartitionLock> m_locks;
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
 };
 
 }  // namespace ripple
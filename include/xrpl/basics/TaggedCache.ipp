@@ -57,6 +57,10 @@ inline TaggedCache<
     , m_target_size(size)
     , m_target_age(expiration)
     , m_cache_count(0)
+    , m_cache(std::max<std::size_t>(
+          std::thread::hardware_concurrency(),
+          minimumPartitions))
+    , m_locks(m_cache.partitions())
     , m_hits(0)
     , m_misses(0)
 {
@@ -105,8 +109,13 @@ TaggedCache<
     KeyEqual,
     Mutex>::size() const
 {
-    std::lock_guard lock(m_mutex);
-    return m_cache.size();
+    std::size_t ret = 0;
+    for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+    {
+        std::shared_lock lock(m_locks[p].mutex);
+        ret += m_cache.map()[p].size();
+    }
+    return ret;
 }
 
 template <
@@ -129,7 +138,6 @@ TaggedCache<
     KeyEqual,
     Mutex>::getCacheSize() const
 {
-    std::lock_guard lock(m_mutex);
     return m_cache_count;
 }
 
@@ -153,8 +161,7 @@ TaggedCache<
     KeyEqual,
     Mutex>::getTrackSize() const
 {
-    std::lock_guard lock(m_mutex);
-    return m_cache.size();
+    return size();
 }
 
 template <
@@ -177,7 +184,6 @@ TaggedCache<
     KeyEqual,
     Mutex>::getHitRate()
 {
-    std::lock_guard lock(m_mutex);
     auto const total = static_cast<float>(m_hits + m_misses);
     return m_hits * (100.0f / std::max(1.0f, total));
 }
@@ -202,9 +208,8 @@ TaggedCache<
     KeyEqual,
     Mutex>::clear()
 {
-    std::lock_guard lock(m_mutex);
-    m_cache.clear();
-    m_cache_count = 0;
+    for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+        m_cache_count -= clearPartition(p);
 }
 
 template <
@@ -227,9 +232,7 @@ TaggedCache<
     KeyEqual,
     Mutex>::reset()
 {
-    std::lock_guard lock(m_mutex);
-    m_cache.clear();
-    m_cache_count = 0;
+    clear();
     m_hits = 0;
     m_misses = 0;
 }
@@ -255,9 +258,11 @@ TaggedCache<
     KeyEqual,
     Mutex>::touch_if_exists(KeyComparable const& key)
 {
-    std::lock_guard lock(m_mutex);
-    auto const iter(m_cache.find(key));
-    if (iter == m_cache.end())
+    auto const p = m_cache.partition(key);
+    std::shared_lock lock(m_locks[p].mutex);
+    auto& partition = m_cache.map()[p];
+    auto const iter(partition.find(key));
+    if (iter == partition.end())
     {
         ++m_stats.misses;
         return false;
@@ -287,63 +292,56 @@ TaggedCache<
     KeyEqual,
     Mutex>::sweep()
 {
-    // Keep references to all the stuff we sweep
-    // For performance, each worker thread should exit before the swept data
-    // is destroyed but still within the main cache lock.
-    std::vector<SweptPointersVector> allStuffToSweep(m_cache.partitions());
-
     clock_type::time_point const now(m_clock.now());
     clock_type::time_point when_expire;
 
     auto const start = std::chrono::steady_clock::now();
-    {
-        std::lock_guard lock(m_mutex);
+    auto const cacheSize = size();
 
-        if (m_target_size == 0 ||
-            (static_cast<int>(m_cache.size()) <= m_target_size))
-        {
-            when_expire = now - m_target_age;
-        }
-        else
-        {
-            when_expire = now - m_target_age * m_target_size / m_cache.size();
-
-            clock_type::duration const minimumAge(std::chrono::seconds(1));
-            if (when_expire > (now - minimumAge))
-                when_expire = now - minimumAge;
+    if (m_target_size == 0 || (static_cast<int>(cacheSize) <= m_target_size))
+    {
+        when_expire = now - m_target_age;
+    }
+    else
+    {
+        when_expire = now - m_target_age * m_target_size / cacheSize;
 
-            JLOG(m_journal.trace())
-                << m_name << " is growing fast " << m_cache.size() << " of "
-                << m_target_size << " aging at " << (now - when_expire).count()
-                << " of " << m_target_age.count();
-        }
+        clock_type::duration const minimumAge(std::chrono::seconds(1));
+        if (when_expire > (now - minimumAge))
+            when_expire = now - minimumAge;
 
-        std::vector<std::thread> workers;
-        workers.reserve(m_cache.partitions());
-        std::atomic<int> allRemovals = 0;
+        JLOG(m_journal.trace())
+            << m_name << " is growing fast " << cacheSize << " of "
+            << m_target_size << " aging at " << (now - when_expire).count()
+            << " of " << m_target_age.count();
+    }
 
-        for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+    // Only one partition is locked at a time, so lookups in the others
+    // carry on while it is swept.
+    std::chrono::steady_clock::duration longestLock{};
+    for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+    {
+        // Keep references to all the stuff we sweep, so that it is
+        // destroyed outside the lock.
+        SweptPointersVector stuffToSweep;
         {
-            workers.push_back(sweepHelper(
-                when_expire,
-                now,
-                m_cache.map()[p],
-                allStuffToSweep[p],
-                allRemovals,
-                lock));
+            std::lock_guard lock(m_locks[p].mutex);
+            auto const locked = std::chrono::steady_clock::now();
+            m_cache_count -= sweepHelper(
+                when_expire, now, m_cache.map()[p], stuffToSweep, lock);
+            longestLock = std::max(
+                longestLock, std::chrono::steady_clock::now() - locked);
         }
-        for (std::thread& worker : workers)
-            worker.join();
-
-        m_cache_count -= allRemovals;
     }
-    // At this point allStuffToSweep will go out of scope outside the lock
-    // and decrement the reference count on each strong pointer.
+
     JLOG(m_journal.debug())
-        << m_name << " TaggedCache sweep lock duration "
+        << m_name << " TaggedCache sweep duration "
         << std::chrono::duration_cast<std::chrono::milliseconds>(
                std::chrono::steady_clock::now() - start)
                .count()
+        << "ms, longest partition lock "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(longestLock)
+               .count()
         << "ms";
 }
 
@@ -369,11 +367,13 @@ TaggedCache<
 {
     // Remove from cache, if !valid, remove from map too. Returns true if
     // removed from cache
-    std::lock_guard lock(m_mutex);
+    auto const p = m_cache.partition(key);
+    std::lock_guard lock(m_locks[p].mutex);
+    auto& partition = m_cache.map()[p];
 
-    auto cit = m_cache.find(key);
+    auto cit = partition.find(key);
 
-    if (cit == m_cache.end())
+    if (cit == partition.end())
         return false;
 
     Entry& entry = cit->second;
@@ -388,7 +388,7 @@ TaggedCache<
     }
 
     if (!valid || entry.isExpired())
-        m_cache.erase(cit);
+        partition.erase(cit);
 
     return ret;
 }
@@ -420,13 +420,15 @@ TaggedCache<
 {
     // Return canonical value, store if needed, refresh in cache
     // Return values: true=we had the data already
-    std::lock_guard lock(m_mutex);
+    auto const p = m_cache.partition(key);
+    std::lock_guard lock(m_locks[p].mutex);
+    auto& partition = m_cache.map()[p];
 
-    auto cit = m_cache.find(key);
+    auto cit = partition.find(key);
 
-    if (cit == m_cache.end())
+    if (cit == partition.end())
     {
-        m_cache.emplace(
+        partition.emplace(
             std::piecewise_construct,
             std::forward_as_tuple(key),
             std::forward_as_tuple(m_clock.now(), data));
@@ -560,8 +562,7 @@ TaggedCache<
     KeyEqual,
     Mutex>::fetch(key_type const& key)
 {
-    std::lock_guard<mutex_type> l(m_mutex);
-    auto ret = initialFetch(key, l);
+    auto ret = initialFetch(key);
     if (!ret)
         ++m_misses;
     return ret;
@@ -627,14 +628,15 @@ TaggedCache<
     Mutex>::insert(key_type const& key)
     -> std::enable_if_t<IsKeyCache, ReturnType>
 {
-    std::lock_guard lock(m_mutex);
+    auto const p = m_cache.partition(key);
+    std::lock_guard lock(m_locks[p].mutex);
     clock_type::time_point const now(m_clock.now());
-    auto [it, inserted] = m_cache.emplace(
+    auto [it, inserted] = m_cache.map()[p].emplace(
         std::piecewise_construct,
         std::forward_as_tuple(key),
         std::forward_as_tuple(now));
     if (!inserted)
-        it->second.last_access = now;
+        it->second.touch(now);
     return inserted;
 }
 
@@ -713,10 +715,12 @@ TaggedCache<
 {
     std::vector<key_type> v;
 
+    for (std::size_t p = 0; p < m_cache.partitions(); ++p)
     {
-        std::lock_guard lock(m_mutex);
-        v.reserve(m_cache.size());
-        for (auto const& _ : m_cache)
+        std::shared_lock lock(m_locks[p].mutex);
+        auto const& partition = m_cache.map()[p];
+        v.reserve(v.size() + partition.size());
+        for (auto const& _ : partition)
             v.push_back(_.first);
     }
 
@@ -743,11 +747,11 @@ TaggedCache<
     KeyEqual,
     Mutex>::rate() const
 {
-    std::lock_guard lock(m_mutex);
-    auto const tot = m_hits + m_misses;
+    auto const hits = m_hits.load();
+    auto const tot = hits + m_misses.load();
     if (tot == 0)
         return 0;
-    return double(m_hits) / tot;
+    return double(hits) / tot;
 }
 
 template <
@@ -771,26 +775,70 @@ TaggedCache<
     KeyEqual,
     Mutex>::fetch(key_type const& digest, Handler const& h)
 {
-    {
-        std::lock_guard l(m_mutex);
-        if (auto ret = initialFetch(digest, l))
-            return ret;
-    }
+    if (auto ret = initialFetch(digest))
+        return ret;
 
     auto sle = h();
     if (!sle)
         return {};
 
-    std::lock_guard l(m_mutex);
+    auto const p = m_cache.partition(digest);
+    std::lock_guard l(m_locks[p].mutex);
     ++m_misses;
-    auto const [it, inserted] =
-        m_cache.emplace(digest, Entry(m_clock.now(), std::move(sle)));
+    auto const [it, inserted] = m_cache.map()[p].emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(digest),
+        std::forward_as_tuple(m_clock.now(), std::move(sle)));
     if (!inserted)
         it->second.touch(m_clock.now());
     return it->second.ptr.getStrong();
 }
 // End CachedSLEs functions.
 
+template <
+    class Key,
+    class T,
+    bool IsKeyCache,
+    class SharedWeakUnionPointer,
+    class SharedPointerType,
+    class Hash,
+    class KeyEqual,
+    class Mutex>
+inline SharedPointerType
+TaggedCache<
+    Key,
+    T,
+    IsKeyCache,
+    SharedWeakUnionPointer,
+    SharedPointerType,
+    Hash,
+    KeyEqual,
+    Mutex>::initialFetch(key_type const& key)
+{
+    auto const p = m_cache.partition(key);
+
+    {
+        std::shared_lock lock(m_locks[p].mutex);
+        auto& partition = m_cache.map()[p];
+        auto cit = partition.find(key);
+        if (cit == partition.end())
+            return {};
+
+        Entry& entry = cit->second;
+        if (entry.isCached())
+        {
+            ++m_hits;
+            entry.touch(m_clock.now());
+            return entry.ptr.getStrong();
+        }
+    }
+
+    // The entry is only weakly held. Reviving or removing it needs the
+    // partition to ourselves.
+    std::lock_guard lock(m_locks[p].mutex);
+    return initialFetch(key, p, lock);
+}
+
 template <
     class Key,
     class T,
@@ -810,10 +858,14 @@ TaggedCache<
     Hash,
     KeyEqual,
     Mutex>::
-    initialFetch(key_type const& key, std::lock_guard<mutex_type> const& l)
+    initialFetch(
+        key_type const& key,
+        std::size_t p,
+        std::lock_guard<partition_lock> const&)
 {
-    auto cit = m_cache.find(key);
-    if (cit == m_cache.end())
+    auto& partition = m_cache.map()[p];
+    auto cit = partition.find(key);
+    if (cit == partition.end())
         return {};
 
     Entry& entry = cit->second;
@@ -832,7 +884,7 @@ TaggedCache<
         return entry.ptr.getStrong();
     }
 
-    m_cache.erase(cit);
+    partition.erase(cit);
     return {};
 }
 
@@ -861,10 +913,10 @@ TaggedCache<
     {
         beast::insight::Gauge::value_type hit_rate(0);
         {
-            std::lock_guard lock(m_mutex);
-            auto const total(m_hits + m_misses);
+            auto const hits = m_hits.load();
+            auto const total(hits + m_misses.load());
             if (total != 0)
-                hit_rate = (m_hits * 100) / total;
+                hit_rate = (hits * 100) / total;
         }
         m_stats.hit_rate.set(hit_rate);
     }
@@ -879,7 +931,44 @@ template <
     class Hash,
     class KeyEqual,
     class Mutex>
-inline std::thread
+inline int
+TaggedCache<
+    Key,
+    T,
+    IsKeyCache,
+    SharedWeakUnionPointer,
+    SharedPointerType,
+    Hash,
+    KeyEqual,
+    Mutex>::clearPartition(std::size_t p)
+{
+    std::lock_guard lock(m_locks[p].mutex);
+    auto& partition = m_cache.map()[p];
+
+    int cached = 0;
+    if constexpr (!IsKeyCache)
+    {
+        for (auto const& [_, entry] : partition)
+        {
+            if (entry.isCached())
+                ++cached;
+        }
+    }
+
+    partition.clear();
+    return cached;
+}
+
+template <
+    class Key,
+    class T,
+    bool IsKeyCache,
+    class SharedWeakUnionPointer,
+    class SharedPointerType,
+    class Hash,
+    class KeyEqual,
+    class Mutex>
+inline int
 TaggedCache<
     Key,
     T,
@@ -894,69 +983,68 @@ TaggedCache<
         [[maybe_unused]] clock_type::time_point const& now,
         typename KeyValueCacheType::map_type& partition,
         SweptPointersVector& stuffToSweep,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        std::lock_guard<partition_lock> const&)
 {
-    return std::thread([&, this]() {
-        int cacheRemovals = 0;
-        int mapRemovals = 0;
+    int cacheRemovals = 0;
+    int mapRemovals = 0;
 
-        // Keep references to all the stuff we sweep
-        // so that we can destroy them outside the lock.
-        stuffToSweep.reserve(partition.size());
+    // Keep references to all the stuff we sweep
+    // so that we can destroy them outside the lock.
+    stuffToSweep.reserve(partition.size());
+    {
+        auto cit = partition.begin();
+        while (cit != partition.end())
         {
-            auto cit = partition.begin();
-            while (cit != partition.end())
+            if (cit->second.isWeak())
             {
-                if (cit->second.isWeak())
+                // weak
+                if (cit->second.isExpired())
                 {
-                    // weak
-                    if (cit->second.isExpired())
-                    {
-                        stuffToSweep.emplace_back(std::move(cit->second.ptr));
-                        ++mapRemovals;
-                        cit = partition.erase(cit);
-                    }
-                    else
-                    {
-                        ++cit;
-                    }
+                    stuffToSweep.emplace_back(std::move(cit->second.ptr));
+                    ++mapRemovals;
+                    cit = partition.erase(cit);
                 }
-                else if (cit->second.last_access <= when_expire)
+                else
+                {
+                    ++cit;
+                }
+            }
+            else if (
+                cit->second.last_access.load(std::memory_order_relaxed) <=
+                when_expire)
+            {
+                // strong, expired
+                ++cacheRemovals;
+                if (cit->second.ptr.use_count() == 1)
                 {
-                    // strong, expired
-                    ++cacheRemovals;
-                    if (cit->second.ptr.use_count() == 1)
-                    {
-                        stuffToSweep.emplace_back(std::move(cit->second.ptr));
-                        ++mapRemovals;
-                        cit = partition.erase(cit);
-                    }
-                    else
-                    {
-                        // remains weakly cached
-                        cit->second.ptr.convertToWeak();
-                        ++cit;
-                    }
+                    stuffToSweep.emplace_back(std::move(cit->second.ptr));
+                    ++mapRemovals;
+                    cit = partition.erase(cit);
                 }
                 else
                 {
-                    // strong, not expired
+                    // remains weakly cached
+                    cit->second.ptr.convertToWeak();
                     ++cit;
                 }
             }
+            else
+            {
+                // strong, not expired
+                ++cit;
+            }
         }
+    }
 
-        if (mapRemovals || cacheRemovals)
-        {
-            JLOG(m_journal.debug())
-                << "TaggedCache partition sweep " << m_name
-                << ": cache = " << partition.size() << "-" << cacheRemovals
-                << ", map-=" << mapRemovals;
-        }
+    if (mapRemovals || cacheRemovals)
+    {
+        JLOG(m_journal.debug())
+            << "TaggedCache partition sweep " << m_name
+            << ": cache = " << partition.size() << "-" << cacheRemovals
+            << ", map-=" << mapRemovals;
+    }
 
-        allRemovals += cacheRemovals;
-    });
+    return cacheRemovals;
 }
 
 template <
@@ -968,7 +1056,7 @@ template <
     class Hash,
     class KeyEqual,
     class Mutex>
-inline std::thread
+inline int
 TaggedCache<
     Key,
     T,
@@ -983,45 +1071,42 @@ TaggedCache<
         clock_type::time_point const& now,
         typename KeyOnlyCacheType::map_type& partition,
         SweptPointersVector&,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        std::lock_guard<partition_lock> const&)
 {
-    return std::thread([&, this]() {
-        int cacheRemovals = 0;
-        int mapRemovals = 0;
+    int cacheRemovals = 0;
+    int mapRemovals = 0;
 
-        // Keep references to all the stuff we sweep
-        // so that we can destroy them outside the lock.
+    {
+        auto cit = partition.begin();
+        while (cit != partition.end())
         {
-            auto cit = partition.begin();
-            while (cit != partition.end())
+            auto const last_access =
+                cit->second.last_access.load(std::memory_order_relaxed);
+            if (last_access > now)
             {
-                if (cit->second.last_access > now)
-                {
-                    cit->second.last_access = now;
-                    ++cit;
-                }
-                else if (cit->second.last_access <= when_expire)
-                {
-                    cit = partition.erase(cit);
-                }
-                else
-                {
-                    ++cit;
-                }
+                cit->second.touch(now);
+                ++cit;
+            }
+            else if (last_access <= when_expire)
+            {
+                cit = partition.erase(cit);
+            }
+            else
+            {
+                ++cit;
             }
         }
+    }
 
-        if (mapRemovals || cacheRemovals)
-        {
-            JLOG(m_journal.debug())
-                << "TaggedCache partition sweep " << m_name
-                << ": cache = " << partition.size() << "-" << cacheRemovals
-                << ", map-=" << mapRemovals;
-        }
+    if (mapRemovals || cacheRemovals)
+    {
+        JLOG(m_journal.debug())
+            << "TaggedCache partition sweep " << m_name
+            << ": cache = " << partition.size() << "-" << cacheRemovals
+            << ", map-=" << mapRemovals;
+    }
 
-        allRemovals += cacheRemovals;
-    });
+    return cacheRemovals;
 }
 
 }  // namespace ripple
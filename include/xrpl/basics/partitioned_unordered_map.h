@@ -271,12 +271,25 @@ public:
         return partitions_;
     }
 
+    /** Return the index of the partition that holds a key. */
+    std::size_t
+    partition(key_type const& key) const
+    {
+        return partitioner(key);
+    }
+
     partition_map_type&
     map()
     {
         return map_;
     }
 
+    partition_map_type const&
+    map() const
+    {
+        return map_;
+    }
+
     iterator
     begin()
     {
@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_CORE_CURRENT_THREAD_AFFINITY_H_INCLUDED
+#define BEAST_CORE_CURRENT_THREAD_AFFINITY_H_INCLUDED
+
+#include <vector>
+
+namespace beast {
+
+/** Restricts the caller thread to run on the given CPUs.
+
+    Memory the thread touches first is then, by the default policy of the
+    operating system, allocated from the NUMA node of those CPUs.
+
+    @return false if the CPUs are not valid, or if the operating system does
+        not support it, in which case the thread may run on any CPU.
+*/
+bool
+setCurrentThreadAffinity(std::vector<int> const& cpus);
+
+}  // namespace beast
+
+#endif
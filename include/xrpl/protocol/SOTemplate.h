@@ -161,7 +161,15 @@ public:
 
     /** Retrieve the position of a named field. */
     int
-    getIndex(SField const&) const;
+    getIndex(SField const& sField) const
+    {
+        // The mapping table should be large enough for any possible field
+        //
+        if (sField.getNum() <= 0 || sField.getNum() >= indices_.size())
+            Throw<std::runtime_error>("Invalid field index for getIndex().");
+
+        return indices_[sField.getNum()];
+    }
 
     SOEStyle
     style(SField const& sf) const
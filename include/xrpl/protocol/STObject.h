@@ -999,6 +999,35 @@ STObject::peekAtPIndex(int offset) const
     return &v_[offset].get();
 }
 
+// Field lookups are made very often, so these are inline. An object with a
+// template finds a field's position in the template's index.
+inline int
+STObject::getFieldIndex(SField const& field) const
+{
+    if (mType != nullptr)
+        return mType->getIndex(field);
+
+    int i = 0;
+    for (auto const& elem : v_)
+    {
+        if (elem->getFName() == field)
+            return i;
+        ++i;
+    }
+    return -1;
+}
+
+inline STBase const*
+STObject::peekAtPField(SField const& field) const
+{
+    int index = getFieldIndex(field);
+
+    if (index == -1)
+        return nullptr;
+
+    return peekAtPIndex(index);
+}
+
 inline STBase*
 STObject::getPIndex(int offset)
 {
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_PROTOCOL_DIGEST_H_INCLUDED
 #define RIPPLE_PROTOCOL_DIGEST_H_INCLUDED
 
+#include <xrpl/basics/Slice.h>
 #include <xrpl/basics/base_uint.h>
 #include <xrpl/crypto/secure_erase.h>
 
@@ -27,6 +28,7 @@
 
 #include <algorithm>
 #include <array>
+#include <span>
 
 namespace ripple {
 
@@ -246,6 +248,47 @@ sha512Half_s(Args const&... args)
     return static_cast<typename sha512_half_hasher_s::result_type>(h);
 }
 
+//------------------------------------------------------------------------------
+
+/** Returns the SHA512-Half of each of a batch of independent messages.
+
+    The digests are identical to calling sha512Half on each message, but on
+    processors with AVX2 or AVX-512 several messages are hashed at once with
+    a multi-buffer SHA-512 implementation. The implementation is chosen at
+    runtime, falling back to hashing one message at a time with OpenSSL.
+
+    @param messages The messages to hash.
+    @param digests Receives the digest of each message, in the same order.
+                   Must have the same size as messages.
+*/
+void
+sha512HalfBatch(std::span<Slice const> messages, std::span<uint256> digests);
+
+namespace detail {
+
+/** The implementations behind sha512HalfBatch. */
+enum class sha512_engine {
+    openssl,  // one message at a time
+    avx2,     // four messages at a time
+    avx512    // eight messages at a time
+};
+
+/** Returns true if the engine can run on this processor. */
+bool
+sha512EngineSupported(sha512_engine engine);
+
+char const*
+to_string(sha512_engine engine);
+
+/** Like sha512HalfBatch, but with a specific, supported, engine. */
+void
+sha512HalfBatch(
+    sha512_engine engine,
+    std::span<Slice const> messages,
+    std::span<uint256> digests);
+
+}  // namespace detail
+
 }  // namespace ripple
 
 #endif
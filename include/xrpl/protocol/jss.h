@@ -468,6 +468,7 @@ JSS(offers);                  // out: NetworkOPs, AccountOffers, Subscribe
 JSS(offer_id);                // out: insertNFTokenOfferID
 JSS(offline);                 // in: TransactionSign
 JSS(offset);                  // in/out: AccountTxOld
+JSS(online_delete);           // out: NetworkOPs
 JSS(open);                    // out: handlers/Ledger
 JSS(open_ledger_cost);        // out: SubmitTransaction
 JSS(open_ledger_fee);         // out: TxQ
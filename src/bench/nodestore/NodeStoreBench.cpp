@@ -0,0 +1,664 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/nodestore/DummyScheduler.h>
+#include <xrpld/nodestore/Manager.h>
+#include <xrpld/nodestore/detail/DatabaseRotatingImp.h>
+
+#include <xrpl/basics/BasicConfig.h>
+#include <xrpl/basics/ByteUtilities.h>
+#include <xrpl/basics/random.h>
+#include <xrpl/beast/utility/rngfill.h>
+#include <xrpl/beast/utility/temp_dir.h>
+#include <xrpl/beast/xor_shift_engine.h>
+#include <xrpl/json/to_string.h>
+#include <xrpl/protocol/HashPrefix.h>
+#include <xrpl/protocol/Indexes.h>
+#include <xrpl/protocol/STLedgerEntry.h>
+#include <xrpl/protocol/Serializer.h>
+#include <xrpl/protocol/digest.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+
+/*  Measures the latency of the node store under a ledger-like load.
+
+    Unlike the Timing unit test, which reports the total time of each phase
+    for uniformly random keys, this drives a whole Database, optionally a
+    rotating one, with a mix of reads, batch writes and rotations from
+    several threads, and reports latency percentiles for each kind of
+    operation.
+
+    The objects are shaped like those of a real node: inner nodes with few
+    branches, and leaves. Their sizes, and the share of inner nodes, can be
+    taken from a sample of an existing database. Reads favour a hot set, as
+    those of a server following the network do.
+
+    The results are written to standard output as JSON.
+*/
+
+namespace ripple {
+namespace NodeStore {
+namespace {
+
+char const* const usage =
+    "Usage: xrpl.bench.nodestore [<key>=<value> ...]\n"
+    "\n"
+    "type=<type>         Backend to measure: memory, nudb or rocksdb (nudb)\n"
+    "path=<path>         Directory for the databases (a temporary one)\n"
+    "objects=<count>     Objects stored before measuring (200000)\n"
+    "ops=<count>         Operations for each thread count (100000)\n"
+    "threads=<list>      Comma separated thread counts (1,2,4,8)\n"
+    "reads=<percent>     Share of operations which are reads (90)\n"
+    "batch=<count>       Objects stored by each write (64)\n"
+    "skew=<exponent>     Zipf exponent of the read keys, 0 for uniform (1.0)\n"
+    "miss=<ratio>        Share of reads for missing objects (0.05)\n"
+    "inner=<ratio>       Share of inner nodes, unless sampled (0.45)\n"
+    "rotate_every=<ops>  Rotate the databases every so many operations,\n"
+    "                    0 to use a database which does not rotate (0)\n"
+    "copy=<ratio>        Share of the hottest objects copied forward at\n"
+    "                    each rotation (0.1)\n"
+    "sample_type=<type>  Backend of a database to take object sizes and the\n"
+    "sample_path=<path>  share of inner nodes from. It is read once, and\n"
+    "                    must not be in use.\n"
+    "samples=<count>     Objects to sample (20000)\n"
+    "\n"
+    "Any other keys, such as compression or cache settings, are passed to\n"
+    "the backend.\n";
+
+//------------------------------------------------------------------------------
+
+bool
+isInnerNode(Blob const& data)
+{
+    if (data.size() < 4)
+        return false;
+
+    auto const prefix = (std::uint32_t{data[0]} << 24) |
+        (std::uint32_t{data[1]} << 16) | (std::uint32_t{data[2]} << 8) |
+        std::uint32_t{data[3]};
+    return prefix == static_cast<std::uint32_t>(HashPrefix::innerNode);
+}
+
+/*  Makes objects shaped like real ones.
+
+    Each object is a copy of a template with its hashes or key replaced, so
+    that it has the size and structure of the template but is unique. The
+    hash of an object is that of its data, as for ledger objects.
+*/
+class Workload
+{
+    struct Template
+    {
+        NodeObjectType type;
+        Blob data;
+    };
+
+    std::vector<Template> templates_;
+
+    static Blob
+    makeInner(beast::xor_shift_engine& rng)
+    {
+        // Most inner nodes are near the leaves, and have few branches
+        int const branches = std::min(
+            16, 1 + static_cast<int>(std::exponential_distribution<double>(
+                        0.5)(rng)));
+
+        Serializer s(4 + 16 * uint256::bytes);
+        s.add32(HashPrefix::innerNode);
+        std::array<bool, 16> used{};
+        for (int i = 0; i < branches;)
+        {
+            auto const branch = rand_int(rng, 15);
+            if (!used[branch])
+            {
+                used[branch] = true;
+                ++i;
+            }
+        }
+        for (auto const u : used)
+        {
+            uint256 child;
+            if (u)
+                beast::rngfill(child.begin(), child.size(), rng);
+            s.addBitString(child);
+        }
+        return std::move(s.modData());
+    }
+
+    static Blob
+    makeLeaf(beast::xor_shift_engine& rng)
+    {
+        AccountID account;
+        beast::rngfill(account.begin(), account.size(), rng);
+        uint256 txID;
+        beast::rngfill(txID.begin(), txID.size(), rng);
+
+        STLedgerEntry sle(keylet::account(account));
+        sle.setAccountID(sfAccount, account);
+        sle.setFieldAmount(
+            sfBalance,
+            XRPAmount(rand_int(
+                rng,
+                std::int64_t{10'000'000},
+                std::int64_t{1'000'000'000'000})));
+        sle.setFieldU32(sfSequence, rand_int(rng, 1, 90'000'000));
+        sle.setFieldU32(sfOwnerCount, rand_int(rng, 0, 20));
+        sle.setFieldH256(sfPreviousTxnID, txID);
+        sle.setFieldU32(sfPreviousTxnLgrSeq, rand_int(rng, 1, 90'000'000));
+
+        // The layout of a SHAMap leaf
+        Serializer s;
+        s.add32(HashPrefix::leafNode);
+        sle.add(s);
+        s.addBitString(sle.key());
+        return std::move(s.modData());
+    }
+
+    void
+    sample(Section const& params, std::size_t count)
+    {
+        Section config;
+        config.set("type", get(params, "sample_type"));
+        config.set("path", get(params, "sample_path"));
+
+        DummyScheduler scheduler;
+        beast::Journal const j{beast::Journal::getNullSink()};
+        auto backend = Manager::instance().make_Backend(
+            config, megabytes(4), scheduler, j);
+        backend->open(false);
+
+        // Reservoir sampling, so that every object has the same chance of
+        // being picked whatever the size of the database.
+        std::uint64_t seen = 0;
+        backend->for_each([&](std::shared_ptr<NodeObject> object) {
+            if (templates_.size() < count)
+                templates_.push_back({object->getType(), object->getData()});
+            else if (auto const i = rand_int<std::uint64_t>(seen); i < count)
+                templates_[i] = {object->getType(), object->getData()};
+            ++seen;
+        });
+        backend->close();
+
+        if (templates_.empty())
+            Throw<std::runtime_error>("No objects to sample");
+    }
+
+public:
+    explicit Workload(Section const& params)
+    {
+        auto const count = get<std::size_t>(params, "samples", 20'000);
+        if (!get(params, "sample_path").empty())
+        {
+            sample(params, count);
+            return;
+        }
+
+        auto const inner = get<double>(params, "inner", 0.45);
+        beast::xor_shift_engine rng(1);
+        templates_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (std::uniform_real_distribution<double>()(rng) < inner)
+                templates_.push_back({hotACCOUNT_NODE, makeInner(rng)});
+            else
+                templates_.push_back({hotACCOUNT_NODE, makeLeaf(rng)});
+        }
+    }
+
+    std::shared_ptr<NodeObject>
+    make(beast::xor_shift_engine& rng) const
+    {
+        auto const& t = templates_[rand_int(rng, templates_.size() - 1)];
+        Blob data = t.data;
+
+        if (isInnerNode(data) && data.size() == 4 + 16 * uint256::bytes)
+        {
+            // New children on the same branches
+            for (auto p = data.begin() + 4; p != data.end();
+                 p += uint256::bytes)
+            {
+                if (std::any_of(p, p + uint256::bytes, [](auto b) {
+                        return b != 0;
+                    }))
+                    beast::rngfill(&*p, uint256::bytes, rng);
+            }
+        }
+        else
+        {
+            // A leaf ends with its key
+            auto const n = std::min<std::size_t>(
+                uint256::bytes, data.size() > 4 ? data.size() - 4 : 0);
+            beast::rngfill(data.data() + data.size() - n, n, rng);
+        }
+
+        auto const hash = sha512Half(makeSlice(data));
+        return NodeObject::createObject(t.type, std::move(data), hash);
+    }
+
+    Json::Value
+    getJson() const
+    {
+        std::size_t inner = 0;
+        std::size_t bytes = 0;
+        for (auto const& t : templates_)
+        {
+            if (isInnerNode(t.data))
+                ++inner;
+            bytes += t.data.size();
+        }
+
+        Json::Value ret(Json::objectValue);
+        ret["templates"] = static_cast<Json::UInt>(templates_.size());
+        ret["inner_ratio"] =
+            static_cast<double>(inner) / templates_.size();
+        ret["mean_bytes"] = static_cast<double>(bytes) / templates_.size();
+        return ret;
+    }
+};
+
+/*  Picks ranks from a Zipf distribution.
+
+    Rank 0 is the most popular. With an exponent of 0 every rank is as
+    likely as every other.
+*/
+class Zipf
+{
+    std::vector<double> cdf_;
+
+public:
+    Zipf(std::size_t n, double exponent)
+    {
+        cdf_.reserve(n);
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            cdf_.push_back(sum);
+        }
+        for (auto& c : cdf_)
+            c /= sum;
+    }
+
+    std::size_t
+    operator()(beast::xor_shift_engine& rng) const
+    {
+        auto const u = std::uniform_real_distribution<double>()(rng);
+        auto const i = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+        return std::min<std::size_t>(i - cdf_.begin(), cdf_.size() - 1);
+    }
+};
+
+// Latencies in nanoseconds
+struct Latencies
+{
+    std::vector<std::uint64_t> reads;
+    std::vector<std::uint64_t> writes;
+    std::vector<std::uint64_t> rotations;
+    std::uint64_t hits = 0;
+};
+
+Json::Value
+summarize(std::vector<std::uint64_t>& ns, std::size_t objectsPerOp = 1)
+{
+    Json::Value ret(Json::objectValue);
+    ret["count"] = static_cast<Json::UInt>(ns.size());
+    if (ns.empty())
+        return ret;
+
+    std::sort(ns.begin(), ns.end());
+    auto const at = [&ns](double q) {
+        auto const i = static_cast<std::size_t>(std::ceil(q * ns.size()));
+        return ns[std::clamp<std::size_t>(i, 1, ns.size()) - 1] / 1000.0;
+    };
+
+    std::uint64_t total = 0;
+    for (auto const n : ns)
+        total += n;
+
+    ret["mean_us"] = total / 1000.0 / ns.size();
+    ret["p50_us"] = at(0.5);
+    ret["p99_us"] = at(0.99);
+    ret["p999_us"] = at(0.999);
+    ret["max_us"] = ns.back() / 1000.0;
+    if (objectsPerOp > 1)
+        ret["objects"] = static_cast<Json::UInt>(ns.size() * objectsPerOp);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+class Bench
+{
+    Section const params_;
+    beast::Journal const j_{beast::Journal::getNullSink()};
+    DummyScheduler scheduler_;
+    std::optional<beast::temp_dir> tempDir_;
+    boost::filesystem::path dir_;
+
+    std::size_t const objects_;
+    std::size_t const ops_;
+    std::size_t const reads_;
+    std::size_t const batch_;
+    double const miss_;
+    std::size_t const rotateEvery_;
+    std::size_t const copy_;
+
+    Workload const workload_;
+    Zipf const zipf_;
+
+    std::unique_ptr<Database> db_;
+    DatabaseRotating* rotating_ = nullptr;
+    std::vector<uint256> keys_;
+    std::mutex rotateMutex_;
+    int generation_ = 0;
+
+    std::unique_ptr<Backend>
+    makeBackend()
+    {
+        Section params = params_;
+        params.set(
+            "path", (dir_ / std::to_string(++generation_)).string());
+        auto backend = Manager::instance().make_Backend(
+            params, megabytes(4), scheduler_, j_);
+        backend->open();
+        return backend;
+    }
+
+    void
+    open()
+    {
+        if (rotateEvery_ == 0)
+        {
+            Section params = params_;
+            params.set("path", (dir_ / "db").string());
+            db_ = Manager::instance().make_Database(
+                megabytes(4), scheduler_, 4, params, j_);
+            return;
+        }
+
+        auto archive = makeBackend();
+        auto writable = makeBackend();
+        auto db = std::make_unique<DatabaseRotatingImp>(
+            scheduler_,
+            4,
+            std::move(writable),
+            std::move(archive),
+            params_,
+            j_);
+        rotating_ = db.get();
+        db_ = std::move(db);
+    }
+
+    void
+    populate()
+    {
+        beast::xor_shift_engine rng(2);
+        keys_.reserve(objects_);
+        for (std::size_t i = 0; i < objects_; ++i)
+        {
+            auto object = workload_.make(rng);
+            keys_.push_back(object->getHash());
+            db_->store(
+                object->getType(),
+                Blob(object->getData()),
+                object->getHash(),
+                0);
+        }
+        db_->sync();
+    }
+
+    // Rotate, then copy the hottest objects forward as online delete does
+    void
+    rotate()
+    {
+        std::lock_guard lock(rotateMutex_);
+        rotating_->rotate(
+            makeBackend(), [](std::string const&, std::string const&) {});
+        for (std::size_t i = 0; i < copy_; ++i)
+            db_->fetchNodeObject(keys_[i], 0, FetchType::synchronous, true);
+    }
+
+    void
+    work(
+        std::atomic<std::size_t>& next,
+        Latencies& latencies,
+        std::uint64_t seed)
+    {
+        using clock_type = std::chrono::steady_clock;
+        auto const elapsed = [](clock_type::time_point start) {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - start)
+                    .count());
+        };
+
+        beast::xor_shift_engine rng(seed);
+        std::vector<std::shared_ptr<NodeObject>> batch;
+        batch.reserve(batch_);
+
+        for (auto i = next++; i < ops_; i = next++)
+        {
+            if (rotateEvery_ != 0 && i % rotateEvery_ == rotateEvery_ - 1)
+            {
+                auto const start = clock_type::now();
+                rotate();
+                latencies.rotations.push_back(elapsed(start));
+            }
+            else if (rand_int(rng, std::size_t{99}) < reads_)
+            {
+                uint256 hash;
+                if (std::uniform_real_distribution<double>()(rng) < miss_)
+                    beast::rngfill(hash.begin(), hash.size(), rng);
+                else
+                    hash = keys_[zipf_(rng)];
+
+                auto const start = clock_type::now();
+                auto const object = db_->fetchNodeObject(hash);
+                latencies.reads.push_back(elapsed(start));
+                if (object)
+                    ++latencies.hits;
+            }
+            else
+            {
+                batch.clear();
+                for (std::size_t n = 0; n < batch_; ++n)
+                    batch.push_back(workload_.make(rng));
+
+                auto const start = clock_type::now();
+                for (auto& object : batch)
+                {
+                    db_->store(
+                        object->getType(),
+                        Blob(object->getData()),
+                        object->getHash(),
+                        0);
+                }
+                latencies.writes.push_back(elapsed(start));
+            }
+        }
+    }
+
+public:
+    explicit Bench(Section const& params)
+        : params_(params)
+        , objects_(std::max<std::size_t>(
+              get<std::size_t>(params, "objects", 200'000),
+              1))
+        , ops_(get<std::size_t>(params, "ops", 100'000))
+        , reads_(std::min<std::size_t>(
+              get<std::size_t>(params, "reads", 90),
+              100))
+        , batch_(std::max<std::size_t>(
+              get<std::size_t>(params, "batch", 64),
+              1))
+        , miss_(get<double>(params, "miss", 0.05))
+        , rotateEvery_(get<std::size_t>(params, "rotate_every", 0))
+        , copy_(static_cast<std::size_t>(
+              std::clamp(get<double>(params, "copy", 0.1), 0.0, 1.0) *
+              objects_))
+        , workload_(params)
+        , zipf_(objects_, get<double>(params, "skew", 1.0))
+    {
+        if (auto const path = get(params, "path"); !path.empty())
+        {
+            dir_ = path;
+            boost::filesystem::create_directories(dir_);
+        }
+        else
+        {
+            tempDir_.emplace();
+            dir_ = tempDir_->path();
+        }
+
+        open();
+        populate();
+    }
+
+    ~Bench()
+    {
+        db_->stop();
+    }
+
+    Json::Value
+    run(int threads)
+    {
+        std::atomic<std::size_t> next{0};
+        std::vector<Latencies> latencies(threads);
+        std::vector<std::thread> workers;
+
+        auto const start = std::chrono::steady_clock::now();
+        for (int i = 0; i < threads; ++i)
+        {
+            workers.emplace_back(
+                [this, &next, &latencies, i, threads]() {
+                    work(next, latencies[i], 1000 * threads + i);
+                });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        db_->sync();
+        std::chrono::duration<double> const seconds =
+            std::chrono::steady_clock::now() - start;
+
+        Latencies all;
+        for (auto& l : latencies)
+        {
+            all.reads.insert(all.reads.end(), l.reads.begin(), l.reads.end());
+            all.writes.insert(
+                all.writes.end(), l.writes.begin(), l.writes.end());
+            all.rotations.insert(
+                all.rotations.end(), l.rotations.begin(), l.rotations.end());
+            all.hits += l.hits;
+        }
+
+        Json::Value ret(Json::objectValue);
+        ret["threads"] = threads;
+        ret["seconds"] = seconds.count();
+        ret["ops_per_second"] = ops_ / seconds.count();
+        ret["objects_written_per_second"] =
+            all.writes.size() * batch_ / seconds.count();
+        ret["read"] = summarize(all.reads);
+        ret["read"]["hits"] = static_cast<Json::UInt>(all.hits);
+        ret["write"] = summarize(all.writes, batch_);
+        if (rotateEvery_ != 0)
+            ret["rotate"] = summarize(all.rotations);
+        return ret;
+    }
+
+    Json::Value
+    getJson() const
+    {
+        Json::Value ret = workload_.getJson();
+        ret["objects"] = static_cast<Json::UInt>(objects_);
+        return ret;
+    }
+};
+
+}  // namespace
+}  // namespace NodeStore
+}  // namespace ripple
+
+int
+main(int argc, char** argv)
+{
+    using namespace ripple;
+
+    std::vector<std::string> const args(argv + 1, argv + argc);
+    for (auto const& arg : args)
+    {
+        if (arg.find('=') == std::string::npos)
+        {
+            std::cerr << NodeStore::usage;
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    Section params;
+    params.append(args);
+    if (get(params, "type").empty())
+        params.set("type", "nudb");
+
+    try
+    {
+        std::vector<int> threads;
+        {
+            std::vector<std::string> v;
+            boost::split(
+                v,
+                get(params, "threads", "1,2,4,8"),
+                boost::algorithm::is_any_of(","));
+            for (auto const& s : v)
+            {
+                if (!s.empty())
+                    threads.push_back(std::max(std::stoi(s), 1));
+            }
+        }
+
+        NodeStore::Bench bench(params);
+
+        Json::Value result(Json::objectValue);
+        result["config"] = Json::objectValue;
+        for (auto const& [key, value] : params)
+            result["config"][key] = value;
+        result["workload"] = bench.getJson();
+        result["runs"] = Json::arrayValue;
+        for (auto const t : threads)
+            result["runs"].append(bench.run(t));
+
+        std::cout << Json::pretty(result) << std::endl;
+        return 0;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "xrpl.bench.nodestore: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -47,6 +47,8 @@
 #include <xrpl/protocol/Serializer.h>
 #include <xrpl/protocol/detail/STVar.h>
 
+#include <boost/container/small_vector.hpp>
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -180,43 +182,59 @@ STObject::applyTemplate(SOTemplate const& type)
     };
 
     mType = &type;
-    decltype(v_) v;
-    v.reserve(type.size());
-    for (auto const& e : type)
+
+    // Find where each field of the template is through the template's
+    // index, rather than by searching for it. If a field appears more than
+    // once, the first is used, and the others are left over.
+    boost::container::small_vector<int, 64> positions(type.size(), -1);
+    boost::container::small_vector<SField const*, 8> leftover;
+    for (std::size_t i = 0; i < v_.size(); ++i)
     {
-        auto const iter =
-            std::find_if(v_.begin(), v_.end(), [&](detail::STVar const& b) {
-                return b.get().getFName() == e.sField();
-            });
-        if (iter != v_.end())
+        auto const& name = v_[i]->getFName();
+        auto const index = type.getIndex(name);
+        if (index != -1 && positions[index] == -1)
+            positions[index] = static_cast<int>(i);
+        else
+            leftover.push_back(&name);
+    }
+
+    for (std::size_t index = 0; index < type.size(); ++index)
+    {
+        auto const& e = *(type.begin() + index);
+        if (auto const i = positions[index]; i != -1)
         {
-            if ((e.style() == soeDEFAULT) && iter->get().isDefault())
+            if ((e.style() == soeDEFAULT) && v_[i].get().isDefault())
             {
                 throwFieldErr(
                     e.sField().fieldName,
                     "may not be explicitly set to default.");
             }
-            v.emplace_back(std::move(*iter));
-            v_.erase(iter);
         }
-        else
+        else if (e.style() == soeREQUIRED)
         {
-            if (e.style() == soeREQUIRED)
-            {
-                throwFieldErr(e.sField().fieldName, "is required but missing.");
-            }
-            v.emplace_back(detail::nonPresentObject, e.sField());
+            throwFieldErr(e.sField().fieldName, "is required but missing.");
         }
     }
-    for (auto const& e : v_)
+    for (auto const name : leftover)
     {
         // Anything left over in the object must be discardable
-        if (!e->getFName().isDiscardable())
+        if (!name->isDiscardable())
         {
-            throwFieldErr(
-                e->getFName().getName(), "found in disallowed location.");
+            throwFieldErr(name->getName(), "found in disallowed location.");
         }
     }
+
+    // Nothing is moved until the object is known to match
+    decltype(v_) v;
+    v.reserve(type.size());
+    for (std::size_t index = 0; index < type.size(); ++index)
+    {
+        if (auto const i = positions[index]; i != -1)
+            v.emplace_back(std::move(v_[i]));
+        else
+            v.emplace_back(
+                detail::nonPresentObject, (type.begin() + index)->sField());
+    }
     // Swap the template matching data in for the old data,
     // freeing any leftover junk
     v_.swap(v);
@@ -409,22 +427,6 @@ STObject::getSigningHash(HashPrefix prefix) const
     return s.getSHA512Half();
 }
 
-int
-STObject::getFieldIndex(SField const& field) const
-{
-    if (mType != nullptr)
-        return mType->getIndex(field);
-
-    int i = 0;
-    for (auto const& elem : v_)
-    {
-        if (elem->getFName() == field)
-            return i;
-        ++i;
-    }
-    return -1;
-}
-
 STBase const&
 STObject::peekAtField(SField const& field) const
 {
@@ -453,17 +455,6 @@ STObject::getFieldSType(int index) const
     return v_[index]->getFName();
 }
 
-STBase const*
-STObject::peekAtPField(SField const& field) const
-{
-    int index = getFieldIndex(field);
-
-    if (index == -1)
-        return nullptr;
-
-    return peekAtPIndex(index);
-}
-
 STBase*
 STObject::getPField(SField const& field, bool createOkay)
 {
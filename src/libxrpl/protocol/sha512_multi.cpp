@@ -0,0 +1,507 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpl/beast/utility/instrumentation.h>
+#include <xrpl/protocol/digest.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include <array>
+#include <cstring>
+#include <limits>
+
+// Multi-buffer SHA-512 hashes several independent messages at once, one
+// message per 64-bit lane of a vector register. The kernels are compiled
+// for their instruction set with function attributes, so the rest of the
+// library does not need to be built with -mavx2 or -mavx512f, and the
+// kernel is picked at runtime from what the processor supports.
+#if (defined(__x86_64__) || defined(_M_X64)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define RIPPLE_SHA512_MULTIBUFFER 1
+#include <immintrin.h>
+#define RIPPLE_TARGET_AVX2 __attribute__((target("avx2")))
+#define RIPPLE_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define RIPPLE_SHA512_MULTIBUFFER 0
+#endif
+
+namespace ripple {
+namespace detail {
+
+namespace {
+
+#if RIPPLE_SHA512_MULTIBUFFER
+
+constexpr std::size_t sha512BlockBytes = 128;
+
+constexpr std::array<std::uint64_t, 80> sha512K = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+constexpr std::array<std::uint64_t, 8> sha512IV = {
+    0x6a09e667f3bcc908,
+    0xbb67ae8584caa73b,
+    0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1,
+    0x510e527fade682d1,
+    0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b,
+    0x5be0cd19137e2179};
+
+// Feeds one message, padded as SHA-512 requires, through a lane one block at
+// a time. Whole blocks are read in place; only the final one or two blocks,
+// which carry the padding and the message length, are copied.
+class LaneCursor
+{
+private:
+    std::uint8_t const* data_ = nullptr;
+    std::size_t fullBlocks_ = 0;
+    std::size_t blocks_ = 0;
+    std::size_t next_ = 0;
+    alignas(64) std::array<std::uint8_t, 2 * sha512BlockBytes> tail_;
+
+public:
+    void
+    reset(Slice message)
+    {
+        auto const size = message.size();
+        auto const rem = size % sha512BlockBytes;
+
+        data_ = message.data();
+        fullBlocks_ = size / sha512BlockBytes;
+        next_ = 0;
+
+        // The padding is a single 0x80 byte, zeros, and the message length
+        // in bits as a 128-bit big-endian number.
+        auto const tailBlocks = (rem + 1 + 16 <= sha512BlockBytes) ? 1 : 2;
+        auto const tailBytes = tailBlocks * sha512BlockBytes;
+        blocks_ = fullBlocks_ + tailBlocks;
+
+        tail_.fill(0);
+        if (rem != 0)
+            std::memcpy(
+                tail_.data(), data_ + fullBlocks_ * sha512BlockBytes, rem);
+        tail_[rem] = 0x80;
+
+        std::uint64_t const bits = static_cast<std::uint64_t>(size) << 3;
+        std::uint64_t const highBits = static_cast<std::uint64_t>(size) >> 61;
+        boost::endian::store_big_u64(tail_.data() + tailBytes - 16, highBits);
+        boost::endian::store_big_u64(tail_.data() + tailBytes - 8, bits);
+    }
+
+    bool
+    done() const
+    {
+        return next_ == blocks_;
+    }
+
+    std::uint8_t const*
+    nextBlock()
+    {
+        XRPL_ASSERT(
+            next_ < blocks_,
+            "ripple::detail::LaneCursor::nextBlock : blocks remaining");
+        auto const i = next_++;
+        if (i < fullBlocks_)
+            return data_ + i * sha512BlockBytes;
+        return tail_.data() + (i - fullBlocks_) * sha512BlockBytes;
+    }
+};
+
+// Lane state, one row per SHA-512 working variable
+template <std::size_t Lanes>
+using LaneState = std::array<std::array<std::uint64_t, Lanes>, 8>;
+
+template <std::size_t Lanes>
+using LaneBlocks = std::array<std::uint8_t const*, Lanes>;
+
+// Keeps every lane busy: whenever the message in a lane is finished, its
+// digest is written out and the next message is loaded into that lane.
+// Lanes left without work once the messages run out hash a dummy block
+// whose result is discarded.
+template <std::size_t Lanes, class Compress>
+void
+hashLanes(
+    std::span<Slice const> messages,
+    std::span<uint256> digests,
+    Compress&& compress)
+{
+    static constexpr auto idle = std::numeric_limits<std::size_t>::max();
+    alignas(64) static constexpr std::array<std::uint8_t, sha512BlockBytes>
+        dummy{};
+
+    alignas(64) LaneState<Lanes> state;
+    std::array<LaneCursor, Lanes> cursors;
+    std::array<std::size_t, Lanes> owner;
+    LaneBlocks<Lanes> blocks;
+
+    std::size_t next = 0;
+    std::size_t active = 0;
+
+    auto const load = [&](std::size_t lane) {
+        if (next == messages.size())
+        {
+            owner[lane] = idle;
+            return;
+        }
+
+        cursors[lane].reset(messages[next]);
+        owner[lane] = next++;
+        for (std::size_t w = 0; w < 8; ++w)
+            state[w][lane] = sha512IV[w];
+        ++active;
+    };
+
+    for (std::size_t lane = 0; lane < Lanes; ++lane)
+        load(lane);
+
+    while (active != 0)
+    {
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            blocks[lane] = (owner[lane] == idle) ? dummy.data()
+                                                 : cursors[lane].nextBlock();
+        }
+
+        compress(state, blocks);
+
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+            if (owner[lane] == idle || !cursors[lane].done())
+                continue;
+
+            // SHA512-Half is the first four words of the digest
+            std::array<std::uint8_t, 32> digest;
+            for (std::size_t w = 0; w < 4; ++w)
+                boost::endian::store_big_u64(
+                    digest.data() + 8 * w, state[w][lane]);
+            digests[owner[lane]] = uint256::fromVoid(digest.data());
+
+            --active;
+            load(lane);
+        }
+    }
+}
+
+inline std::uint64_t
+loadBig64(std::uint8_t const* p)
+{
+    return boost::endian::load_big_u64(p);
+}
+
+//------------------------------------------------------------------------------
+
+template <int N>
+RIPPLE_TARGET_AVX2 inline __m256i
+rotr256(__m256i x)
+{
+    return _mm256_or_si256(
+        _mm256_srli_epi64(x, N), _mm256_slli_epi64(x, 64 - N));
+}
+
+RIPPLE_TARGET_AVX2 inline __m256i
+xor256(__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+RIPPLE_TARGET_AVX2 void
+compressAVX2(LaneState<4>& state, LaneBlocks<4> const& blocks)
+{
+    __m256i s[8];
+    for (int i = 0; i < 8; ++i)
+        s[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(&state[i]));
+
+    __m256i w[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        w[i] = _mm256_set_epi64x(
+            loadBig64(blocks[3] + 8 * i),
+            loadBig64(blocks[2] + 8 * i),
+            loadBig64(blocks[1] + 8 * i),
+            loadBig64(blocks[0] + 8 * i));
+    }
+
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m256i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int t = 0; t < 80; ++t)
+    {
+        if (t >= 16)
+        {
+            auto const w15 = w[(t - 15) & 15];
+            auto const w2 = w[(t - 2) & 15];
+            auto const s0 = xor256(
+                rotr256<1>(w15), rotr256<8>(w15), _mm256_srli_epi64(w15, 7));
+            auto const s1 = xor256(
+                rotr256<19>(w2), rotr256<61>(w2), _mm256_srli_epi64(w2, 6));
+            w[t & 15] = _mm256_add_epi64(
+                _mm256_add_epi64(w[t & 15], s0),
+                _mm256_add_epi64(w[(t - 7) & 15], s1));
+        }
+
+        auto const S1 = xor256(rotr256<14>(e), rotr256<18>(e), rotr256<41>(e));
+        auto const ch =
+            _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+        auto const t1 = _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_add_epi64(h, S1), ch),
+            _mm256_add_epi64(
+                _mm256_set1_epi64x(static_cast<long long>(sha512K[t])),
+                w[t & 15]));
+
+        auto const S0 = xor256(rotr256<28>(a), rotr256<34>(a), rotr256<39>(a));
+        auto const maj = _mm256_or_si256(
+            _mm256_and_si256(a, b),
+            _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        auto const t2 = _mm256_add_epi64(S0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi64(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi64(t1, t2);
+    }
+
+    __m256i const r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; ++i)
+        _mm256_store_si256(
+            reinterpret_cast<__m256i*>(&state[i]),
+            _mm256_add_epi64(s[i], r[i]));
+}
+
+//------------------------------------------------------------------------------
+
+RIPPLE_TARGET_AVX512 inline __m512i
+xor512(__m512i a, __m512i b, __m512i c)
+{
+    return _mm512_ternarylogic_epi64(a, b, c, 0x96);
+}
+
+RIPPLE_TARGET_AVX512 void
+compressAVX512(LaneState<8>& state, LaneBlocks<8> const& blocks)
+{
+    __m512i s[8];
+    for (int i = 0; i < 8; ++i)
+        s[i] = _mm512_load_si512(&state[i]);
+
+    __m512i w[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        w[i] = _mm512_set_epi64(
+            loadBig64(blocks[7] + 8 * i),
+            loadBig64(blocks[6] + 8 * i),
+            loadBig64(blocks[5] + 8 * i),
+            loadBig64(blocks[4] + 8 * i),
+            loadBig64(blocks[3] + 8 * i),
+            loadBig64(blocks[2] + 8 * i),
+            loadBig64(blocks[1] + 8 * i),
+            loadBig64(blocks[0] + 8 * i));
+    }
+
+    __m512i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m512i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int t = 0; t < 80; ++t)
+    {
+        if (t >= 16)
+        {
+            auto const w15 = w[(t - 15) & 15];
+            auto const w2 = w[(t - 2) & 15];
+            auto const s0 = xor512(
+                _mm512_ror_epi64(w15, 1),
+                _mm512_ror_epi64(w15, 8),
+                _mm512_srli_epi64(w15, 7));
+            auto const s1 = xor512(
+                _mm512_ror_epi64(w2, 19),
+                _mm512_ror_epi64(w2, 61),
+                _mm512_srli_epi64(w2, 6));
+            w[t & 15] = _mm512_add_epi64(
+                _mm512_add_epi64(w[t & 15], s0),
+                _mm512_add_epi64(w[(t - 7) & 15], s1));
+        }
+
+        auto const S1 = xor512(
+            _mm512_ror_epi64(e, 14),
+            _mm512_ror_epi64(e, 18),
+            _mm512_ror_epi64(e, 41));
+        // e ? f : g
+        auto const ch = _mm512_ternarylogic_epi64(e, f, g, 0xca);
+        auto const t1 = _mm512_add_epi64(
+            _mm512_add_epi64(_mm512_add_epi64(h, S1), ch),
+            _mm512_add_epi64(
+                _mm512_set1_epi64(static_cast<long long>(sha512K[t])),
+                w[t & 15]));
+
+        auto const S0 = xor512(
+            _mm512_ror_epi64(a, 28),
+            _mm512_ror_epi64(a, 34),
+            _mm512_ror_epi64(a, 39));
+        // majority of a, b and c
+        auto const maj = _mm512_ternarylogic_epi64(a, b, c, 0xe8);
+        auto const t2 = _mm512_add_epi64(S0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm512_add_epi64(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm512_add_epi64(t1, t2);
+    }
+
+    __m512i const r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; ++i)
+        _mm512_store_si512(&state[i], _mm512_add_epi64(s[i], r[i]));
+}
+
+#endif
+
+void
+hashOpenSSL(std::span<Slice const> messages, std::span<uint256> digests)
+{
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        digests[i] = sha512Half(messages[i]);
+}
+
+}  // namespace
+
+bool
+sha512EngineSupported(sha512_engine engine)
+{
+#if RIPPLE_SHA512_MULTIBUFFER
+    static bool const avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    static bool const avx512 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") != 0;
+    }();
+#else
+    static bool const avx2 = false;
+    static bool const avx512 = false;
+#endif
+
+    switch (engine)
+    {
+        case sha512_engine::openssl:
+            return true;
+        case sha512_engine::avx2:
+            return avx2;
+        case sha512_engine::avx512:
+            return avx512;
+    }
+    return false;
+}
+
+char const*
+to_string(sha512_engine engine)
+{
+    switch (engine)
+    {
+        case sha512_engine::openssl:
+            return "openssl";
+        case sha512_engine::avx2:
+            return "avx2";
+        case sha512_engine::avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+void
+sha512HalfBatch(
+    sha512_engine engine,
+    std::span<Slice const> messages,
+    std::span<uint256> digests)
+{
+    XRPL_ASSERT(
+        messages.size() == digests.size(),
+        "ripple::detail::sha512HalfBatch : digest per message");
+    XRPL_ASSERT(
+        sha512EngineSupported(engine),
+        "ripple::detail::sha512HalfBatch : engine is supported");
+
+    switch (engine)
+    {
+#if RIPPLE_SHA512_MULTIBUFFER
+        case sha512_engine::avx2:
+            hashLanes<4>(messages, digests, compressAVX2);
+            return;
+        case sha512_engine::avx512:
+            hashLanes<8>(messages, digests, compressAVX512);
+            return;
+#endif
+        default:
+            hashOpenSSL(messages, digests);
+            return;
+    }
+}
+
+}  // namespace detail
+
+void
+sha512HalfBatch(std::span<Slice const> messages, std::span<uint256> digests)
+{
+    using detail::sha512_engine;
+    using detail::sha512EngineSupported;
+
+    // A wide engine only pays off when it has enough messages to fill most
+    // of its lanes; a single message is fastest through OpenSSL.
+    auto const engine = [n = messages.size()] {
+        if (n >= 4 && sha512EngineSupported(sha512_engine::avx512))
+            return sha512_engine::avx512;
+        if (n >= 2 && sha512EngineSupported(sha512_engine::avx2))
+            return sha512_engine::avx2;
+        return sha512_engine::openssl;
+    }();
+
+    detail::sha512HalfBatch(engine, messages, digests);
+}
+
+}  // namespace ripple
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <test/jtx.h>
+#include <test/jtx/AMM.h>
 #include <test/jtx/PathSet.h>
 
 #include <xrpld/app/paths/Flow.h>
@@ -29,6 +30,10 @@
 #include <xrpl/basics/contract.h>
 #include <xrpl/protocol/Feature.h>
 
+#include <chrono>
+#include <functional>
+#include <iomanip>
+
 namespace ripple {
 namespace test {
 
@@ -49,6 +54,25 @@ getNoRippleFlag(
     return false;  // silence warning
 }
 
+// Turns flow's caching across iterations on or off for a scope
+class FlowCache
+{
+public:
+    explicit FlowCache(bool enabled)
+    {
+        setFlowCacheEnabled(enabled);
+    }
+
+    ~FlowCache()
+    {
+        setFlowCacheEnabled(true);
+    }
+
+    FlowCache(FlowCache const&) = delete;
+    FlowCache&
+    operator=(FlowCache const&) = delete;
+};
+
 struct Flow_test : public beast::unit_test::suite
 {
     void
@@ -1363,8 +1387,420 @@ struct Flow_manual_test : public Flow_test
     }
 };
 
+// Measures how long payments and offers that consume deep order books take
+// to apply: an offer crossing one book, and a payment with strands through
+// several.
+struct FlowDeepBooks_manual_test : public beast::unit_test::suite
+{
+    template <class F>
+    double
+    timed(F&& f)
+    {
+        using clock_type = std::chrono::steady_clock;
+        auto const start = clock_type::now();
+        f();
+        return std::chrono::duration<double, std::milli>(
+                   clock_type::now() - start)
+            .count();
+    }
+
+    void
+    testCrossOneBook(bool cache)
+    {
+        testcase(
+            std::string("offer crossing one deep book") +
+            (cache ? "" : ", no flow cache"));
+        FlowCache const setting(cache);
+
+        using namespace jtx;
+        std::size_t const makerCount = 10;
+        std::size_t const offersPerMaker = 50;
+        std::size_t const offerCount = makerCount * offersPerMaker;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        Account const taker("taker");
+        env.fund(XRP(1000000), gw, taker);
+        env(rate(gw, 1.002));
+        env.trust(USD(1000000), taker);
+
+        for (std::size_t i = 0; i < makerCount; ++i)
+        {
+            Account const maker("maker" + std::to_string(i));
+            env.fund(XRP(10000), maker);
+            env.trust(USD(1000000), maker);
+            env(pay(gw, maker, USD(10000)));
+            for (std::size_t j = 0; j < offersPerMaker; ++j)
+            {
+                // A different quality for each offer
+                auto const n = i * offersPerMaker + j;
+                env(offer(maker, drops(100000000 + n * 1000), USD(100)));
+            }
+        }
+        env.close();
+
+        auto const elapsed = timed([&] {
+            env(offer(taker, USD(100 * offerCount), XRP(200 * offerCount)));
+        });
+        log << std::fixed << std::setprecision(1) << elapsed << " ms to cross "
+            << offerCount << " offers" << std::endl;
+        BEAST_EXPECT(env.balance(taker, USD) == USD(100 * offerCount));
+    }
+
+    void
+    testPayThroughBooks(bool cache)
+    {
+        testcase(
+            std::string("payment through several deep books") +
+            (cache ? "" : ", no flow cache"));
+        FlowCache const setting(cache);
+
+        using namespace jtx;
+        std::size_t const offersPerBook = 50;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        std::vector<IOU> const middles{gw["GBP"], gw["JPY"], gw["CAD"]};
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const mm("marketMaker");
+        env.fund(XRP(1000000), gw, alice, bob, mm);
+        env.trust(USD(1000000), alice, mm);
+        env.trust(EUR(1000000), bob, mm);
+        env(pay(gw, alice, USD(1000000)));
+        env(pay(gw, mm, EUR(1000000)));
+        for (auto const& iou : middles)
+        {
+            env.trust(iou(1000000), mm);
+            env(pay(gw, mm, iou(1000000)));
+        }
+
+        // A different quality for each offer, in books from USD to each
+        // of the middle currencies and from each to EUR
+        for (std::size_t i = 0; i < offersPerBook; ++i)
+        {
+            auto const worse = 100 + 0.01 * i;
+            auto const smaller = 100 - 0.01 * i;
+            env(offer(mm, USD(worse), XRP(100)));
+            env(offer(mm, XRP(100), EUR(smaller)));
+            for (auto const& iou : middles)
+            {
+                env(offer(mm, USD(worse), iou(100)));
+                env(offer(mm, iou(100), EUR(smaller)));
+            }
+        }
+        env.close();
+
+        auto const elapsed = timed([&] {
+            env(pay(alice, bob, EUR(100 * offersPerBook * 4)),
+                sendmax(USD(1000000)),
+                path(~XRP, ~EUR),
+                path(~middles[0], ~EUR),
+                path(~middles[1], ~EUR),
+                path(~middles[2], ~EUR),
+                txflags(tfPartialPayment | tfNoRippleDirect));
+        });
+        log << std::fixed << std::setprecision(1) << elapsed
+            << " ms to pay through " << offersPerBook * 8 << " offers"
+            << std::endl;
+        BEAST_EXPECT(env.balance(bob, EUR) > EUR(0));
+    }
+
+    void
+    run() override
+    {
+        for (bool const cache : {false, true})
+        {
+            testCrossOneBook(cache);
+            testPayThroughBooks(cache);
+        }
+    }
+};
+
+// Runs payments and offers with flow's caching across iterations on and
+// off, and requires that every transaction's metadata, and so every
+// ledger, comes out the same.
+struct FlowCache_test : public beast::unit_test::suite
+{
+    // Closes ledgers, keeping what ended up in each
+    using Close = std::function<void()>;
+    using Scenario = std::function<void(jtx::Env&, Close const&)>;
+
+    std::vector<std::string>
+    outcomes(Scenario const& scenario, bool cache)
+    {
+        FlowCache const setting(cache);
+
+        std::vector<std::string> result;
+        jtx::Env env(*this);
+        scenario(env, [&] {
+            env.close();
+            auto const ledger = env.closed();
+            for (auto const& [tx, meta] : ledger->txs)
+                result.push_back(
+                    meta->getJson(JsonOptions::none).toStyledString());
+            result.push_back(to_string(ledger->info().hash));
+        });
+        return result;
+    }
+
+    void
+    expectSame(Scenario const& scenario)
+    {
+        auto const uncached = outcomes(scenario, false);
+        auto const cached = outcomes(scenario, true);
+        BEAST_EXPECT(!cached.empty());
+        BEAST_EXPECT(cached.size() == uncached.size());
+        for (std::size_t i = 0; i < std::min(cached.size(), uncached.size());
+             ++i)
+        {
+            if (!BEAST_EXPECTS(cached[i] == uncached[i], cached[i]))
+                break;
+        }
+    }
+
+    void
+    testMultiPath()
+    {
+        testcase("multi-path payments");
+
+        using namespace jtx;
+        expectSame([](Env& env, Close const& close) {
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            auto const EUR = gw["EUR"];
+            std::vector<IOU> const middles{gw["GBP"], gw["JPY"], gw["CAD"]};
+            Account const alice("alice");
+            Account const bob("bob");
+            Account const mm("marketMaker");
+            env.fund(XRP(1000000), gw, alice, bob, mm);
+            env(rate(gw, 1.002));
+            env.trust(USD(1000000), alice, mm);
+            env.trust(EUR(1000000), bob, mm);
+            env(pay(gw, alice, USD(100000)));
+            env(pay(gw, mm, EUR(100000)));
+            for (auto const& iou : middles)
+            {
+                env.trust(iou(1000000), mm);
+                env(pay(gw, mm, iou(100000)));
+            }
+            close();
+
+            // The books through each middle currency get worse at a
+            // different pace, so the best strand changes as they are used
+            for (int i = 0; i < 10; ++i)
+            {
+                env(offer(mm, USD(100 + i), XRP(100)));
+                env(offer(mm, XRP(100), EUR(100 - i)));
+                for (std::size_t k = 0; k < middles.size(); ++k)
+                {
+                    env(offer(mm, USD(100 + i * (k + 2)), middles[k](100)));
+                    env(offer(mm, middles[k](100), EUR(100 - i)));
+                }
+            }
+            close();
+
+            auto const p0 = path(~XRP, ~EUR);
+            auto const p1 = path(~middles[0], ~EUR);
+            auto const p2 = path(~middles[1], ~EUR);
+            auto const p3 = path(~middles[2], ~EUR);
+
+            env(pay(alice, bob, EUR(1500)),
+                sendmax(USD(10000)),
+                p0,
+                p1,
+                p2,
+                p3,
+                txflags(tfPartialPayment | tfNoRippleDirect));
+            close();
+
+            // A limit quality stops the payment part way through the books
+            env(pay(alice, bob, EUR(1500)),
+                sendmax(USD(1800)),
+                p0,
+                p1,
+                p2,
+                p3,
+                txflags(
+                    tfPartialPayment | tfLimitQuality | tfNoRippleDirect),
+                ter(std::ignore));
+            close();
+
+            // Rippling through two gateways, which charge different
+            // transfer fees
+            auto const gw1 = Account("gateway1");
+            auto const gw2 = Account("gateway2");
+            Account const carol("carol");
+            env.fund(XRP(10000), gw1, gw2, carol);
+            env(rate(gw1, 1.1));
+            env(rate(gw2, 1.005));
+            for (auto const& gwN : {gw1, gw2})
+            {
+                env.trust(gwN["USD"](10000), alice, carol);
+                env(pay(gwN, alice, gwN["USD"](1000)));
+            }
+            close();
+
+            env(pay(alice, carol, carol["USD"](1500)),
+                sendmax(alice["USD"](2000)),
+                path(gw1),
+                path(gw2),
+                txflags(tfPartialPayment | tfNoRippleDirect));
+            close();
+        });
+    }
+
+    void
+    testSelfCross()
+    {
+        testcase("self-crossing offers");
+
+        using namespace jtx;
+        expectSame([](Env& env, Close const& close) {
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            auto const EUR = gw["EUR"];
+            Account const alice("alice");
+            Account const bob("bob");
+            env.fund(XRP(100000), gw, alice, bob);
+            env.trust(USD(10000), alice, bob);
+            env.trust(EUR(10000), alice, bob);
+            env(pay(gw, alice, USD(1000)));
+            env(pay(gw, alice, EUR(1000)));
+            env(pay(gw, bob, USD(1000)));
+            env(pay(gw, bob, EUR(1000)));
+            close();
+
+            // Alice's offer crosses her own, directly
+            env(offer(alice, USD(100), XRP(100)));
+            env(offer(bob, USD(50), XRP(55)));
+            close();
+            env(offer(alice, XRP(150), USD(150)));
+            close();
+
+            // Alice's offers in both books that bridge through XRP, and
+            // bob's in the direct book, are crossed by one of hers
+            for (int i = 0; i < 5; ++i)
+            {
+                env(offer(alice, EUR(100 + i), XRP(100)));
+                env(offer(alice, XRP(100), USD(100 - i)));
+                env(offer(bob, EUR(102 + i), USD(100)));
+            }
+            close();
+            env(offer(alice, USD(600), EUR(700)));
+            close();
+        });
+    }
+
+    void
+    testOfferRemoval()
+    {
+        testcase("offer removal");
+
+        using namespace jtx;
+        expectSame([](Env& env, Close const& close) {
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            Account const alice("alice");
+            Account const bob("bob");
+            Account const carol("carol");
+            Account const taker("taker");
+            env.fund(XRP(100000), gw, alice, bob, carol, taker);
+            env(rate(gw, 1.01));
+            env.trust(USD(10000), alice, bob, carol, taker);
+            env(pay(gw, alice, USD(1000)));
+            env(pay(gw, bob, USD(1000)));
+            env(pay(gw, carol, USD(1000)));
+            close();
+
+            // Alice's offers are unfunded once she pays her USD away,
+            // bob's expire, and carol's are funded
+            auto const closeTime = env.current()->info().parentCloseTime;
+            auto const expiration = closeTime.time_since_epoch().count() + 5;
+            for (int i = 0; i < 5; ++i)
+            {
+                env(offer(alice, XRP(100), USD(100 - i)));
+                env(offer(bob, XRP(100), USD(99 - i)),
+                    json(sfExpiration.fieldName, expiration));
+                env(offer(carol, XRP(100), USD(98 - i)));
+            }
+            env(pay(alice, gw, USD(1000)));
+            close();
+            close();
+
+            // A payment which fails leaves the offers it found unfunded
+            // to be removed
+            env(pay(taker, carol, USD(10000)),
+                sendmax(XRP(100000)),
+                path(~USD),
+                ter(tecPATH_PARTIAL));
+            close();
+
+            env(offer(taker, USD(300), XRP(400)));
+            close();
+        });
+    }
+
+    void
+    testAMM()
+    {
+        testcase("payments and offers through an AMM");
+
+        using namespace jtx;
+        expectSame([](Env& env, Close const& close) {
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            auto const EUR = gw["EUR"];
+            Account const alice("alice");
+            Account const bob("bob");
+            Account const lp("liquidityProvider");
+            env.fund(XRP(100000), gw, alice, bob, lp);
+            env.trust(USD(100000), alice, bob, lp);
+            env.trust(EUR(100000), alice, bob, lp);
+            env(pay(gw, alice, USD(10000)));
+            env(pay(gw, lp, USD(10000)));
+            env(pay(gw, lp, EUR(20000)));
+            close();
+
+            AMM const amm(env, lp, XRP(10000), EUR(10000));
+            for (int i = 0; i < 5; ++i)
+            {
+                env(offer(lp, USD(100 + i), XRP(100)));
+                env(offer(lp, USD(101 + i), EUR(100)));
+                env(offer(lp, XRP(100), EUR(99 - i)));
+            }
+            close();
+
+            // One strand goes through the AMM's book, and one does not
+            env(pay(alice, bob, EUR(700)),
+                sendmax(USD(1000)),
+                path(~EUR),
+                path(~XRP, ~EUR),
+                txflags(tfPartialPayment | tfNoRippleDirect));
+            close();
+
+            env(offer(alice, EUR(300), USD(320)));
+            close();
+        });
+    }
+
+    void
+    run() override
+    {
+        testMultiPath();
+        testSelfCross();
+        testOfferRemoval();
+        testAMM();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(Flow, app, ripple, 2);
+BEAST_DEFINE_TESTSUITE_PRIO(FlowCache, app, ripple, 2);
 BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(Flow_manual, app, ripple, 4);
+BEAST_DEFINE_TESTSUITE_MANUAL(FlowDeepBooks_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -22,6 +22,13 @@
 
 #include <xrpl/basics/chrono.h>
 #include <xrpl/beast/unit_test.h>
+#include <xrpl/protocol/digest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -259,6 +266,51 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testShards()
+    {
+        testcase("Shards");
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(getSetup(2s, 1s), stopwatch);
+
+        // Hashes which fall in every shard
+        std::vector<uint256> keys;
+        for (std::uint32_t i = 0; i < 256; ++i)
+            keys.push_back(sha512Half(i));
+
+        for (auto const& key : keys)
+            BEAST_EXPECT(router.setFlags(key, 1));
+
+        // An insertion in one shard expires the entries of all of them
+        ++stopwatch;
+        ++stopwatch;
+        router.addSuppression(uint256(1));
+        BEAST_EXPECT(std::all_of(keys.begin(), keys.end(), [&](auto const& k) {
+            return router.getFlags(k) == 0;
+        }));
+
+        // Peers racing to add the same hashes see each created once
+        std::atomic<int> created{0};
+        std::vector<std::thread> threads;
+        for (HashRouter::PeerShortID peer = 1; peer <= 8; ++peer)
+        {
+            threads.emplace_back([&, peer]() {
+                for (std::uint32_t i = 0; i < 1000; ++i)
+                {
+                    if (router.addSuppressionPeer(sha512Half(i, 1), peer))
+                        ++created;
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        BEAST_EXPECT(created == 1000);
+
+        auto const peers = router.shouldRelay(sha512Half(std::uint32_t{7}, 1));
+        BEAST_EXPECT(peers && peers->size() == 8);
+    }
+
     void
     testSetup()
     {
@@ -374,11 +426,90 @@ public:
         testSetFlags();
         testRelay();
         testProcess();
+        testShards();
         testSetup();
     }
 };
 
+//------------------------------------------------------------------------------
+
+/*  Measures contention in the router.
+
+    Peers relay an overlapping set of messages, each of which is heard from
+    about a third of them. Every message heard is checked and flagged, and
+    relayed the first time, as PeerImp does with transactions. The peers
+    are split between the threads, which work through the messages in the
+    same order, so that they meet on the same hashes.
+*/
+class HashRouter_manual_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        using clock_type = std::chrono::steady_clock;
+
+        int const peers = 100;
+        std::uint32_t const messages = 20'000;
+
+        int const maxThreads = arg().empty()
+            ? std::max(4u, std::thread::hardware_concurrency())
+            : std::stoi(arg());
+
+        for (int n = 1; n <= maxThreads; n *= 2)
+        {
+            testcase(std::to_string(n) + " threads");
+
+            HashRouter router(HashRouter::Setup{}, stopwatch());
+            std::atomic<std::size_t> calls{0};
+
+            auto const start = clock_type::now();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < n; ++t)
+            {
+                threads.emplace_back([&, t]() {
+                    std::size_t count = 0;
+                    for (std::uint32_t m = 0; m < messages; ++m)
+                    {
+                        auto const key = sha512Half(m);
+                        for (int p = t; p < peers; p += n)
+                        {
+                            if ((m * 31 + p * 17) % 100 >= 33)
+                                continue;
+
+                            int flags;
+                            if (router.shouldProcess(key, p + 1, flags, 10s))
+                            {
+                                router.setFlags(key, SF_TRUSTED);
+                                router.shouldRelay(key);
+                                count += 3;
+                            }
+                            else
+                            {
+                                router.getFlags(key);
+                                count += 2;
+                            }
+                        }
+                    }
+                    calls += count;
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            auto const seconds =
+                std::chrono::duration<double>(clock_type::now() - start)
+                    .count();
+
+            log << std::fixed << std::setprecision(0) << calls / seconds
+                << " calls/s" << std::endl;
+            pass();
+        }
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouter_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <test/jtx/AMM.h>
+#include <test/jtx/PathSet.h>
+
+#include <xrpld/app/ledger/OpenLedger.h>
+#include <xrpld/app/ledger/OrderBookDB.h>
+#include <xrpld/app/tx/apply.h>
+#include <xrpld/core/JobQueue.h>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Close a ledger, and wait for it to be published
+    static void
+    close(jtx::Env& env)
+    {
+        env.close();
+        env.app().getJobQueue().rendezvous();
+    }
+
+    void
+    testOffers()
+    {
+        testcase("offers");
+
+        using namespace jtx;
+        Env env{*this};
+        auto& db = env.app().getOrderBookDB();
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(pay(gw, alice, USD(100)));
+        close(env);
+
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Offers at different qualities are in different directories
+        auto const first = env.seq(alice);
+        env(offer(alice, XRP(10), USD(10)));
+        auto const second = env.seq(alice);
+        env(offer(alice, XRP(20), USD(10)));
+        env(offer(alice, USD(10), XRP(10)));
+        close(env);
+
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        if (auto const books = db.getBooksByTakerPays(xrpIssue());
+            BEAST_EXPECT(books.size() == 1))
+            BEAST_EXPECT(books[0].out == USD.issue());
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // The book is there while any of its directories is
+        env(offer_cancel(alice, first));
+        close(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        env(offer_cancel(alice, second));
+        close(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(db.getBooksByTakerPays(xrpIssue()).empty());
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // And comes back with a new one
+        env(offer(alice, XRP(30), USD(10)));
+        close(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+    }
+
+    void
+    testAMM()
+    {
+        testcase("AMM");
+
+        using namespace jtx;
+        Env env{*this};
+        auto& db = env.app().getOrderBookDB();
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(pay(gw, alice, USD(100)));
+        close(env);
+
+        AMM amm(env, alice, XRP(100), USD(100));
+        close(env);
+
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        amm.withdrawAll(alice);
+        close(env);
+
+        BEAST_EXPECT(!amm.ammExists());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+    }
+
+    void
+    testOpenLedger()
+    {
+        testcase("open ledger");
+
+        using namespace jtx;
+        Env env{*this};
+        auto& db = env.app().getOrderBookDB();
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(pay(gw, alice, USD(100)));
+        close(env);
+
+        // The offer is applied to the open ledger, which is then thrown
+        // away, so no ledger ever holds it
+        auto const jt = env.jt(offer(alice, XRP(10), USD(10)));
+        env.app().openLedger().modify([&](OpenView& view, beast::Journal j) {
+            auto const result =
+                ripple::apply(env.app(), view, *jt.stx, tapNONE, j);
+            BEAST_EXPECT(result.applied);
+            return false;
+        });
+        BEAST_EXPECT(!isOffer(env, alice, XRP(10), USD(10)));
+
+        // The book is there until the ledger is published
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        close(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(db.getBooksByTakerPays(xrpIssue()).empty());
+
+        // An offer which does make it into a ledger keeps its book
+        env(offer(alice, XRP(10), USD(10)));
+        close(env);
+        close(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testOffers();
+        testAMM();
+        testOpenLedger();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <test/jtx/CheckMessageLogs.h>
+
+#include <xrpld/core/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class ParallelApply_test : public beast::unit_test::suite
+{
+    static std::unique_ptr<Config>
+    makeConfig(Config::LedgerApply mode)
+    {
+        return jtx::envconfig([mode](std::unique_ptr<Config> cfg) {
+            cfg->LEDGER_APPLY = mode;
+            cfg->FORCE_MULTI_THREAD = true;
+            cfg->section("transaction_queue")
+                .set("minimum_txn_in_ledger_standalone", "1000");
+            return cfg;
+        });
+    }
+
+    // Submit transactions, many of which change the same entries, and return
+    // the hashes of the ledgers closed
+    static std::vector<uint256>
+    runTransactions(jtx::Env& env)
+    {
+        using namespace jtx;
+
+        std::vector<uint256> hashes;
+        auto const close = [&env, &hashes]() {
+            env.close();
+            hashes.push_back(env.closed()->info().hash);
+        };
+
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (int i = 0; i < 24; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+
+        env.fund(XRP(100000), gw);
+        for (auto const& account : accounts)
+            env.fund(XRP(100000), account);
+        close();
+
+        for (auto const& account : accounts)
+            env.trust(USD(100000), account);
+        close();
+
+        for (auto const& account : accounts)
+            env(pay(gw, account, USD(10000)));
+        close();
+
+        for (int round = 0; round < 3; ++round)
+        {
+            for (std::size_t i = 0; i < accounts.size(); ++i)
+            {
+                auto const& account = accounts[i];
+
+                // To a neighbour, to the gateway, and offers which cross
+                env(pay(account, accounts[(i + 1) % accounts.size()], XRP(10)));
+                env(pay(account, gw, USD(1)));
+                if (i % 2 == 0)
+                    env(offer(account, XRP(100), USD(100 + i)));
+                else
+                    env(offer(account, USD(100), XRP(100 + i)));
+            }
+
+            // Accounts funded, and spending, in the same ledger. In canonical
+            // order the spending may come first, and be retried.
+            for (int i = 0; i < 4; ++i)
+            {
+                Account const fresh{
+                    "fresh" + std::to_string(round) + "." + std::to_string(i)};
+                env(pay(accounts[i], fresh, XRP(1000)));
+                env(pay(fresh, accounts[i + 4], XRP(100)));
+            }
+            close();
+        }
+
+        return hashes;
+    }
+
+    void
+    testSameLedgers()
+    {
+        testcase("same ledgers");
+
+        std::vector<uint256> expected;
+        {
+            jtx::Env env{*this, makeConfig(Config::LedgerApply::serial)};
+            expected = runTransactions(env);
+        }
+
+        jtx::Env env{*this, makeConfig(Config::LedgerApply::parallel)};
+        BEAST_EXPECT(runTransactions(env) == expected);
+    }
+
+    void
+    testVerify()
+    {
+        testcase("verify");
+
+        bool diverged = false;
+        {
+            jtx::Env env{
+                *this,
+                makeConfig(Config::LedgerApply::verify),
+                std::make_unique<CheckMessageLogs>(
+                    "Parallel transaction application diverged", &diverged)};
+            runTransactions(env);
+        }
+        BEAST_EXPECT(!diverged);
+    }
+
+public:
+    void
+    run() override
+    {
+        testSameLedgers();
+        testVerify();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ParallelApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
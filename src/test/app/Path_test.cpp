@@ -23,6 +23,7 @@
 #include <test/jtx/envconfig.h>
 #include <test/jtx/permissioned_dex.h>
 
+#include <xrpld/app/paths/PathRequest.h>
 #include <xrpld/core/JobQueue.h>
 #include <xrpld/rpc/RPCHandler.h>
 #include <xrpld/rpc/detail/RPCHelpers.h>
@@ -35,10 +36,14 @@
 #include <xrpl/protocol/jss.h>
 #include <xrpl/resource/Fees.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <iomanip>
 #include <mutex>
 #include <optional>
+#include <random>
 #include <string>
 #include <thread>
 
@@ -2086,6 +2091,60 @@ public:
         BEAST_EXPECT(same(st, stpath(gw, IPE(xrpIssue()))));
     }
 
+    void
+    shared_pathfinders()
+    {
+        testcase("shared pathfinders");
+        using namespace jtx;
+        Env env = pathTestEnv();
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.close();
+
+        auto const cache = std::make_shared<RippleLineCache>(
+            env.closed(), env.app().journal("RippleLineCache"));
+        std::atomic<int> built = 0;
+        auto build = [&]() {
+            ++built;
+            auto pathfinder = std::make_shared<Pathfinder>(
+                cache,
+                Account("alice").id(),
+                Account("bob").id(),
+                USD.currency,
+                std::nullopt,
+                USD(5),
+                std::nullopt,
+                std::nullopt,
+                env.app());
+            pathfinder->findPaths(2);
+            return pathfinder;
+        };
+
+        // Searches for the same paths, at once, are built once
+        SharedPathfinders shared;
+        uint256 const key{1};
+        std::vector<std::shared_ptr<Pathfinder>> found(4);
+        std::vector<std::thread> threads;
+        for (auto& pathfinder : found)
+            threads.emplace_back(
+                [&]() { pathfinder = shared.get(key, build, {}); });
+        for (auto& thread : threads)
+            thread.join();
+        BEAST_EXPECT(built == 1);
+        BEAST_EXPECT(shared.reused() == 3);
+        for (auto const& pathfinder : found)
+            BEAST_EXPECT(pathfinder && pathfinder == found.front());
+
+        // Other searches, and searches cut short, are not shared
+        BEAST_EXPECT(shared.get(uint256{2}, build, {}) != found.front());
+        BEAST_EXPECT(built == 2);
+        auto const cutShort = [] { return false; };
+        shared.get(uint256{3}, build, cutShort);
+        shared.get(uint256{3}, build, cutShort);
+        BEAST_EXPECT(built == 4);
+    }
+
     void
     run() override
     {
@@ -2130,10 +2189,114 @@ public:
 
         hybrid_offer_path();
         amm_domain_path();
+        shared_pathfinders();
+    }
+};
+
+// Measures how many path searches a second can be made on one ledger, with
+// a new RippleLineCache for each search and with one shared by them all, as
+// the path requests do. The searches are between accounts of a dense web of
+// trust lines.
+class Path_manual_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using clock_type = std::chrono::steady_clock;
+
+        std::size_t const accountCount = 40;
+        std::size_t const trustCount = 6;
+        std::size_t const searchCount = 200;
+        int const searchLevel = 4;
+
+        Env env(*this);
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < accountCount; ++i)
+        {
+            accounts.emplace_back("account" + std::to_string(i));
+            env.fund(XRP(100000), accounts.back());
+        }
+        env.close();
+        for (std::size_t j = 1; j < accountCount; ++j)
+        {
+            for (std::size_t i = j > trustCount ? j - trustCount : 0; i < j;
+                 ++i)
+                env(trust(accounts[j], accounts[i]["USD"](1000)));
+        }
+        env.close();
+
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<std::size_t> pick(0, accountCount - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> searches;
+        while (searches.size() < searchCount)
+        {
+            auto const src = pick(gen);
+            auto const dst = pick(gen);
+            if (src < dst)
+                searches.emplace_back(src, dst);
+        }
+
+        for (bool const shared : {false, true})
+        {
+            testcase(shared ? "shared cache" : "cache per search");
+            auto cache = std::make_shared<RippleLineCache>(
+                env.closed(), env.journal);
+            std::vector<double> latencies;
+            std::size_t pathCount = 0;
+
+            auto const start = clock_type::now();
+            for (auto const& [src, dst] : searches)
+            {
+                auto const searchStart = clock_type::now();
+                if (!shared)
+                    cache = std::make_shared<RippleLineCache>(
+                        env.closed(), env.journal);
+                Pathfinder pathfinder(
+                    cache,
+                    accounts[src].id(),
+                    accounts[dst].id(),
+                    accounts[dst]["USD"].currency,
+                    std::nullopt,
+                    accounts[dst]["USD"](5),
+                    std::nullopt,
+                    std::nullopt,
+                    env.app());
+                if (pathfinder.findPaths(searchLevel))
+                {
+                    pathfinder.computePathRanks(4);
+                    STPath fullLiquidityPath;
+                    pathCount += pathfinder
+                                     .getBestPaths(
+                                         4,
+                                         fullLiquidityPath,
+                                         {},
+                                         accounts[src].id())
+                                     .size();
+                }
+                latencies.push_back(std::chrono::duration<double, std::milli>(
+                                        clock_type::now() - searchStart)
+                                        .count());
+            }
+            auto const elapsed =
+                std::chrono::duration<double>(clock_type::now() - start)
+                    .count();
+
+            std::sort(latencies.begin(), latencies.end());
+            log << std::fixed << std::setprecision(1)
+                << searchCount / elapsed << " searches a second, "
+                << pathCount / elapsed << " paths a second, p50 "
+                << latencies[latencies.size() / 2] << " ms, p99 "
+                << latencies[latencies.size() * 99 / 100] << " ms"
+                << std::endl;
+            BEAST_EXPECT(pathCount > 0);
+        }
     }
 };
 
 BEAST_DEFINE_TESTSUITE(Path, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(Path_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
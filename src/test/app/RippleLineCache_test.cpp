@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+
+#include <xrpld/app/paths/RippleLineCache.h>
+
+namespace ripple {
+namespace test {
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    void
+    testReuse()
+    {
+        testcase("reuse");
+
+        using namespace jtx;
+        Env env{*this};
+        auto const j = env.app().journal("RippleLineCache");
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(trust(bob, USD(1000)));
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(100)));
+        env.close();
+
+        auto const outgoing = LineDirection::outgoing;
+        RippleLineCache first(env.closed(), j);
+        auto const aliceLines = first.getRippleLines(alice, outgoing);
+        auto const bobLines = first.getRippleLines(bob, outgoing);
+        BEAST_EXPECT(!first.getRippleLines(carol, outgoing));
+        if (!BEAST_EXPECT(aliceLines && bobLines))
+            return;
+
+        // Only alice's line, and carol's lack of one, are changed
+        env(pay(gw, alice, USD(10)));
+        env(trust(carol, USD(1000)));
+        env.close();
+
+        RippleLineCache second(env.closed(), first, j);
+        BEAST_EXPECT(second.getRippleLines(bob, outgoing) == bobLines);
+
+        auto const newAliceLines = second.getRippleLines(alice, outgoing);
+        if (BEAST_EXPECT(newAliceLines && newAliceLines != aliceLines) &&
+            BEAST_EXPECT(newAliceLines->size() == 1))
+            BEAST_EXPECT(
+                newAliceLines->front().getBalance() == USD(110).value());
+
+        auto const carolLines = second.getRippleLines(carol, outgoing);
+        BEAST_EXPECT(carolLines && carolLines->size() == 1);
+
+        // Nothing is taken from a cache for a ledger that is not the parent
+        env.close();
+        env.close();
+        RippleLineCache third(env.closed(), first, j);
+        auto const newBobLines = third.getRippleLines(bob, outgoing);
+        BEAST_EXPECT(newBobLines && newBobLines != bobLines);
+    }
+
+public:
+    void
+    run() override
+    {
+        testReuse();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
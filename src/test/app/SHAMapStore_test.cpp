@@ -20,6 +20,7 @@
 #include <test/jtx.h>
 #include <test/jtx/envconfig.h>
 
+#include <xrpld/app/ledger/LedgerMaster.h>
 #include <xrpld/app/main/Application.h>
 #include <xrpld/app/main/NodeStoreScheduler.h>
 #include <xrpld/app/misc/SHAMapStore.h>
@@ -27,8 +28,11 @@
 #include <xrpld/core/ConfigSections.h>
 #include <xrpld/nodestore/detail/DatabaseRotatingImp.h>
 
+#include <xrpl/protocol/digest.h>
 #include <xrpl/protocol/jss.h>
 
+#include <future>
+
 namespace ripple {
 namespace test {
 
@@ -351,6 +355,54 @@ public:
         BEAST_EXPECT(lastRotated != store.getLastRotated());
     }
 
+    void
+    testCopyForward()
+    {
+        testcase("parallel copy forward");
+        using namespace jtx;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg = onlineDelete(std::move(cfg));
+            auto& section = cfg->section(ConfigSection::nodeDatabase());
+            section.set("copy_threads", "3");
+            section.set("copy_ops_per_second", "100000");
+            return cfg;
+        }));
+        auto& store = env.app().getSHAMapStore();
+
+        auto ledgerSeq = waitForReady(env);
+        auto const lastRotated = ledgerSeq - 1;
+        BEAST_EXPECT(store.getCopyProgress().isNull());
+
+        // Enough accounts that the state map has nodes below the depth it
+        // is split at
+        for (int i = 0; i < 200; ++i)
+            env.fund(XRP(1000), Account("alice" + std::to_string(i)));
+
+        // Rotate twice, so that the state of the validated ledger is only
+        // in the database because it was copied forward
+        for (; ledgerSeq < lastRotated + 2 * deleteInterval + 2; ++ledgerSeq)
+        {
+            env.close();
+            store.rendezvous();
+        }
+        BEAST_EXPECT(store.getLastRotated() > lastRotated + deleteInterval);
+        BEAST_EXPECT(store.getCopyProgress().isNull());
+
+        auto const validated = env.app().getLedgerMaster().getValidatedLedger();
+        std::size_t nodes = 0;
+        std::size_t missing = 0;
+        validated->stateMap().visitNodes([&](SHAMapTreeNode& node) {
+            ++nodes;
+            if (!env.app().getNodeStore().fetchNodeObject(
+                    node.getHash().as_uint256()))
+                ++missing;
+            return true;
+        });
+        BEAST_EXPECT(nodes > 200);
+        BEAST_EXPECT(missing == 0);
+    }
+
     void
     testCanDelete()
     {
@@ -645,13 +697,92 @@ public:
         BEAST_EXPECT(dbr->getName() == "3");
     }
 
+    void
+    testRotatingBatchFetch()
+    {
+        testcase("rotating batch fetch");
+
+        using namespace jtx;
+        Env env(*this, envconfig(onlineDelete));
+
+        auto nscfg = env.app().config().section(ConfigSection::nodeDatabase());
+        NodeStoreScheduler scheduler(env.app().getJobQueue());
+
+        auto dbr = std::make_unique<NodeStore::DatabaseRotatingImp>(
+            scheduler,
+            1,
+            makeBackendRotating(env, scheduler, "write"),
+            makeBackendRotating(env, scheduler, "archive"),
+            nscfg,
+            env.app().logs().journal("NodeStoreTest"));
+
+        auto const data = [](std::uint32_t i) {
+            auto const hash = sha512Half(i);
+            return Blob(hash.begin(), hash.end());
+        };
+
+        // Half the objects end up in the archive backend, and half in the
+        // writable one
+        constexpr std::uint32_t count = 100;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (i == count / 2)
+                dbr->rotate(
+                    makeBackendRotating(env, scheduler, "1"),
+                    [](std::string const&, std::string const&) {});
+            dbr->store(hotLEDGER, data(i), sha512Half(i), 0);
+        }
+
+        // The read threads fetch queued reads in batches, and some of
+        // those asked for are in neither backend
+        constexpr std::uint32_t missing = 10;
+        std::vector<std::shared_ptr<NodeObject>> fetched(count + missing);
+        std::atomic<std::uint32_t> remaining{count + missing};
+        std::promise<void> done;
+        for (std::uint32_t i = 0; i < count + missing; ++i)
+        {
+            dbr->asyncFetch(
+                sha512Half(i),
+                0,
+                NodeStore::FetchPriority::consensus,
+                [&, i](std::shared_ptr<NodeObject> const& nodeObject) {
+                    fetched[i] = nodeObject;
+                    if (--remaining == 0)
+                        done.set_value();
+                });
+        }
+        using namespace std::chrono_literals;
+        if (!BEAST_EXPECT(
+                done.get_future().wait_for(10s) == std::future_status::ready))
+            return;
+
+        for (std::uint32_t i = 0; i < count; ++i)
+            BEAST_EXPECT(fetched[i] && fetched[i]->getData() == data(i));
+        for (std::uint32_t i = count; i < count + missing; ++i)
+            BEAST_EXPECT(!fetched[i]);
+
+        // Those found in the archive were copied forward, so they outlive
+        // the archive
+        dbr->rotate(
+            makeBackendRotating(env, scheduler, "2"),
+            [](std::string const&, std::string const&) {});
+        NodeStore::Database& db = *dbr;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            auto const nodeObject = db.fetchNodeObject(sha512Half(i));
+            BEAST_EXPECT(nodeObject && nodeObject->getData() == data(i));
+        }
+    }
+
     void
     run() override
     {
         testClear();
         testAutomatic();
+        testCopyForward();
         testCanDelete();
         testRotate();
+        testRotatingBatchFetch();
     }
 };
 
@@ -24,8 +24,11 @@
 #include <test/jtx/envconfig.h>
 #include <test/jtx/ticket.h>
 
+#include <xrpld/app/ledger/TransactionMaster.h>
 #include <xrpld/app/main/Application.h>
+#include <xrpld/app/misc/CanonicalTXSet.h>
 #include <xrpld/app/misc/LoadFeeTrack.h>
+#include <xrpld/app/misc/NetworkOPs.h>
 #include <xrpld/app/misc/TxQ.h>
 #include <xrpld/app/tx/apply.h>
 
@@ -33,6 +36,9 @@
 #include <xrpl/protocol/jss.h>
 #include <xrpl/protocol/st.h>
 
+#include <chrono>
+#include <iomanip>
+
 namespace ripple {
 
 namespace test {
@@ -4546,6 +4552,155 @@ public:
         } while (expectedInQueue > 0);
     }
 
+    void
+    testParallelPreflight()
+    {
+        // NetworkOPs preflights a batch of transactions on many threads
+        // before it locks the open ledger to apply them.  Submit the same
+        // transactions as one batch to one server, and one at a time to
+        // another, and check that the results and the ledgers are the same.
+        testcase("Parallel preflight");
+        using namespace jtx;
+
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        Account const daria("daria");
+        Account const ellie("ellie");
+
+        Env batchEnv(
+            *this, makeConfig({{"minimum_txn_in_ledger_standalone", "3"}}));
+        Env serialEnv(
+            *this, makeConfig({{"minimum_txn_in_ledger_standalone", "3"}}));
+        for (Env* env : {&batchEnv, &serialEnv})
+        {
+            env->fund(XRP(10000), alice, bob, carol, daria);
+            env->close();
+        }
+
+        // More transactions than fit in one slice of the preflight.  Some
+        // go in the open ledger, some are queued, some fail in preflight
+        // and some fail in preclaim.
+        CanonicalTXSet set(batchEnv.closed()->info().hash);
+        for (auto const& account : {alice, bob, carol, daria})
+        {
+            auto const accountSeq = batchEnv.seq(account);
+            set.insert(batchEnv.jt(noop(account), seq(accountSeq)).stx);
+            set.insert(
+                batchEnv.jt(pay(account, ellie, XRP(1)), seq(accountSeq + 1))
+                    .stx);
+            set.insert(
+                batchEnv.jt(pay(account, ellie, XRP(300)), seq(accountSeq + 2))
+                    .stx);
+            set.insert(batchEnv.jt(noop(account), seq(accountSeq + 3)).stx);
+            set.insert(
+                batchEnv.jt(pay(account, ellie, XRP(-1)), seq(accountSeq + 4))
+                    .stx);
+        }
+
+        std::vector<TER> serialResults;
+        serialEnv.app().openLedger().modify(
+            [&](OpenView& view, beast::Journal j) {
+                bool changed = false;
+                for (auto const& [_, tx] : set)
+                {
+                    auto const result = serialEnv.app().getTxQ().apply(
+                        serialEnv.app(), view, tx, tapNONE, j);
+                    serialResults.push_back(result.ter);
+                    changed = changed || result.applied;
+                }
+                return changed;
+            });
+        BEAST_EXPECT(serialResults.size() == 20);
+        for (TER const ter :
+             {TER{tesSUCCESS}, TER{terQUEUED}, TER{temBAD_AMOUNT}})
+        {
+            BEAST_EXPECT(
+                std::count(serialResults.begin(), serialResults.end(), ter) >
+                0);
+        }
+
+        batchEnv.app().getOPs().processTransactionSet(set);
+
+        std::size_t i = 0;
+        for (auto const& [_, tx] : set)
+        {
+            auto const transaction =
+                batchEnv.app().getMasterTransaction().fetch_from_cache(
+                    tx->getTransactionID());
+            BEAST_EXPECT(transaction);
+            if (transaction && i < serialResults.size())
+                BEAST_EXPECT(transaction->getResult() == serialResults[i]);
+            ++i;
+        }
+
+        auto const batchMetrics =
+            batchEnv.app().getTxQ().getMetrics(*batchEnv.current());
+        auto const serialMetrics =
+            serialEnv.app().getTxQ().getMetrics(*serialEnv.current());
+        BEAST_EXPECT(batchMetrics.txCount == serialMetrics.txCount);
+        BEAST_EXPECT(batchMetrics.txInLedger == serialMetrics.txInLedger);
+
+        batchEnv.close();
+        serialEnv.close();
+        BEAST_EXPECT(
+            batchEnv.closed()->info().hash == serialEnv.closed()->info().hash);
+    }
+
+    void
+    testStalePreflight()
+    {
+        // A transaction preflighted before an amendment is enabled must be
+        // preflighted again when it is applied under the new rules, rather
+        // than fail with the result it got under the old ones.
+        testcase("Stale preflight");
+        using namespace jtx;
+
+        Account const alice("alice");
+        Account const bob("bob");
+
+        Env env(*this, supported_amendments() - featureDID);
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto const aliceTx = env.jt(did::setValid(alice)).stx;
+        auto const bobTx = env.jt(did::setValid(bob)).stx;
+        if (!BEAST_EXPECT(aliceTx && bobTx))
+            return;
+
+        auto const alicePreflight = preflight(
+            env.app(), env.current()->rules(), *aliceTx, tapNONE, env.journal);
+        auto const bobPreflight = preflight(
+            env.app(), env.current()->rules(), *bobTx, tapNONE, env.journal);
+        BEAST_EXPECT(alicePreflight.ter == temDISABLED);
+        BEAST_EXPECT(bobPreflight.ter == temDISABLED);
+
+        // Under the rules it was done with, the preflight is used as is.
+        env.app().openLedger().modify([&](OpenView& view, beast::Journal j) {
+            auto const result = env.app().getTxQ().apply(
+                env.app(), view, aliceTx, alicePreflight, j);
+            BEAST_EXPECT(result.ter == temDISABLED && !result.applied);
+            return result.applied;
+        });
+
+        env.enableFeature(featureDID);
+        env.close();
+        BEAST_EXPECT(env.current()->rules().enabled(featureDID));
+
+        env.app().openLedger().modify([&](OpenView& view, beast::Journal j) {
+            auto const txqResult = env.app().getTxQ().apply(
+                env.app(), view, aliceTx, alicePreflight, j);
+            BEAST_EXPECT(txqResult.ter == tesSUCCESS && txqResult.applied);
+
+            auto const result = ripple::apply(env.app(), view, bobPreflight);
+            BEAST_EXPECT(result.ter == tesSUCCESS && result.applied);
+            return txqResult.applied || result.applied;
+        });
+        env.close();
+
+        env.require(owners(alice, 1), owners(bob, 1));
+    }
+
     void
     testQueueFullDropPenalty()
     {
@@ -5077,6 +5232,8 @@ public:
         testInLedgerSeq();
         testInLedgerTicket();
         testReexecutePreflight();
+        testParallelPreflight();
+        testStalePreflight();
         testQueueFullDropPenalty();
         testCancelQueuedOffers();
         testZeroReferenceFee();
@@ -5092,8 +5249,74 @@ class TxQMetaInfo_test : public TxQPosNegFlows_test
     }
 };
 
+// Measures how long ledgers take to close with a queue of 50,000
+// transactions, as accounts each queue a long run of them. Only the few
+// that fit in each ledger leave the queue.
+class TxQ_manual_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using clock_type = std::chrono::steady_clock;
+
+        std::size_t const accountCount = 50;
+        std::size_t const txPerAccount = 1000;
+        std::size_t const closeCount = 10;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            auto& section = cfg->section("transaction_queue");
+            section.set("minimum_txn_in_ledger_standalone", "100");
+            section.set("minimum_queue_size", "60000");
+            section.set("maximum_txn_per_account", "1000");
+            section.set("normal_consensus_increase_percent", "0");
+            return cfg;
+        }));
+
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < accountCount; ++i)
+        {
+            accounts.emplace_back("account" + std::to_string(i));
+            env.fund(XRP(100000), noripple(accounts.back()));
+        }
+        env.close();
+
+        // Fill the open ledger, so that the rest are queued
+        auto const metrics = env.app().getTxQ().getMetrics(*env.current());
+        for (auto i = metrics.txInLedger; i <= metrics.txPerLedger; ++i)
+            env(noop(env.master));
+
+        testcase("queue " + std::to_string(accountCount * txPerAccount));
+        for (auto const& account : accounts)
+        {
+            auto seqAccount = env.seq(account);
+            for (std::size_t i = 0; i < txPerAccount; ++i)
+                env(noop(account), seq(seqAccount++), ter(terQUEUED));
+        }
+
+        auto const queued = [&env]() {
+            return env.app().getTxQ().getMetrics(*env.current()).txCount;
+        };
+        BEAST_EXPECT(queued() == accountCount * txPerAccount);
+
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < closeCount; ++i)
+            env.close();
+        auto const elapsed =
+            std::chrono::duration<double, std::milli>(clock_type::now() - start)
+                .count();
+
+        log << std::fixed << std::setprecision(1) << elapsed / closeCount
+            << " ms a ledger, " << queued() << " transactions still queued"
+            << std::endl;
+        BEAST_EXPECT(queued() < accountCount * txPerAccount);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(TxQPosNegFlows, app, ripple, 1);
 BEAST_DEFINE_TESTSUITE_PRIO(TxQMetaInfo, app, ripple, 1);
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQ_manual, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -17,15 +17,59 @@
 */
 //==============================================================================
 
-#include <test/jtx/Env.h>
+#include <test/jtx.h>
 
+#include <xrpld/app/misc/HashRouter.h>
 #include <xrpld/app/tx/apply.h>
 
 #include <xrpl/basics/StringUtilities.h>
 #include <xrpl/protocol/Feature.h>
 
+#include <chrono>
+#include <iomanip>
+
 namespace ripple {
 
+namespace {
+
+// Payments back and forth between accounts with keys of both types, with
+// the signature of one in every bad spoiled
+std::vector<std::shared_ptr<STTx const>>
+makePayments(test::jtx::Env& env, std::size_t count, std::size_t bad = 0)
+{
+    using namespace test::jtx;
+    Account const alice("alice", KeyType::secp256k1);
+    Account const becky("becky", KeyType::ed25519);
+    env.fund(XRP(10000), alice, becky);
+    env.close();
+
+    std::vector<std::shared_ptr<STTx const>> txs;
+    txs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto const& from = (i % 2) ? alice : becky;
+        auto const& to = (i % 2) ? becky : alice;
+        auto stx = env.jt(pay(from, to, drops(1 + i))).stx;
+        if (bad != 0 && i % bad == bad - 1)
+        {
+            STTx copy(*stx);
+            auto sig = copy.getFieldVL(sfTxnSignature);
+            sig[10] ^= 1;
+            copy.setFieldVL(sfTxnSignature, sig);
+
+            // Parsed again for its ID
+            Serializer ser;
+            copy.add(ser);
+            SerialIter sit(ser.slice());
+            stx = std::make_shared<STTx const>(sit);
+        }
+        txs.push_back(stx);
+    }
+    return txs;
+}
+
+}  // namespace
+
 class Apply_test : public beast::unit_test::suite
 {
 public:
@@ -34,6 +78,7 @@ public:
     {
         testcase("Require Fully Canonicial Signature");
         testFullyCanonicalSigs();
+        testBatchedValidity();
     }
 
     void
@@ -85,8 +130,129 @@ public:
 
         pass();
     }
+
+    void
+    testBatchedValidity()
+    {
+        testcase("Batched validity");
+
+        using namespace test::jtx;
+        Env env(*this);
+        auto const txs = makePayments(env, 100, 7);
+
+        auto& router = env.app().getHashRouter();
+        auto const rules = env.current()->rules();
+        checkValidity(
+            router, txs, rules, env.app().config(), env.app().getJobQueue());
+
+        // Every result was cached, and is the one a check of the single
+        // transaction gives
+        Env other(*this);
+        for (std::size_t i = 0; i < txs.size(); ++i)
+        {
+            auto const& tx = *txs[i];
+            BEAST_EXPECT(router.getFlags(tx.getTransactionID()) != 0);
+
+            auto const batched =
+                checkValidity(router, tx, rules, env.app().config()).first;
+            auto const single = checkValidity(
+                                    other.app().getHashRouter(),
+                                    tx,
+                                    rules,
+                                    other.app().config())
+                                    .first;
+            BEAST_EXPECT(batched == single);
+            BEAST_EXPECT(
+                batched == (i % 7 == 6 ? Validity::SigBad : Validity::Valid));
+        }
+
+        // Nothing to check
+        checkValidity(
+            router, {}, rules, env.app().config(), env.app().getJobQueue());
+    }
+};
+
+// Measures how many transactions a second have their signatures checked,
+// one at a time and in batches, against a target of 10,000. Half of the
+// transactions are signed with secp256k1 keys and half with Ed25519 keys.
+// The size of the batches can be set with --unittest-arg=<size>.
+class Apply_manual_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace test::jtx;
+        using clock_type = std::chrono::steady_clock;
+
+        std::size_t const count = 10'000;
+        std::size_t const batchSize =
+            arg().empty() ? 250 : std::stoul(arg());
+
+        auto const multiThreaded = []() {
+            return envconfig([](std::unique_ptr<Config> cfg) {
+                cfg->FORCE_MULTI_THREAD = true;
+                return cfg;
+            });
+        };
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        {
+            Env env(*this);
+            txs = makePayments(env, count);
+        }
+
+        auto const report = [&](clock_type::time_point start) {
+            auto const seconds =
+                std::chrono::duration<double>(clock_type::now() - start)
+                    .count();
+            auto const rate = count / seconds;
+            log << std::fixed << std::setprecision(0) << rate << " tx/s"
+                << (rate < 10'000 ? ", below the target" : "") << std::endl;
+            pass();
+        };
+
+        {
+            testcase("one at a time");
+            Env env(*this, multiThreaded());
+            auto const rules = env.current()->rules();
+            auto const start = clock_type::now();
+            for (auto const& tx : txs)
+            {
+                if (checkValidity(
+                        env.app().getHashRouter(),
+                        *tx,
+                        rules,
+                        env.app().config())
+                        .first != Validity::Valid)
+                    fail();
+            }
+            report(start);
+        }
+
+        {
+            testcase("batches of " + std::to_string(batchSize));
+            Env env(*this, multiThreaded());
+            auto const rules = env.current()->rules();
+            auto const start = clock_type::now();
+            for (std::size_t i = 0; i < count; i += batchSize)
+            {
+                std::vector<std::shared_ptr<STTx const>> batch(
+                    txs.begin() + i,
+                    txs.begin() + std::min(count, i + batchSize));
+                checkValidity(
+                    env.app().getHashRouter(),
+                    batch,
+                    rules,
+                    env.app().config(),
+                    env.app().getJobQueue());
+            }
+            report(start);
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(Apply, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(Apply_manual, app, ripple);
 
 }  // namespace ripple
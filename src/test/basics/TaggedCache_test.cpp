@@ -24,6 +24,10 @@
 #include <xrpl/basics/chrono.h>
 #include <xrpl/protocol/Protocol.h>
 
+#include <atomic>
+#include <iomanip>
+#include <thread>
+
 namespace ripple {
 
 /*
@@ -38,10 +42,11 @@ original object.
 
 class TaggedCache_test : public beast::unit_test::suite
 {
-public:
     void
-    run() override
+    testBasic()
     {
+        testcase("basic");
+
         using namespace std::chrono_literals;
         using namespace beast::severities;
         test::SuiteJournal journal("TaggedCache_test", *this);
@@ -149,8 +154,162 @@ public:
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
     }
+
+    void
+    testConcurrent()
+    {
+        testcase("concurrent");
+
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        using Key = LedgerIndex;
+        using Value = std::string;
+        using Cache = TaggedCache<Key, Value>;
+
+        Cache c("test", 1000, 1s, clock, journal);
+
+        // Several threads canonicalize and fetch overlapping keys while
+        // another sweeps. Every thread must see the same object for a key.
+        Key const keys = 2000;
+        std::vector<std::shared_ptr<Value>> canonical(keys);
+        for (Key k = 0; k < keys; ++k)
+        {
+            canonical[k] = std::make_shared<Value>(std::to_string(k));
+            c.canonicalize_replace_client(k, canonical[k]);
+        }
+
+        std::atomic<bool> done = false;
+        std::atomic<int> mismatches = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int pass = 0; pass < 20; ++pass)
+                {
+                    for (Key k = t; k < keys; k += 2)
+                    {
+                        auto p = std::make_shared<Value>(std::to_string(k));
+                        c.canonicalize_replace_client(k, p);
+                        if (p != canonical[k] || c.fetch(k) != canonical[k])
+                            ++mismatches;
+                    }
+                }
+            });
+        }
+        std::thread sweeper([&] {
+            while (!done)
+            {
+                c.sweep();
+                std::this_thread::yield();
+            }
+        });
+
+        for (auto& thread : threads)
+            thread.join();
+        done = true;
+        sweeper.join();
+
+        BEAST_EXPECT(mismatches == 0);
+        BEAST_EXPECT(c.getTrackSize() == keys);
+        BEAST_EXPECT(c.getCacheSize() == keys);
+        BEAST_EXPECT(c.getKeys().size() == keys);
+
+        // Once the only references are the cache's, everything ages out
+        canonical.clear();
+        ++clock;
+        c.sweep();
+        ++clock;
+        c.sweep();
+        BEAST_EXPECT(c.getCacheSize() == 0);
+        BEAST_EXPECT(c.getTrackSize() == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBasic();
+        testConcurrent();
+    }
+};
+
+// Measures lookup throughput as threads are added, with a sweep running
+// alongside. The number of threads can be set with
+// --unittest-arg=<threads>.
+class TaggedCache_manual_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        using clock_type = std::chrono::steady_clock;
+        using Key = LedgerIndex;
+        using Value = std::string;
+        using Cache = TaggedCache<Key, Value>;
+
+        beast::Journal const journal{beast::Journal::getNullSink()};
+        TestStopwatch clock;
+        clock.set(0);
+
+        Key const keys = 100'000;
+        std::size_t const lookups = 2'000'000;
+
+        Cache c("bench", keys, 1h, clock, journal);
+        for (Key k = 0; k < keys; ++k)
+            c.insert(k, std::to_string(k));
+
+        int const maxThreads = arg().empty()
+            ? std::max(4u, std::thread::hardware_concurrency())
+            : std::stoi(arg());
+
+        for (int n = 1; n <= maxThreads; n *= 2)
+        {
+            testcase(std::to_string(n) + " threads");
+
+            std::atomic<bool> done = false;
+            std::thread sweeper([&] {
+                while (!done)
+                {
+                    c.sweep();
+                    std::this_thread::sleep_for(10ms);
+                }
+            });
+
+            auto const start = clock_type::now();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < n; ++t)
+            {
+                threads.emplace_back([&, t] {
+                    Key k = t * 7919;
+                    for (std::size_t i = 0; i < lookups / n; ++i)
+                    {
+                        k = (k + 104729) % keys;
+                        if (!c.fetch(k))
+                            fail();
+                    }
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            auto const seconds =
+                std::chrono::duration<double>(clock_type::now() - start)
+                    .count();
+            done = true;
+            sweeper.join();
+
+            log << std::fixed << std::setprecision(0) << lookups / seconds
+                << " lookups/s" << std::endl;
+            pass();
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache, common, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCache_manual, common, ripple);
 
 }  // namespace ripple
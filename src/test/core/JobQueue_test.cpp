@@ -19,10 +19,22 @@
 
 #include <test/jtx/Env.h>
 
+#include <xrpld/core/ConfigSections.h>
 #include <xrpld/core/JobQueue.h>
+#include <xrpld/perflog/PerfLog.h>
 
+#include <xrpl/beast/insight/NullCollector.h>
 #include <xrpl/beast/unit_test.h>
 
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
 namespace ripple {
 namespace test {
 
@@ -30,10 +42,94 @@ namespace test {
 
 class JobQueue_test : public beast::unit_test::suite
 {
+    // Records the perf log instance of each job that starts
+    class InstancePerfLog : public perf::PerfLog
+    {
+        mutable std::mutex mutex_;
+        std::map<JobType, std::set<int>> instances_;
+
+    public:
+        std::set<int>
+        instances(JobType type) const
+        {
+            std::lock_guard lock(mutex_);
+            auto const it = instances_.find(type);
+            return it == instances_.end() ? std::set<int>{} : it->second;
+        }
+
+        void
+        rpcStart(std::string const&, std::uint64_t) override
+        {
+        }
+
+        void
+        rpcFinish(std::string const&, std::uint64_t) override
+        {
+        }
+
+        void
+        rpcError(std::string const&, std::uint64_t) override
+        {
+        }
+
+        void
+        jobQueue(JobType const) override
+        {
+        }
+
+        void
+        jobStart(
+            JobType const type,
+            std::chrono::microseconds,
+            std::chrono::time_point<std::chrono::steady_clock>,
+            int instance) override
+        {
+            std::lock_guard lock(mutex_);
+            instances_[type].insert(instance);
+        }
+
+        void
+        jobFinish(JobType const, std::chrono::microseconds, int) override
+        {
+        }
+
+        Json::Value
+        countersJson() const override
+        {
+            return Json::Value();
+        }
+
+        Json::Value
+        currentJson() const override
+        {
+            return Json::Value();
+        }
+
+        void
+        resizeJobs(int const) override
+        {
+        }
+
+        void
+        rotate() override
+        {
+        }
+    };
+
+    static std::unique_ptr<Config>
+    makeConfig(bool workStealing)
+    {
+        auto cfg = jtx::envconfig();
+        cfg->WORK_STEALING = workStealing;
+        return cfg;
+    }
+
     void
-    testAddJob()
+    testAddJob(bool workStealing)
     {
-        jtx::Env env{*this};
+        testcase(workStealing ? "addJob work stealing" : "addJob");
+
+        jtx::Env env{*this, makeConfig(workStealing)};
 
         JobQueue& jQueue = env.app().getJobQueue();
         {
@@ -66,9 +162,11 @@ class JobQueue_test : public beast::unit_test::suite
     }
 
     void
-    testPostCoro()
+    testPostCoro(bool workStealing)
     {
-        jtx::Env env{*this};
+        testcase(workStealing ? "postCoro work stealing" : "postCoro");
+
+        jtx::Env env{*this, makeConfig(workStealing)};
 
         JobQueue& jQueue = env.app().getJobQueue();
         {
@@ -151,16 +249,461 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testSlowJobTrace(bool workStealing)
+    {
+        testcase(
+            workStealing ? "slow job trace work stealing" : "slow job trace");
+
+        using namespace std::chrono_literals;
+        jtx::Env env{*this, makeConfig(workStealing)};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        jQueue.setSlowJobTrace(5ms);
+
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "FastJobTest", []() {}));
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "SlowJobTest", []() {
+            std::this_thread::sleep_for(10ms);
+        }));
+        jQueue.rendezvous();
+
+        Json::Value counts(Json::objectValue);
+        jQueue.getCountsJson(counts);
+
+        // Both jobs are in the histograms
+        auto const& latency = counts["job_latency"][JobTypes::name(jtCLIENT)];
+        BEAST_EXPECT(std::stoull(latency["queued"]["count"].asString()) >= 2);
+        BEAST_EXPECT(latency["ran"]["max"].asUInt() >= 10000);
+        BEAST_EXPECT(
+            latency["ran"]["p50"].asUInt() <= latency["ran"]["p99"].asUInt());
+
+        // The slow one was traced, along with where it was added
+        Json::Value slow;
+        for (auto const& job : counts["slow_jobs"])
+        {
+            if (job["name"].asString() == "SlowJobTest")
+                slow = job;
+        }
+        if (BEAST_EXPECT(slow.isObject()))
+        {
+            BEAST_EXPECT(slow["ran"].asUInt() >= 10000);
+            BEAST_EXPECT(
+                slow["added_by"].asString().find("JobQueue_test") !=
+                std::string::npos);
+        }
+
+        jQueue.setSlowJobTrace(0ms);
+        counts = Json::objectValue;
+        jQueue.getCountsJson(counts);
+        BEAST_EXPECT(!counts.isMember("slow_jobs"));
+    }
+
+    void
+    testPools(bool workStealing)
+    {
+        testcase(workStealing ? "pools work stealing" : "pools");
+
+        using namespace std::chrono_literals;
+        auto cfg = makeConfig(workStealing);
+        cfg->FORCE_MULTI_THREAD = true;
+        cfg->section(SECTION_JOB_POOLS).append("io");
+        cfg->section("io").set("threads", "1");
+        cfg->section("io").set("types", "ledgerData, sweep");
+        jtx::Env env{*this, std::move(cfg)};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        auto const waitFor = [](auto const& f) {
+            auto const timeout = std::chrono::steady_clock::now() + 10s;
+            while (!f() && std::chrono::steady_clock::now() < timeout)
+                std::this_thread::sleep_for(1ms);
+            return f();
+        };
+
+        // Jobs of the pool's types run on its only thread
+        std::atomic<bool> release{false};
+        std::atomic<bool> started{false};
+        std::thread::id sweepThread;
+        BEAST_EXPECT(jQueue.addJob(jtSWEEP, "PoolsTest", [&]() {
+            sweepThread = std::this_thread::get_id();
+            started = true;
+            while (!release)
+                std::this_thread::sleep_for(1ms);
+        }));
+        BEAST_EXPECT(waitFor([&]() { return started.load(); }));
+
+        // While it is busy, jobs of its types wait, but no others
+        std::atomic<bool> ledgerData{false};
+        std::atomic<bool> client{false};
+        std::thread::id ledgerDataThread;
+        BEAST_EXPECT(jQueue.addJob(jtLEDGER_DATA, "PoolsTest", [&]() {
+            ledgerDataThread = std::this_thread::get_id();
+            ledgerData = true;
+        }));
+        BEAST_EXPECT(
+            jQueue.addJob(jtCLIENT, "PoolsTest", [&]() { client = true; }));
+        BEAST_EXPECT(waitFor([&]() { return client.load(); }));
+        BEAST_EXPECT(!ledgerData);
+        BEAST_EXPECT(jQueue.getJobCount(jtLEDGER_DATA) == 1);
+
+        auto const json = jQueue.getJson(0);
+        if (BEAST_EXPECT(json["pools"].size() == 2))
+        {
+            auto const& pools = json["pools"];
+            BEAST_EXPECT(pools[1u]["name"] == "io");
+            BEAST_EXPECT(pools[1u]["threads"] == 1);
+            BEAST_EXPECT(
+                json["threads"] == pools[0u]["threads"].asInt() + 1);
+        }
+
+        release = true;
+        jQueue.rendezvous();
+        BEAST_EXPECT(ledgerData);
+        BEAST_EXPECT(ledgerDataThread == sweepThread);
+    }
+
+    void
+    testPoolInstances(bool workStealing)
+    {
+        testcase(
+            workStealing ? "pool instances work stealing" : "pool instances");
+
+        // The threads of each pool report to the perf log under instances
+        // of their own
+        jtx::Env env{*this};
+        InstancePerfLog perfLog;
+        int const threads = 2;
+        std::vector<JobPoolSetup> const pools{
+            {"io", threads, {jtLEDGER_DATA}, {}}};
+        {
+            JobQueue jQueue(
+                threads,
+                beast::insight::NullCollector::New(),
+                env.journal,
+                env.app().logs(),
+                perfLog,
+                workStealing,
+                pools);
+            for (int i = 0; i < 50; ++i)
+            {
+                BEAST_EXPECT(jQueue.addJob(jtCLIENT, "PoolsTest", []() {}));
+                BEAST_EXPECT(
+                    jQueue.addJob(jtLEDGER_DATA, "PoolsTest", []() {}));
+            }
+            jQueue.rendezvous();
+            jQueue.stop();
+        }
+
+        auto const client = perfLog.instances(jtCLIENT);
+        auto const ledgerData = perfLog.instances(jtLEDGER_DATA);
+        BEAST_EXPECT(!client.empty() && !ledgerData.empty());
+        BEAST_EXPECT(std::all_of(client.begin(), client.end(), [](int i) {
+            return i >= 0 && i < threads;
+        }));
+        BEAST_EXPECT(
+            std::all_of(ledgerData.begin(), ledgerData.end(), [](int i) {
+                return i >= threads && i < 2 * threads;
+            }));
+    }
+
+    void
+    testParallelFor(bool workStealing)
+    {
+        testcase(workStealing ? "parallelFor work stealing" : "parallelFor");
+
+        auto cfg = makeConfig(workStealing);
+        cfg->FORCE_MULTI_THREAD = true;
+        jtx::Env env{*this, std::move(cfg)};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+
+        // Every index is visited once, in slices no larger than asked for
+        auto const visit = [&jQueue](std::size_t count, std::size_t slice) {
+            std::vector<std::atomic<int>> visits(count);
+            std::atomic<bool> tooLarge{false};
+            jQueue.parallelFor(
+                jtTRANSACTION,
+                "ParallelForTest",
+                count,
+                slice,
+                [&](std::size_t first, std::size_t last) {
+                    if (first >= last || last - first > slice)
+                        tooLarge = true;
+                    for (auto i = first; i < last; ++i)
+                        ++visits[i];
+                });
+            return !tooLarge &&
+                std::all_of(visits.begin(), visits.end(), [](auto const& v) {
+                       return v.load() == 1;
+                   });
+        };
+
+        BEAST_EXPECT(visit(0, 4));
+        BEAST_EXPECT(visit(1, 4));
+        BEAST_EXPECT(visit(4, 4));
+        BEAST_EXPECT(visit(1000, 1));
+        BEAST_EXPECT(visit(1001, 16));
+
+        // Called from a job, which may be holding the only slot its type
+        // has, the caller does the work that no other thread takes
+        std::atomic<bool> nested{false};
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "ParallelForTest", [&]() {
+            nested = visit(100, 3);
+        }));
+        jQueue.rendezvous();
+        BEAST_EXPECT(nested);
+
+        // When a slice throws, the first exception is thrown to the caller
+        // once no slice is running, wherever it was thrown
+        for (std::size_t const thrower : {0, 7})
+        {
+            std::atomic<int> running{0};
+            bool caught = false;
+            try
+            {
+                jQueue.parallelFor(
+                    jtTRANSACTION,
+                    "ParallelForTest",
+                    64,
+                    1,
+                    [&](std::size_t first, std::size_t) {
+                        ++running;
+                        std::this_thread::sleep_for(
+                            std::chrono::milliseconds(1));
+                        --running;
+                        if (first % 8 == thrower)
+                            Throw<std::runtime_error>("slice failed");
+                    });
+            }
+            catch (std::runtime_error const& e)
+            {
+                caught = std::string(e.what()) == "slice failed";
+            }
+            BEAST_EXPECT(caught);
+            BEAST_EXPECT(running == 0);
+        }
+        BEAST_EXPECT(visit(100, 3));
+    }
+
+    void
+    testPoolSetup()
+    {
+        testcase("pool setup");
+
+        // Whether pools of the given names and values may be set up
+        using Values = std::vector<std::pair<std::string, std::string>>;
+        auto const valid =
+            [](std::vector<std::pair<std::string, Values>> const& pools) {
+                BasicConfig config;
+                for (auto const& [name, values] : pools)
+                {
+                    config.section(SECTION_JOB_POOLS).append(name);
+                    for (auto const& [key, value] : values)
+                        config.section(name).set(key, value);
+                }
+                try
+                {
+                    return setup_JobPools(config).size() == pools.size();
+                }
+                catch (std::runtime_error const&)
+                {
+                    return false;
+                }
+            };
+
+        BEAST_EXPECT(valid({}));
+        BEAST_EXPECT(valid(
+            {{"io", {{"threads", "2"}, {"types", "sweep,ledgerData"}}},
+             {"default", {{"cpus", "0-3, 8"}}}}));
+
+        // Missing or invalid threads
+        BEAST_EXPECT(!valid({{"io", {}}}));
+        BEAST_EXPECT(!valid({{"io", {{"types", "sweep"}}}}));
+        BEAST_EXPECT(!valid({{"io", {{"threads", "0"}, {"types", "sweep"}}}}));
+
+        // Unknown, special, missing and repeated types
+        BEAST_EXPECT(
+            !valid({{"io", {{"threads", "1"}, {"types", "noSuchJob"}}}}));
+        BEAST_EXPECT(
+            !valid({{"io", {{"threads", "1"}, {"types", "diskAccess"}}}}));
+        BEAST_EXPECT(!valid({{"io", {{"threads", "1"}}}}));
+        BEAST_EXPECT(!valid(
+            {{"io", {{"threads", "1"}, {"types", "sweep"}}},
+             {"disk", {{"threads", "1"}, {"types", "sweep"}}}}));
+
+        // Invalid cpus, and threads for the default pool
+        BEAST_EXPECT(!valid(
+            {{"io", {{"threads", "1"}, {"types", "sweep"}, {"cpus", "3-1"}}}}));
+        BEAST_EXPECT(!valid(
+            {{"io", {{"threads", "1"}, {"types", "sweep"}, {"cpus", "x"}}}}));
+        BEAST_EXPECT(!valid({{"default", {{"threads", "1"}}}}));
+    }
+
 public:
     void
     run() override
     {
-        testAddJob();
-        testPostCoro();
+        for (bool const workStealing : {false, true})
+        {
+            testAddJob(workStealing);
+            testPostCoro(workStealing);
+            testSlowJobTrace(workStealing);
+            testPools(workStealing);
+            testPoolInstances(workStealing);
+            testParallelFor(workStealing);
+        }
+        testPoolSetup();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(JobQueue, core, ripple);
 
+//------------------------------------------------------------------------------
+
+/*  Compares the dispatch throughput and latency of the two schedulers.
+
+    Producer threads post a mix of job types, each of which spins for a
+    while. The latency of a job is the time from it being posted to it
+    starting.
+
+    --unittest=JobQueue_manual
+    --unittest-arg=jobs=200000,producers=4,work=1,threads=1;4;16
+
+    work is how long each job spins, in microseconds.
+*/
+class JobQueue_manual_test : public beast::unit_test::suite
+{
+    struct Result
+    {
+        double jobsPerSecond;
+        std::vector<std::chrono::nanoseconds> latencies;
+    };
+
+    Result
+    measure(
+        bool workStealing,
+        int threads,
+        int producers,
+        int jobs,
+        std::chrono::microseconds work)
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        auto cfg = jtx::envconfig();
+        cfg->WORK_STEALING = workStealing;
+        cfg->WORKERS = threads;
+        cfg->FORCE_MULTI_THREAD = true;
+        jtx::Env env{*this, std::move(cfg)};
+        auto& jq = env.app().getJobQueue();
+
+        // Mostly transactions, as on a busy server
+        static JobType const types[] = {
+            jtTRANSACTION,
+            jtTRANSACTION,
+            jtTRANSACTION,
+            jtTRANSACTION,
+            jtTRANSACTION,
+            jtTRANSACTION,
+            jtCLIENT_RPC,
+            jtCLIENT_RPC,
+            jtPROPOSAL_t,
+            jtLEDGER_DATA};
+
+        Result result;
+        result.latencies.resize(jobs);
+        jq.rendezvous();
+
+        auto const start = clock_type::now();
+        std::vector<std::thread> posters;
+        for (int p = 0; p < producers; ++p)
+        {
+            posters.emplace_back([&, p]() {
+                for (int i = p; i < jobs; i += producers)
+                {
+                    auto const posted = clock_type::now();
+                    jq.addJob(
+                        types[i % std::size(types)],
+                        "bench",
+                        [&result, i, posted, work]() {
+                            auto const now = clock_type::now();
+                            result.latencies[i] = now - posted;
+                            while (clock_type::now() - now < work)
+                                ;
+                        });
+                }
+            });
+        }
+        for (auto& poster : posters)
+            poster.join();
+        jq.rendezvous();
+
+        std::chrono::duration<double> const elapsed =
+            clock_type::now() - start;
+        result.jobsPerSecond = jobs / elapsed.count();
+        return result;
+    }
+
+public:
+    void
+    run() override
+    {
+        Section params;
+        {
+            std::vector<std::string> v;
+            boost::split(v, arg(), boost::algorithm::is_any_of(","));
+            params.append(v);
+        }
+
+        auto const jobs = get<int>(params, "jobs", 200'000);
+        auto const producers = get<int>(params, "producers", 4);
+        auto const work =
+            std::chrono::microseconds(get<int>(params, "work", 1));
+
+        std::vector<int> threadCounts;
+        {
+            std::vector<std::string> v;
+            auto const list = get(params, "threads", "1,2,4,8,16");
+            boost::split(v, list, boost::algorithm::is_any_of(";"));
+            for (auto const& t : v)
+                threadCounts.push_back(std::max(std::stoi(t), 1));
+        }
+
+        log << "jobs=" << jobs << " producers=" << producers
+            << " work=" << work.count() << "us" << std::endl;
+        log << "scheduler       threads    jobs/s    p50 us    p99 us   "
+               "p999 us"
+            << std::endl;
+
+        for (auto const threads : threadCounts)
+        {
+            for (bool const workStealing : {false, true})
+            {
+                testcase(
+                    std::string(workStealing ? "work stealing" : "priority") +
+                    ", " + std::to_string(threads) + " threads");
+
+                auto r = measure(workStealing, threads, producers, jobs, work);
+                std::sort(r.latencies.begin(), r.latencies.end());
+                auto const at = [&r](double q) {
+                    auto const i = std::min(
+                        r.latencies.size() - 1,
+                        static_cast<std::size_t>(q * r.latencies.size()));
+                    return r.latencies[i].count() / 1000.0;
+                };
+
+                log << std::left << std::setw(16)
+                    << (workStealing ? "work_stealing" : "priority")
+                    << std::right << std::setw(7) << threads << std::fixed
+                    << std::setprecision(0) << std::setw(10)
+                    << r.jobsPerSecond << std::setprecision(1)
+                    << std::setw(10) << at(0.5) << std::setw(10) << at(0.99)
+                    << std::setw(10) << at(0.999) << std::endl;
+                pass();
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueue_manual, core, ripple);
+
 }  // namespace test
 }  // namespace ripple
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/core/LatencyHistogram.h>
+
+#include <xrpl/beast/unit_test.h>
+
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class LatencyHistogram_test : public beast::unit_test::suite
+{
+    using us = std::chrono::microseconds;
+
+    void
+    testBuckets()
+    {
+        testcase("buckets");
+
+        using H = LatencyHistogram;
+
+        // Small values are exact
+        for (std::uint64_t v = 0; v < H::subBuckets; ++v)
+        {
+            BEAST_EXPECT(H::bucket(v) == static_cast<int>(v));
+            BEAST_EXPECT(H::bucketMax(H::bucket(v)) == v);
+        }
+
+        // Every value is in a bucket whose top is at or above it, and
+        // within an eighth of it, and the buckets are in order
+        int last = 0;
+        for (std::uint64_t v = 1; v < (std::uint64_t{1} << 37); v += v / 7 + 1)
+        {
+            auto const b = H::bucket(v);
+            BEAST_EXPECT(b >= last);
+            BEAST_EXPECT(b < H::bucketCount);
+            BEAST_EXPECT(H::bucketMax(b) >= v);
+            BEAST_EXPECT(H::bucketMax(b) - v <= v / H::subBuckets);
+            BEAST_EXPECT(b == 0 || H::bucketMax(b - 1) < v);
+            last = b;
+        }
+
+        // Too large values are kept in the last bucket
+        BEAST_EXPECT(H::bucket(~std::uint64_t{0}) == H::bucketCount - 1);
+    }
+
+    void
+    testPercentiles()
+    {
+        testcase("percentiles");
+
+        LatencyHistogram h;
+        BEAST_EXPECT(LatencyHistogram::percentile(h.counts(), 0.5) == us{0});
+
+        for (int i = 1; i <= 1000; ++i)
+            h.record(us{i});
+        h.record(us{-5});
+
+        auto const counts = h.counts();
+        BEAST_EXPECT(LatencyHistogram::total(counts) == 1001);
+        BEAST_EXPECT(h.max() == us{1000});
+
+        auto const near = [&](double p, std::int64_t expected) {
+            auto const v = LatencyHistogram::percentile(counts, p).count();
+            return v >= expected && v <= expected + expected / 8;
+        };
+        BEAST_EXPECT(near(0.5, 500));
+        BEAST_EXPECT(near(0.9, 900));
+        BEAST_EXPECT(near(0.99, 990));
+        BEAST_EXPECT(near(1.0, 1000));
+
+        auto const json = h.getJson();
+        BEAST_EXPECT(json["count"].asString() == "1001");
+        BEAST_EXPECT(json["max"].asUInt() == 1000);
+        BEAST_EXPECT(json["p999"].asUInt() <= 1000);
+
+        // Only the values recorded after the snapshot
+        for (int i = 0; i < 100; ++i)
+            h.record(us{50000});
+        auto const recent = LatencyHistogram::since(h.counts(), counts);
+        BEAST_EXPECT(LatencyHistogram::total(recent) == 100);
+        auto const p50 = LatencyHistogram::percentile(recent, 0.5).count();
+        BEAST_EXPECT(p50 >= 50000 && p50 <= 50000 + 50000 / 8);
+    }
+
+    void
+    testThreads()
+    {
+        testcase("threads");
+
+        LatencyHistogram h;
+        int const threads = 4;
+        int const perThread = 100000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&h, t]() {
+                for (int i = 0; i < perThread; ++i)
+                    h.record(us{(i % 1000) * (t + 1)});
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+
+        BEAST_EXPECT(
+            LatencyHistogram::total(h.counts()) == threads * perThread);
+        BEAST_EXPECT(h.max() == us{999 * threads});
+    }
+
+public:
+    void
+    run() override
+    {
+        testBuckets();
+        testPercentiles();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LatencyHistogram, core, ripple);
+
+}  // namespace ripple
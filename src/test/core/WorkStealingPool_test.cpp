@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/core/JobTypes.h>
+#include <xrpld/core/detail/WorkStealingPool.h>
+
+#include <xrpl/beast/unit_test.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class WorkStealingPool_test : public beast::unit_test::suite
+{
+    struct TestCallback : WorkStealingPool::Callback
+    {
+        void
+        processJob(Job& job, int instance) override
+        {
+            job.doJob();
+        }
+    };
+
+    LoadMonitor load_{beast::Journal{beast::Journal::getNullSink()}};
+
+    std::unique_ptr<Job>
+    makeJob(JobType type, std::function<void()> f)
+    {
+        return std::make_unique<Job>(type, "test", 0, load_, std::move(f));
+    }
+
+    // Wait, but not forever, for a condition that another thread will make
+    // true
+    template <class F>
+    static bool
+    waitFor(F const& f)
+    {
+        using namespace std::chrono_literals;
+        auto const timeout = std::chrono::steady_clock::now() + 10s;
+        while (!f())
+        {
+            if (std::chrono::steady_clock::now() > timeout)
+                return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    void
+    testPriority()
+    {
+        testcase("priority");
+
+        TestCallback cb;
+        WorkStealingPool pool(cb, nullptr, "Test", 1);
+
+        // Hold the only thread, so that the other jobs wait
+        std::atomic<bool> release{false};
+        std::atomic<bool> started{false};
+        pool.addJob(makeJob(jtCLIENT, [&]() {
+            started = true;
+            while (!release)
+                std::this_thread::yield();
+        }));
+        BEAST_EXPECT(waitFor([&]() { return started.load(); }));
+
+        std::mutex m;
+        std::vector<std::pair<JobType, int>> order;
+        std::vector<std::pair<JobType, int>> queued;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (auto const type : {jtPACK, jtTRANSACTION, jtCLIENT, jtADMIN})
+            {
+                queued.emplace_back(type, i);
+                pool.addJob(makeJob(type, [&m, &order, type, i]() {
+                    std::lock_guard lock(m);
+                    order.emplace_back(type, i);
+                }));
+            }
+        }
+        BEAST_EXPECT(pool.getWaiting(jtTRANSACTION) == 4);
+        BEAST_EXPECT(pool.getRunning(jtCLIENT) == 1);
+        BEAST_EXPECT(pool.getWaiting() == queued.size());
+
+        release = true;
+        pool.rendezvous();
+        BEAST_EXPECT(pool.getWaiting() == 0);
+        BEAST_EXPECT(pool.getRunning(jtCLIENT) == 0);
+
+        // Higher priorities first, and in the order posted within one
+        std::sort(
+            queued.begin(), queued.end(), [](auto const& a, auto const& b) {
+                if (a.first != b.first)
+                    return a.first > b.first;
+                return a.second < b.second;
+            });
+        BEAST_EXPECT(order == queued);
+    }
+
+    void
+    testLimit()
+    {
+        testcase("limit");
+
+        TestCallback cb;
+        WorkStealingPool pool(cb, nullptr, "Test", 8);
+
+        auto const limit = JobTypes::instance().get(jtLEDGER_DATA).limit();
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        std::atomic<int> done{0};
+        for (int i = 0; i < 64; ++i)
+        {
+            pool.addJob(makeJob(jtLEDGER_DATA, [&]() {
+                auto const now = ++running;
+                auto p = peak.load();
+                while (now > p && !peak.compare_exchange_weak(p, now))
+                    ;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                --running;
+                ++done;
+            }));
+        }
+        pool.rendezvous();
+        BEAST_EXPECT(done == 64);
+        BEAST_EXPECT(peak <= limit);
+        BEAST_EXPECT(peak >= 1);
+
+        // A type that may not run at all waits, and counts as waiting
+        bool ran = false;
+        pool.addJob(makeJob(jtPEER, [&ran]() { ran = true; }));
+        BEAST_EXPECT(pool.getWaiting(jtPEER) == 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        BEAST_EXPECT(!ran);
+    }
+
+    void
+    testStealing()
+    {
+        testcase("stealing");
+
+        int const threads = 4;
+        TestCallback cb;
+        WorkStealingPool pool(cb, nullptr, "Test", threads);
+
+        // Jobs posted by a job are kept by its thread, which stays busy
+        // until the others have taken them all
+        std::atomic<int> started{0};
+        std::atomic<bool> timedOut{false};
+        std::atomic<int> done{0};
+        pool.addJob(makeJob(jtCLIENT, [&]() {
+            for (int i = 0; i < threads - 1; ++i)
+            {
+                pool.addJob(makeJob(jtTRANSACTION, [&]() {
+                    ++started;
+                    if (!waitFor([&]() { return started == threads - 1; }))
+                        timedOut = true;
+                    ++done;
+                }));
+            }
+            if (!waitFor([&]() { return started == threads - 1; }))
+                timedOut = true;
+            ++done;
+        }));
+        pool.rendezvous();
+        BEAST_EXPECT(!timedOut);
+        BEAST_EXPECT(done == threads);
+    }
+
+    void
+    testStress()
+    {
+        testcase("stress");
+
+        TestCallback cb;
+        WorkStealingPool pool(cb, nullptr, "Test", 4);
+
+        // Jobs posted from inside and outside the pool, of types with and
+        // without limits
+        std::atomic<int> done{0};
+        int const producers = 4;
+        int const perProducer = 2000;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < perProducer; ++i)
+                {
+                    auto const type = (i % 3 == 0)
+                        ? jtLEDGER_DATA
+                        : (i % 3 == 1 ? jtTRANSACTION : jtCLIENT);
+                    pool.addJob(makeJob(type, [&, type]() {
+                        if (type == jtCLIENT)
+                            pool.addJob(makeJob(jtLEDGER_REQ, [&]() {
+                                ++done;
+                            }));
+                        ++done;
+                    }));
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        pool.rendezvous();
+
+        // The client jobs each post another
+        int clientJobs = 0;
+        for (int i = 0; i < perProducer; ++i)
+        {
+            if (i % 3 == 2)
+                ++clientJobs;
+        }
+        BEAST_EXPECT(done == producers * (perProducer + clientJobs));
+        BEAST_EXPECT(pool.getWaiting() == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testPriority();
+        testLimit();
+        testStealing();
+        testStress();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(WorkStealingPool, core, ripple);
+
+}  // namespace ripple
@@ -21,6 +21,7 @@
 
 #include <xrpld/ledger/ApplyViewImpl.h>
 #include <xrpld/ledger/PaymentSandbox.h>
+#include <xrpld/ledger/RecordingView.h>
 #include <xrpld/ledger/View.h>
 
 #include <xrpl/protocol/AmountConversions.h>
@@ -408,6 +409,60 @@ class PaymentSandbox_test : public beast::unit_test::suite
         BEAST_EXPECT(balance.getIssuer() == USD.issue().account);
     }
 
+    void
+    testRecording(FeatureBitset features)
+    {
+        // What is read through a RecordingView on a PaymentSandbox, and
+        // what a sandbox on top of it changes, may be compared.
+        testcase("recording");
+
+        using namespace jtx;
+        Env env(*this, features);
+
+        Account const gw("gw");
+        auto const USD = gw["USD"];
+        Account const alice("alice");
+
+        env.fund(XRP(10000), alice, gw);
+        env.trust(USD(100), alice);
+        env(pay(gw, alice, USD(50)));
+
+        ApplyViewImpl av(&*env.current(), tapNONE);
+        PaymentSandbox sb(&av);
+        BEAST_EXPECT(
+            accountSend(sb, gw, alice, USD(30), env.journal) == tesSUCCESS);
+
+        // The balance hook of the sandbox is used
+        ReadSet reads;
+        RecordingView const recording(sb, reads);
+        auto const holds = [&](ReadView const& view) {
+            return accountHolds(
+                view, alice, USD.currency, gw, fhIGNORE_FREEZE, env.journal);
+        };
+        BEAST_EXPECT(holds(recording) == USD(50));
+        BEAST_EXPECT(holds(recording) == holds(sb));
+
+        auto const line = keylet::line(alice, USD.issue()).key;
+        BEAST_EXPECT(
+            std::find(reads.keys.begin(), reads.keys.end(), line) !=
+            reads.keys.end());
+        BEAST_EXPECT(!reads.changedBy({keylet::account(Account("bob")).key}));
+
+        // Changes are seen without being applied
+        PaymentSandbox child(&sb);
+        BEAST_EXPECT(
+            accountSend(child, alice, gw, USD(10), env.journal) == tesSUCCESS);
+        std::vector<uint256> keys;
+        WriteRecorder recorder(keys);
+        child.visitChanges(recorder);
+        BEAST_EXPECT(std::find(keys.begin(), keys.end(), line) != keys.end());
+        BEAST_EXPECT(reads.changedBy({keys.begin(), keys.end()}));
+        BEAST_EXPECT(holds(sb) == USD(50));
+
+        child.apply(sb);
+        BEAST_EXPECT(holds(sb) == USD(40));
+    }
+
 public:
     void
     run() override
@@ -418,6 +473,7 @@ public:
             testTinyBalance(features);
             testReserve(features);
             testBalanceHook(features);
+            testRecording(features);
         };
         using namespace jtx;
         auto const sa = supported_amendments();
@@ -22,12 +22,15 @@
 
 #include <xrpld/nodestore/DummyScheduler.h>
 #include <xrpld/nodestore/Manager.h>
+#include <xrpld/nodestore/detail/EncodedBlob.h>
+#include <xrpld/nodestore/detail/ZstdDictionary.h>
 #include <xrpld/unity/rocksdb.h>
 
 #include <xrpl/basics/ByteUtilities.h>
 #include <xrpl/beast/utility/temp_dir.h>
 
 #include <algorithm>
+#include <fstream>
 
 namespace ripple {
 
@@ -102,6 +105,125 @@ public:
         }
     }
 
+    void
+    testZstd(std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase("Backend type=nudb compression=zstd");
+
+        beast::temp_dir tempDir;
+        auto const dictionaryPath = tempDir.file("dictionary");
+
+        {
+            // Train a dictionary on the encoded form of similar objects
+            std::vector<Blob> samples;
+            for (auto const& object :
+                 createLedgerEntryBatch(numObjectsToTest, seedValue + 1))
+            {
+                EncodedBlob const e(object);
+                auto const data = static_cast<std::uint8_t const*>(e.getData());
+                samples.emplace_back(data, data + e.getSize());
+            }
+
+            auto const dictionary =
+                ZstdDictionary::train(samples, kilobytes(16));
+            std::ofstream(dictionaryPath, std::ios::binary)
+                .write(
+                    reinterpret_cast<char const*>(dictionary.data()),
+                    dictionary.size());
+        }
+
+        Section params;
+        params.set("type", "nudb");
+        params.set("path", tempDir.path());
+        params.set("compression", "zstd");
+        params.set("compression_dictionary", dictionaryPath);
+
+        auto entries = createLedgerEntryBatch(numObjectsToTest, seedValue);
+        auto const random = createPredictableBatch(numObjectsToTest, seedValue);
+        auto const later =
+            createLedgerEntryBatch(numObjectsToTest, seedValue + 2);
+
+        using namespace beast::severities;
+        test::SuiteJournal journal("Backend_test", *this);
+
+        {
+            std::unique_ptr<Backend> backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+
+            storeBatch(*backend, entries);
+            storeBatch(*backend, random);
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, entries);
+            BEAST_EXPECT(areBatchesEqual(entries, copy));
+            fetchCopyOfBatch(*backend, &copy, random);
+            BEAST_EXPECT(areBatchesEqual(random, copy));
+        }
+
+        {
+            // Switch back to lz4. The zstd objects can still be read.
+            params.set("compression", "lz4");
+            std::unique_ptr<Backend> backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+
+            storeBatch(*backend, later);
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, entries);
+            BEAST_EXPECT(areBatchesEqual(entries, copy));
+            fetchCopyOfBatch(*backend, &copy, random);
+            BEAST_EXPECT(areBatchesEqual(random, copy));
+            fetchCopyOfBatch(*backend, &copy, later);
+            BEAST_EXPECT(areBatchesEqual(later, copy));
+        }
+
+        {
+            // Without the dictionary, the lz4 objects can still be read
+            // but the zstd objects can not.
+            Section noDictionary;
+            noDictionary.set("type", "nudb");
+            noDictionary.set("path", tempDir.path());
+            std::unique_ptr<Backend> backend = Manager::instance().make_Backend(
+                noDictionary, megabytes(4), scheduler, journal);
+            backend->open();
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, later);
+            BEAST_EXPECT(areBatchesEqual(later, copy));
+
+            std::shared_ptr<NodeObject> object;
+            try
+            {
+                backend->fetch(entries.front()->getHash().cbegin(), &object);
+                fail("zstd object read without a dictionary");
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+        }
+
+        // Compressing with zstd requires a dictionary
+        try
+        {
+            Section missing;
+            missing.set("type", "nudb");
+            missing.set("path", tempDir.path());
+            missing.set("compression", "zstd");
+            Manager::instance().make_Backend(
+                missing, megabytes(4), scheduler, journal);
+            fail("compression=zstd without a dictionary");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void
@@ -110,6 +232,7 @@ public:
         std::uint64_t const seedValue = 50;
 
         testBackend("nudb", seedValue);
+        testZstd(seedValue);
 
 #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend("rocksdb", seedValue);
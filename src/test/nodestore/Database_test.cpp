@@ -29,6 +29,8 @@
 
 #include <xrpl/beast/utility/temp_dir.h>
 
+#include <future>
+
 namespace ripple {
 
 namespace NodeStore {
@@ -554,6 +556,181 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void
+    testAsyncFetch(std::int64_t const seedValue)
+    {
+        testcase("asyncFetch");
+
+        DummyScheduler scheduler;
+
+        beast::temp_dir node_db;
+        Section nodeParams;
+        nodeParams.set("type", "memory");
+        nodeParams.set("path", node_db.path());
+        nodeParams.set("rq_bundle", "8");
+
+        auto batch = createPredictableBatch(numObjectsToTest, seedValue);
+
+        std::unique_ptr<Database> db = Manager::instance().make_Database(
+            megabytes(4), scheduler, 3, nodeParams, journal_);
+        storeBatch(*db, batch);
+
+        // Request every object twice with different priorities, and one
+        // object that does not exist.
+        std::mutex m;
+        std::condition_variable cv;
+        std::size_t pending = 2 * batch.size() + 1;
+        std::size_t matched = 0;
+        bool missing = false;
+
+        auto const finished = [&](bool match) {
+            std::lock_guard lock(m);
+            if (match)
+                ++matched;
+            if (--pending == 0)
+                cv.notify_all();
+        };
+
+        auto const priorities = {
+            FetchPriority::background,
+            FetchPriority::catchup,
+            FetchPriority::consensus};
+
+        for (auto const priority : priorities)
+        {
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                if (i % priorities.size() ==
+                    static_cast<std::size_t>(priority))
+                    continue;
+
+                auto const& expected = batch[i];
+                db->asyncFetch(
+                    expected->getHash(),
+                    0,
+                    priority,
+                    [&, expected](std::shared_ptr<NodeObject> const& obj) {
+                        finished(obj && isSame(obj, expected));
+                    });
+            }
+        }
+
+        db->asyncFetch(
+            uint256{1}, 0, FetchPriority::consensus, [&](auto const& obj) {
+                missing = !obj;
+                finished(false);
+            });
+
+        {
+            std::unique_lock lock(m);
+            BEAST_EXPECT(cv.wait_for(lock, std::chrono::seconds(30), [&] {
+                return pending == 0;
+            }));
+        }
+        BEAST_EXPECT(matched == 2 * batch.size());
+        BEAST_EXPECT(missing);
+
+        Json::Value counts(Json::objectValue);
+        db->getCountsJson(counts);
+        BEAST_EXPECT(counts["read_queue"].asUInt() == 0);
+        BEAST_EXPECT(counts["read_request_bundle"].asInt() == 8);
+        BEAST_EXPECT(counts["read_queue_priority"].isObject());
+        BEAST_EXPECT(counts["read_coalesced"].isString());
+
+        // No batch was larger than the bundle size, and no request was
+        // both coalesced and fetched. Requests found in the cache are
+        // neither.
+        std::uint64_t batches = 0;
+        for (auto const& bucket : counts["read_batch_sizes"].getMemberNames())
+        {
+            auto const n =
+                std::stoull(counts["read_batch_sizes"][bucket].asString());
+            batches += n;
+            if (n != 0)
+                BEAST_EXPECT(std::stoi(bucket) <= 8);
+        }
+        BEAST_EXPECT(batches != 0);
+        BEAST_EXPECT(
+            std::stoull(counts[jss::node_reads_total].asString()) +
+                std::stoull(counts["read_coalesced"].asString()) <=
+            2 * batch.size() + 1);
+    }
+
+    void
+    testAsyncFetchBusyThread(std::int64_t const seedValue)
+    {
+        testcase("asyncFetch busy thread");
+
+        DummyScheduler scheduler;
+
+        beast::temp_dir node_db;
+        Section nodeParams;
+        nodeParams.set("type", "memory");
+        nodeParams.set("path", node_db.path());
+        nodeParams.set("cache_size", "0");
+        nodeParams.set("cache_age", "0");
+
+        auto batch = createPredictableBatch(numObjectsToTest, seedValue);
+
+        std::unique_ptr<Database> db = Manager::instance().make_Database(
+            megabytes(4), scheduler, 2, nodeParams, journal_);
+        storeBatch(*db, batch);
+
+        // Keep one of the two read threads busy in a callback
+        std::promise<void> busy;
+        std::promise<void> release;
+        auto const released = release.get_future().share();
+        db->asyncFetch(
+            batch[0]->getHash(),
+            0,
+            FetchPriority::consensus,
+            [&busy, released](auto const&) {
+                busy.set_value();
+                released.wait();
+            });
+        busy.get_future().wait();
+
+        // The other thread does every read meanwhile, including those
+        // queued on the busy thread's shard
+        std::mutex m;
+        std::condition_variable cv;
+        std::size_t pending = batch.size() - 1;
+        std::size_t matched = 0;
+        for (std::size_t i = 1; i < batch.size(); ++i)
+        {
+            auto const& expected = batch[i];
+            db->asyncFetch(
+                expected->getHash(),
+                0,
+                FetchPriority::consensus,
+                [&, expected](std::shared_ptr<NodeObject> const& obj) {
+                    std::lock_guard lock(m);
+                    if (obj && isSame(obj, expected))
+                        ++matched;
+                    if (--pending == 0)
+                        cv.notify_all();
+                });
+        }
+
+        bool done;
+        {
+            std::unique_lock lock(m);
+            done = cv.wait_for(lock, std::chrono::seconds(30), [&] {
+                return pending == 0;
+            });
+        }
+        release.set_value();
+
+        BEAST_EXPECT(done);
+        BEAST_EXPECT(matched == batch.size() - 1);
+
+        Json::Value counts(Json::objectValue);
+        db->getCountsJson(counts);
+        BEAST_EXPECT(std::stoull(counts["read_stolen"].asString()) != 0);
+    }
+
+    //--------------------------------------------------------------------------
+
     void
     testImport(
         std::string const& destBackendType,
@@ -741,6 +918,9 @@ public:
 
         testNodeStore("memory", false, seedValue);
 
+        testAsyncFetch(seedValue);
+        testAsyncFetchBusyThread(seedValue);
+
         // Persistent backend tests
         {
             testNodeStore("nudb", true, seedValue);
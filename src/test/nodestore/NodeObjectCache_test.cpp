@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/nodestore/TestBase.h>
+
+#include <xrpld/nodestore/detail/NodeObjectCache.h>
+
+#include <xrpl/basics/ByteUtilities.h>
+
+namespace ripple {
+namespace NodeStore {
+
+class NodeObjectCache_test : public TestBase
+{
+    beast::Journal const j_{beast::Journal::getNullSink()};
+
+    // Fetch an object the way DatabaseNodeImp does, admitting it after a
+    // miss as if it had been read from the backend.
+    static bool
+    access(NodeObjectCache& cache, std::shared_ptr<NodeObject> const& object)
+    {
+        if (auto const cached = cache.fetch(object->getHash()))
+            return isSame(cached, object);
+
+        cache.admit(*object);
+        return false;
+    }
+
+    std::size_t
+    countCached(NodeObjectCache& cache, Batch const& batch)
+    {
+        std::size_t found = 0;
+        for (auto const& object : batch)
+        {
+            if (auto const cached = cache.fetch(object->getHash()))
+            {
+                BEAST_EXPECT(isSame(cached, object));
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    void
+    testFetch()
+    {
+        testcase("fetch");
+
+        NodeObjectCache cache(megabytes(4), j_);
+        auto const batch = createPredictableBatch(100, 1);
+
+        for (auto const& object : batch)
+            BEAST_EXPECT(!cache.fetch(object->getHash()));
+
+        for (auto const& object : batch)
+            cache.insert(*object);
+
+        BEAST_EXPECT(countCached(cache, batch) == batch.size());
+
+        std::size_t bytes = 0;
+        for (auto const& object : batch)
+            bytes += object->getData().size();
+        BEAST_EXPECT(cache.size() == bytes);
+
+        auto const counts = cache.getCountsJson();
+        BEAST_EXPECT(counts["hits"] == std::to_string(batch.size()));
+        BEAST_EXPECT(counts["misses"] == std::to_string(batch.size()));
+        BEAST_EXPECT(counts["entries"] == std::to_string(batch.size()));
+        BEAST_EXPECT(counts["hit_ratio"].asDouble() == 0.5);
+        BEAST_EXPECT(counts["evictions"] == "0");
+    }
+
+    void
+    testBudget()
+    {
+        testcase("budget");
+
+        auto const budget = megabytes(1);
+        NodeObjectCache cache(budget, j_);
+
+        // Store many times the budget
+        auto const batch = createPredictableBatch(10 * numObjectsToTest, 2);
+        for (auto const& object : batch)
+            cache.insert(*object);
+
+        auto const counts = cache.getCountsJson();
+        BEAST_EXPECT(cache.size() <= budget);
+        BEAST_EXPECT(std::stoull(counts["bytes_allocated"].asString()) <= budget);
+        BEAST_EXPECT(std::stoull(counts["bytes_budget"].asString()) <= budget);
+        BEAST_EXPECT(std::stoull(counts["evictions"].asString()) != 0);
+
+        // The most recently stored objects are still cached
+        Batch const recent(batch.end() - 100, batch.end());
+        BEAST_EXPECT(countCached(cache, recent) == recent.size());
+    }
+
+    void
+    testScanResistance()
+    {
+        testcase("scan resistance");
+
+        NodeObjectCache cache(megabytes(4), j_);
+
+        // A working set of a small part of the cache, accessed repeatedly
+        auto const hot = createPredictableBatch(100, 3);
+        for (int i = 0; i != 3; ++i)
+        {
+            for (auto const& object : hot)
+                access(cache, object);
+        }
+        BEAST_EXPECT(countCached(cache, hot) == hot.size());
+
+        // A scan that reads many times the size of the cache once
+        auto const scan = createPredictableBatch(10 * numObjectsToTest, 4);
+        for (auto const& object : scan)
+            access(cache, object);
+
+        BEAST_EXPECT(countCached(cache, hot) == hot.size());
+        BEAST_EXPECT(
+            std::stoull(cache.getCountsJson()["rejected"].asString()) != 0);
+
+        // Storing new objects recycles slabs, but keeps the working set
+        auto const stored = createPredictableBatch(10 * numObjectsToTest, 5);
+        for (auto const& object : stored)
+            cache.insert(*object);
+
+        BEAST_EXPECT(countCached(cache, hot) == hot.size());
+        BEAST_EXPECT(
+            std::stoull(cache.getCountsJson()["retained"].asString()) != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFetch();
+        testBudget();
+        testScanResistance();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(NodeObjectCache, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
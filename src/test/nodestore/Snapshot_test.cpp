@@ -0,0 +1,504 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/nodestore/TestBase.h>
+#include <test/unit_test/SuiteJournal.h>
+
+#include <xrpld/nodestore/DummyScheduler.h>
+#include <xrpld/nodestore/Manager.h>
+#include <xrpld/nodestore/Snapshot.h>
+
+#include <xrpl/basics/ByteUtilities.h>
+#include <xrpl/beast/utility/temp_dir.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ripple {
+namespace NodeStore {
+
+class Snapshot_test : public TestBase
+{
+    test::SuiteJournal journal_{"Snapshot_test", *this};
+
+    static void
+    write(
+        std::string const& path,
+        uint256 const& ledgerHash,
+        Batch const& batch)
+    {
+        SnapshotWriter writer(path, 7, ledgerHash);
+        for (auto const& object : batch)
+        {
+            writer.add(
+                object->getType(),
+                object->getHash(),
+                makeSlice(object->getData()));
+        }
+        writer.finish();
+    }
+
+    // An object whose hash is that of its data, as for real ledger objects
+    static std::shared_ptr<NodeObject>
+    makeObject(NodeObjectType type, HashPrefix prefix, Blob payload)
+    {
+        Blob data(4);
+        auto const p = static_cast<std::uint32_t>(prefix);
+        data[0] = p >> 24;
+        data[1] = (p >> 16) & 0xff;
+        data[2] = (p >> 8) & 0xff;
+        data[3] = p & 0xff;
+        data.insert(data.end(), payload.begin(), payload.end());
+
+        sha512_half_hasher h;
+        h(data.data(), data.size());
+        auto const hash = static_cast<uint256>(h);
+        return NodeObject::createObject(type, std::move(data), hash);
+    }
+
+    // A batch of objects whose hashes are those of their data
+    static Batch
+    makeBatch(int numObjects, std::uint64_t seed)
+    {
+        Batch batch;
+        for (auto const& object : createPredictableBatch(numObjects, seed))
+        {
+            batch.push_back(makeObject(
+                object->getType(), HashPrefix::leafNode, object->getData()));
+        }
+        return batch;
+    }
+
+    // The objects of a small ledger: a header, and a state map with two
+    // levels of inner nodes
+    struct Tree
+    {
+        std::shared_ptr<NodeObject> header;
+        std::shared_ptr<NodeObject> root;
+        std::shared_ptr<NodeObject> inner;
+        Batch leaves;
+
+        Batch
+        all() const
+        {
+            Batch batch{header, root, inner};
+            batch.insert(batch.end(), leaves.begin(), leaves.end());
+            return batch;
+        }
+    };
+
+    static Tree
+    makeTree()
+    {
+        beast::xor_shift_engine rng(42);
+        Tree tree;
+
+        for (int i = 0; i < 21; ++i)
+        {
+            Blob payload(rand_int(rng, 40, 200));
+            beast::rngfill(payload.data(), payload.size(), rng);
+            tree.leaves.push_back(makeObject(
+                hotACCOUNT_NODE, HashPrefix::leafNode, std::move(payload)));
+        }
+
+        auto const makeInner = [](std::vector<uint256> const& children) {
+            Blob payload(16 * uint256::bytes);
+            for (std::size_t i = 0; i < children.size(); ++i)
+                std::copy(
+                    children[i].begin(),
+                    children[i].end(),
+                    payload.begin() + i * uint256::bytes);
+            return makeObject(
+                hotACCOUNT_NODE, HashPrefix::innerNode, std::move(payload));
+        };
+
+        std::vector<uint256> children;
+        for (int i = 0; i < 16; ++i)
+            children.push_back(tree.leaves[i]->getHash());
+        tree.inner = makeInner(children);
+
+        children.clear();
+        children.push_back(tree.inner->getHash());
+        children.push_back(uint256{});
+        for (int i = 16; i < 21; ++i)
+            children.push_back(tree.leaves[i]->getHash());
+        tree.root = makeInner(children);
+
+        tree.header = makeObject(
+            hotLEDGER, HashPrefix::ledgerMaster, Blob(118, std::uint8_t{1}));
+        return tree;
+    }
+
+    void
+    testFetch()
+    {
+        testcase("fetch");
+
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+        auto const batch = makeBatch(numObjectsToTest, 1);
+        uint256 const ledgerHash{3};
+
+        {
+            // Objects added more than once are stored once
+            SnapshotWriter writer(path, 7, ledgerHash);
+            for (auto const& object : batch)
+            {
+                writer.add(
+                    object->getType(),
+                    object->getHash(),
+                    makeSlice(object->getData()));
+            }
+            for (int i = 0; i < 10; ++i)
+            {
+                writer.add(
+                    batch[i]->getType(),
+                    batch[i]->getHash(),
+                    makeSlice(batch[i]->getData()));
+            }
+            writer.finish();
+        }
+        BEAST_EXPECT(!boost::filesystem::exists(path + ".tmp"));
+
+        Snapshot const snapshot(path);
+        BEAST_EXPECT(snapshot.ledgerSeq() == 7);
+        BEAST_EXPECT(snapshot.ledgerHash() == ledgerHash);
+        BEAST_EXPECT(snapshot.size() == batch.size());
+
+        std::size_t found = 0;
+        for (auto const& object : batch)
+        {
+            if (auto const fetched = snapshot.fetch(object->getHash());
+                fetched && isSame(fetched, object))
+                ++found;
+        }
+        BEAST_EXPECT(found == batch.size());
+
+        for (auto const& object : createPredictableBatch(100, 2))
+            BEAST_EXPECT(!snapshot.fetch(object->getHash()));
+    }
+
+    void
+    testInvalid()
+    {
+        testcase("invalid");
+
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+        auto const batch = createPredictableBatch(100, 3);
+
+        auto const opens = [&path]() {
+            try
+            {
+                Snapshot const snapshot(path);
+                return true;
+            }
+            catch (std::runtime_error const&)
+            {
+                return false;
+            }
+        };
+
+        // A snapshot that was not finished is not left behind
+        {
+            SnapshotWriter writer(path, 7, uint256{3});
+            for (auto const& object : batch)
+            {
+                writer.add(
+                    object->getType(),
+                    object->getHash(),
+                    makeSlice(object->getData()));
+            }
+        }
+        BEAST_EXPECT(!boost::filesystem::exists(path));
+        BEAST_EXPECT(!boost::filesystem::exists(path + ".tmp"));
+        BEAST_EXPECT(!opens());
+
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "This is not a snapshot, but it is long enough to have "
+                    "the header of one";
+        }
+        BEAST_EXPECT(!opens());
+
+        write(path, uint256{3}, batch);
+        BEAST_EXPECT(opens());
+
+        boost::filesystem::resize_file(
+            path, boost::filesystem::file_size(path) - 1);
+        BEAST_EXPECT(!opens());
+    }
+
+    void
+    testVerify()
+    {
+        testcase("verify");
+
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+        auto const tree = makeTree();
+        std::vector<uint256> const roots{
+            tree.header->getHash(), tree.root->getHash()};
+        auto const never = []() { return false; };
+
+        write(path, tree.header->getHash(), tree.all());
+        {
+            Snapshot const snapshot(path);
+            BEAST_EXPECT(snapshot.verify(roots, never));
+            BEAST_EXPECT(!snapshot.verify(roots, []() { return true; }));
+            BEAST_EXPECT(!snapshot.verify({uint256{5}}, never));
+        }
+
+        // A leaf is missing
+        {
+            auto batch = tree.all();
+            batch.erase(batch.begin() + 5);
+            write(path, tree.header->getHash(), batch);
+            Snapshot const snapshot(path);
+            BEAST_EXPECT(!snapshot.verify(roots, never));
+        }
+
+        // An inner node is missing, so the leaves below it are unreachable
+        {
+            auto batch = tree.all();
+            batch.erase(batch.begin() + 2);
+            write(path, tree.header->getHash(), batch);
+            Snapshot const snapshot(path);
+            BEAST_EXPECT(!snapshot.verify(roots, never));
+        }
+
+        // An object is damaged
+        write(path, tree.header->getHash(), tree.all());
+        damage(path);
+        {
+            Snapshot const snapshot(path);
+            BEAST_EXPECT(!snapshot.verify(roots, never));
+        }
+    }
+
+    // Change a byte of the first object of a snapshot
+    static void
+    damage(std::string const& path)
+    {
+        std::fstream file(
+            path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put('x');
+    }
+
+    void
+    testUnverified()
+    {
+        testcase("unverified");
+
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+        auto const tree = makeTree();
+        auto const all = tree.all();
+        std::vector<uint256> const roots{
+            tree.header->getHash(), tree.root->getHash()};
+
+        // Until the snapshot is verified, a damaged object is not served
+        write(path, tree.header->getHash(), all);
+        damage(path);
+        {
+            Snapshot const snapshot(path);
+            std::size_t found = 0;
+            for (auto const& object : all)
+            {
+                if (auto const fetched = snapshot.fetch(object->getHash());
+                    fetched && isSame(fetched, object))
+                    ++found;
+            }
+            BEAST_EXPECT(found == all.size() - 1);
+        }
+
+        // A database looks for it in the backend instead
+        {
+            DummyScheduler scheduler;
+            Section params;
+            params.set("type", "memory");
+            params.set("path", dir.file("node_db"));
+            auto const db = Manager::instance().make_Database(
+                megabytes(4), scheduler, 2, params, journal_);
+            storeBatch(*db, all);
+            db->sync();
+            db->setSnapshot(std::make_shared<Snapshot const>(path));
+
+            std::size_t found = 0;
+            for (auto const& object : all)
+            {
+                if (auto const fetched = db->fetchNodeObject(object->getHash());
+                    fetched && isSame(fetched, object))
+                    ++found;
+            }
+            BEAST_EXPECT(found == all.size());
+        }
+
+        // Once verified, objects are served without being checked
+        write(path, tree.header->getHash(), all);
+        {
+            Snapshot const snapshot(path);
+            BEAST_EXPECT(snapshot.verify(roots, []() { return false; }));
+            for (auto const& object : all)
+            {
+                auto const fetched = snapshot.fetch(object->getHash());
+                BEAST_EXPECT(fetched && isSame(fetched, object));
+            }
+        }
+    }
+
+    void
+    testDatabase()
+    {
+        testcase("database");
+
+        DummyScheduler scheduler;
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+
+        // Without a cache, every fetch reaches the snapshot
+        Section params;
+        params.set("type", "memory");
+        params.set("path", dir.file("node_db"));
+        params.set("cache_size", "0");
+        params.set("cache_age", "0");
+        auto const db = Manager::instance().make_Database(
+            megabytes(4), scheduler, 2, params, journal_);
+
+        auto const batch = makeBatch(numObjectsToTest, 4);
+        write(path, uint256{3}, batch);
+        db->setSnapshot(std::make_shared<Snapshot const>(path));
+
+        // Fetched from the snapshot, both synchronously and asynchronously
+        std::size_t found = 0;
+        for (auto const& object : batch)
+        {
+            if (auto const fetched = db->fetchNodeObject(object->getHash());
+                fetched && isSame(fetched, object))
+                ++found;
+        }
+        BEAST_EXPECT(found == batch.size());
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::size_t pending = batch.size();
+        found = 0;
+        for (auto const& object : batch)
+        {
+            db->asyncFetch(
+                object->getHash(),
+                0,
+                FetchPriority::background,
+                [&, object](std::shared_ptr<NodeObject> const& fetched) {
+                    std::lock_guard lock(m);
+                    if (fetched && isSame(fetched, object))
+                        ++found;
+                    if (--pending == 0)
+                        cv.notify_all();
+                });
+        }
+        {
+            std::unique_lock lock(m);
+            cv.wait(lock, [&] { return pending == 0; });
+        }
+        BEAST_EXPECT(found == batch.size());
+
+        Json::Value counts(Json::objectValue);
+        db->getCountsJson(counts);
+        BEAST_EXPECT(
+            counts["snapshot"]["hits"] == std::to_string(2 * batch.size()));
+
+        // Objects fetched to be duplicated are stored in the backend
+        for (std::size_t i = 0; i < batch.size(); i += 2)
+            db->fetchNodeObject(
+                batch[i]->getHash(), 0, FetchType::synchronous, true);
+        db->sync();
+
+        db->setSnapshot(nullptr);
+        BEAST_EXPECT(!db->getSnapshot());
+        found = 0;
+        for (auto const& object : batch)
+        {
+            if (db->fetchNodeObject(object->getHash()))
+                ++found;
+        }
+        BEAST_EXPECT(found == batch.size() / 2);
+    }
+
+    void
+    testCache()
+    {
+        testcase("cache");
+
+        DummyScheduler scheduler;
+        beast::temp_dir dir;
+        auto const path = dir.file("ledger.snapshot");
+
+        Section params;
+        params.set("type", "memory");
+        params.set("path", dir.file("node_db"));
+        auto const db = Manager::instance().make_Database(
+            megabytes(4), scheduler, 2, params, journal_);
+
+        auto const batch = makeBatch(numObjectsToTest, 5);
+        write(path, uint256{3}, batch);
+        db->setSnapshot(std::make_shared<Snapshot const>(path));
+
+        // The cache is looked in first, and keeps what the snapshot served
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (auto const& object : batch)
+                db->fetchNodeObject(object->getHash());
+        }
+
+        Json::Value counts(Json::objectValue);
+        db->getCountsJson(counts);
+        BEAST_EXPECT(
+            counts["snapshot"]["hits"] == std::to_string(batch.size()));
+
+        db->setSnapshot(nullptr);
+        std::size_t found = 0;
+        for (auto const& object : batch)
+        {
+            if (auto const fetched = db->fetchNodeObject(object->getHash());
+                fetched && isSame(fetched, object))
+                ++found;
+        }
+        BEAST_EXPECT(found == batch.size());
+    }
+
+public:
+    void
+    run() override
+    {
+        testFetch();
+        testInvalid();
+        testVerify();
+        testUnverified();
+        testDatabase();
+        testCache();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Snapshot, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
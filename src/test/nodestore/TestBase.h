@@ -29,6 +29,10 @@
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/beast/utility/rngfill.h>
 #include <xrpl/beast/xor_shift_engine.h>
+#include <xrpl/protocol/HashPrefix.h>
+#include <xrpl/protocol/Indexes.h>
+#include <xrpl/protocol/STLedgerEntry.h>
+#include <xrpl/protocol/digest.h>
 
 #include <boost/algorithm/string.hpp>
 
@@ -118,6 +122,51 @@ public:
         return batch;
     }
 
+    // Create a predictable batch of account state leaves. Unlike random
+    // payloads, these share the structure of real ledger entries, which
+    // matters when measuring compression.
+    static Batch
+    createLedgerEntryBatch(int numObjects, std::uint64_t seed)
+    {
+        Batch batch;
+        batch.reserve(numObjects);
+
+        beast::xor_shift_engine rng(seed);
+
+        for (int i = 0; i < numObjects; ++i)
+        {
+            AccountID account;
+            beast::rngfill(account.begin(), account.size(), rng);
+            uint256 txID;
+            beast::rngfill(txID.begin(), txID.size(), rng);
+
+            STLedgerEntry sle(keylet::account(account));
+            sle.setAccountID(sfAccount, account);
+            sle.setFieldAmount(
+                sfBalance,
+                XRPAmount(rand_int(
+                    rng,
+                    std::int64_t{10'000'000},
+                    std::int64_t{1'000'000'000'000})));
+            sle.setFieldU32(sfSequence, rand_int(rng, 1, 90'000'000));
+            sle.setFieldU32(sfOwnerCount, rand_int(rng, 0, 20));
+            sle.setFieldH256(sfPreviousTxnID, txID);
+            sle.setFieldU32(sfPreviousTxnLgrSeq, rand_int(rng, 1, 90'000'000));
+
+            // The layout of a SHAMap leaf
+            Serializer s;
+            s.add32(HashPrefix::leafNode);
+            sle.add(s);
+            s.addBitString(sle.key());
+
+            auto const hash = sha512Half(s.slice());
+            batch.push_back(NodeObject::createObject(
+                hotACCOUNT_NODE, std::move(s.modData()), hash));
+        }
+
+        return batch;
+    }
+
     // Compare two batches for equality
     static bool
     areBatchesEqual(Batch const& lhs, Batch const& rhs)
@@ -22,6 +22,8 @@
 
 #include <xrpld/nodestore/DummyScheduler.h>
 #include <xrpld/nodestore/Manager.h>
+#include <xrpld/nodestore/detail/EncodedBlob.h>
+#include <xrpld/nodestore/detail/codec.h>
 
 #include <xrpl/basics/BasicConfig.h>
 #include <xrpl/basics/ByteUtilities.h>
@@ -33,6 +35,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <nudb/detail/buffer.hpp>
+
 #include <atomic>
 #include <chrono>
 #include <iterator>
@@ -670,6 +674,100 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // Compare the stored size and decoding time of the lz4 codec and the
+    // zstd codec with a trained dictionary, on account state leaves and on
+    // random payloads.
+    void
+    do_codec()
+    {
+        testcase("Codec");
+
+        auto encode = [](Batch const& batch) {
+            std::vector<Blob> blobs;
+            blobs.reserve(batch.size());
+            for (auto const& object : batch)
+            {
+                EncodedBlob const e(object);
+                auto const data = static_cast<std::uint8_t const*>(e.getData());
+                blobs.emplace_back(data, data + e.getSize());
+            }
+            return blobs;
+        };
+
+        // Train on different objects than the ones measured
+        ZstdDictionary const dictionary(
+            ZstdDictionary::train(
+                encode(TestBase::createLedgerEntryBatch(default_items, 2)),
+                kilobytes(64)),
+            3);
+
+        std::vector<std::pair<std::string, std::vector<Blob>>> const inputs = {
+            {"Leaves",
+             encode(TestBase::createLedgerEntryBatch(default_items, 1))},
+            {"Random",
+             encode(TestBase::createPredictableBatch(default_items, 1))}};
+
+        std::vector<std::pair<std::string, ZstdDictionary const*>> const
+            codecs = {{"lz4", nullptr}, {"zstd", &dictionary}};
+
+        log << std::left << std::setw(8) << "Objects" << std::setw(6)
+            << "Codec" << std::right << std::setw(12) << "Bytes/object"
+            << std::setw(12) << "Ratio" << std::setw(14) << "Decode ns"
+            << std::endl;
+
+        for (auto const& [name, blobs] : inputs)
+        {
+            std::size_t raw = 0;
+            for (auto const& blob : blobs)
+                raw += blob.size();
+
+            for (auto const& [codec, dict] : codecs)
+            {
+                std::vector<Blob> compressed;
+                compressed.reserve(blobs.size());
+                std::size_t bytes = 0;
+                for (auto const& blob : blobs)
+                {
+                    nudb::detail::buffer bf;
+                    auto const result =
+                        nodeobject_compress(blob.data(), blob.size(), bf, dict);
+                    auto const data =
+                        static_cast<std::uint8_t const*>(result.first);
+                    compressed.emplace_back(data, data + result.second);
+                    bytes += result.second;
+                }
+
+                // Take the best of several runs
+                auto best = clock_type::duration::max();
+                for (auto i = default_repeat; i--;)
+                {
+                    nudb::detail::buffer bf;
+                    std::size_t decoded = 0;
+                    auto const start = clock_type::now();
+                    for (auto const& blob : compressed)
+                        decoded += nodeobject_decompress(
+                                       blob.data(), blob.size(), bf, dict)
+                                       .second;
+                    best = std::min(best, clock_type::now() - start);
+                    BEAST_EXPECT(decoded == raw);
+                }
+
+                log << std::left << std::setw(8) << name << std::setw(6)
+                    << codec << std::right << std::fixed
+                    << std::setprecision(1) << std::setw(12)
+                    << static_cast<double>(bytes) / blobs.size()
+                    << std::setprecision(3) << std::setw(12)
+                    << static_cast<double>(bytes) / raw
+                    << std::setprecision(0) << std::setw(14)
+                    << std::chrono::duration<double, std::nano>(best).count() /
+                        blobs.size()
+                    << std::endl;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     using test_func =
         void (Timing_test::*)(Section const&, Params const&, beast::Journal);
     using test_list = std::vector<std::pair<std::string, test_func>>;
@@ -737,6 +835,8 @@ public:
     void
     run() override
     {
+        do_codec();
+
         testcase("Timing", beast::unit_test::abort_on_fail);
 
         /*  Parameters:
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/unit_test/SuiteJournal.h>
+
+#include <xrpld/nodestore/DummyScheduler.h>
+#include <xrpld/nodestore/Manager.h>
+#include <xrpld/nodestore/detail/EncodedBlob.h>
+#include <xrpld/nodestore/detail/ZstdDictionary.h>
+
+#include <xrpl/basics/BasicConfig.h>
+#include <xrpl/basics/ByteUtilities.h>
+#include <xrpl/basics/random.h>
+#include <xrpl/beast/unit_test.h>
+#include <xrpl/protocol/HashPrefix.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <fstream>
+
+namespace ripple {
+namespace NodeStore {
+
+/*  Trains a zstd dictionary for the NuDB backend on a node's own data.
+
+    The database is read once, and a uniform sample of the objects other
+    than inner nodes, which are never compressed with the dictionary, is
+    used for training.
+*/
+class dictionary_test : public beast::unit_test::suite
+{
+    static bool
+    isInnerNode(NodeObject const& object)
+    {
+        auto const& data = object.getData();
+        if (data.size() < 4)
+            return false;
+
+        auto const prefix = (std::uint32_t{data[0]} << 24) |
+            (std::uint32_t{data[1]} << 16) | (std::uint32_t{data[2]} << 8) |
+            std::uint32_t{data[3]};
+        return prefix == static_cast<std::uint32_t>(HashPrefix::innerNode);
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase(beast::unit_test::abort_on_fail) << arg();
+
+        pass();
+
+        Section config;
+        {
+            std::vector<std::string> v;
+            boost::split(v, arg(), boost::algorithm::is_any_of(","));
+            config.append(v);
+        }
+
+        if (get(config, "type").empty() || get(config, "path").empty() ||
+            get(config, "out").empty())
+        {
+            log << "Usage:\n"
+                << "--unittest-arg=type=<type>,path=<path>,out=<file>"
+                   "[,samples=<count>][,size=<bytes>]\n"
+                << "type:    Backend type of the database to sample\n"
+                << "path:    Path of the database to sample\n"
+                << "out:     File to write the dictionary to\n"
+                << "samples: Number of objects to train on (100000)\n"
+                << "size:    Maximum size of the dictionary (112640)\n"
+                << "The server must not be using the database.";
+            return;
+        }
+
+        auto const sampleCount =
+            get<std::size_t>(config, "samples", 100'000);
+        auto const maxSize = get<std::size_t>(config, "size", kilobytes(110));
+
+        DummyScheduler scheduler;
+        test::SuiteJournal journal("dictionary_test", *this);
+        auto backend = Manager::instance().make_Backend(
+            config, megabytes(4), scheduler, journal);
+        backend->open(false);
+
+        // Reservoir sampling, so that every object has the same chance of
+        // being picked whatever the size of the database.
+        std::vector<Blob> samples;
+        samples.reserve(sampleCount);
+        std::uint64_t seen = 0;
+        backend->for_each([&](std::shared_ptr<NodeObject> object) {
+            if (isInnerNode(*object))
+                return;
+
+            EncodedBlob const e(object);
+            auto const data = static_cast<std::uint8_t const*>(e.getData());
+
+            if (samples.size() < sampleCount)
+                samples.emplace_back(data, data + e.getSize());
+            else if (auto const i = rand_int<std::uint64_t>(seen);
+                     i < sampleCount)
+                samples[i].assign(data, data + e.getSize());
+
+            ++seen;
+        });
+        backend->close();
+
+        log << "Sampled " << samples.size() << " of " << seen << " objects"
+            << std::endl;
+
+        auto const dictionary = ZstdDictionary::train(samples, maxSize);
+        ZstdDictionary const check(dictionary, 3);
+
+        std::ofstream out(get(config, "out"), std::ios::binary);
+        out.write(
+            reinterpret_cast<char const*>(dictionary.data()),
+            dictionary.size());
+        out.close();
+        BEAST_EXPECT(out.good());
+
+        log << "Wrote " << dictionary.size() << " byte dictionary with id "
+            << check.id() << " to " << get(config, "out") << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(dictionary, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
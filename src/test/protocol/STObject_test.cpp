@@ -27,6 +27,8 @@
 #include <xrpl/protocol/st.h>
 
 #include <array>
+#include <chrono>
+#include <iomanip>
 #include <memory>
 #include <type_traits>
 
@@ -722,6 +724,76 @@ public:
         }
     }
 
+    void
+    testApplyTemplate()
+    {
+        testcase("apply template");
+
+        SOTemplate const elements{
+            {sfFlags, soeREQUIRED},
+            {sfSequence, soeOPTIONAL},
+            {sfExpiration, soeDEFAULT},
+            {sfAccount, soeREQUIRED},
+        };
+
+        // A free object with the fields in another order than the template
+        auto const makeObject = [](std::uint32_t expiration) {
+            STObject object(sfGeneric);
+            object.setAccountID(sfAccount, xrpAccount());
+            object.setFieldU32(sfExpiration, expiration);
+            object.setFieldU32(sfFlags, 7);
+            return object;
+        };
+
+        {
+            auto object = makeObject(3);
+            object.applyTemplate(elements);
+            BEAST_EXPECT(object.getCount() == elements.size());
+            BEAST_EXPECT(object.getFieldIndex(sfFlags) == 0);
+            BEAST_EXPECT(object.getFieldIndex(sfAccount) == 3);
+            BEAST_EXPECT(object.peekAtIndex(0).getFName() == sfFlags);
+            BEAST_EXPECT(object.peekAtIndex(1).getFName() == sfSequence);
+            BEAST_EXPECT(object.peekAtIndex(2).getFName() == sfExpiration);
+            BEAST_EXPECT(object.peekAtIndex(3).getFName() == sfAccount);
+            BEAST_EXPECT(!object.isFieldPresent(sfSequence));
+            BEAST_EXPECT(object[sfFlags] == 7);
+            BEAST_EXPECT(object[sfExpiration] == 3);
+            BEAST_EXPECT(object[sfAccount] == xrpAccount());
+            BEAST_EXPECT(!object.peekAtPField(sfAmount));
+        }
+
+        auto const fieldErr = [&](STObject& object, std::string const& what) {
+            try
+            {
+                object.applyTemplate(elements);
+                fail("applyTemplate did not throw");
+            }
+            catch (STObject::FieldErr const& e)
+            {
+                BEAST_EXPECT(e.what() == what);
+            }
+        };
+
+        {
+            // Errors found by the template come first, in its order
+            auto object = makeObject(0);
+            object.setFieldU32(sfQualityIn, 1);
+            fieldErr(
+                object,
+                "Field 'Expiration' may not be explicitly set to default.");
+        }
+        {
+            auto object = makeObject(3);
+            object.setFieldU32(sfQualityIn, 1);
+            fieldErr(object, "Field 'QualityIn' found in disallowed location.");
+        }
+        {
+            STObject object(sfGeneric);
+            object.setFieldU32(sfFlags, 7);
+            fieldErr(object, "Field 'Account' is required but missing.");
+        }
+    }
+
     void
     run() override
     {
@@ -730,6 +802,7 @@ public:
 
         testFields();
         testSerialization();
+        testApplyTemplate();
         testParseJSONArray();
         testParseJSONArrayWithInvalidChildrenObjects();
         testParseJSONEdgeCases();
@@ -737,6 +810,77 @@ public:
     }
 };
 
+// Measures how long it takes to deserialize a transaction, and to read the
+// fields of a ledger entry, in nanoseconds.
+class STObject_manual_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure(std::string const& what, std::size_t count, F&& f)
+    {
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            f();
+        auto const elapsed = std::chrono::duration<double, std::nano>(
+                                 clock_type::now() - start)
+                                 .count();
+        log << std::fixed << std::setprecision(1) << what << ": "
+            << elapsed / count << " ns" << std::endl;
+        pass();
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t const count = 200'000;
+
+        testcase("transaction deserialization");
+        {
+            STTx const payment(ttPAYMENT, [](STObject& obj) {
+                obj.setAccountID(sfAccount, xrpAccount());
+                obj.setAccountID(sfDestination, noAccount());
+                obj.setFieldAmount(sfAmount, STAmount(XRPAmount(1000)));
+                obj.setFieldAmount(sfFee, STAmount(XRPAmount(10)));
+                obj.setFieldU32(sfSequence, 1);
+                obj.setFieldU32(sfLastLedgerSequence, 100);
+                obj.setFieldVL(sfSigningPubKey, Blob(33, 2));
+                obj.setFieldVL(sfTxnSignature, Blob(72, 3));
+            });
+            Serializer s;
+            payment.add(s);
+
+            std::size_t sequences = 0;
+            measure("payment", count, [&]() {
+                STTx const tx(SerialIter{s.slice()});
+                sequences += tx.getSeqValue();
+            });
+            BEAST_EXPECT(sequences == count);
+        }
+
+        testcase("ledger entry field access");
+        {
+            STLedgerEntry sle(keylet::account(xrpAccount()));
+            sle.setAccountID(sfAccount, xrpAccount());
+            sle.setFieldAmount(sfBalance, STAmount(XRPAmount(1000)));
+            sle.setFieldU32(sfSequence, 1);
+            sle.setFieldU32(sfOwnerCount, 2);
+
+            std::uint64_t sum = 0;
+            measure("six fields", count, [&]() {
+                sum += sle[sfSequence] + sle[sfOwnerCount] + sle[sfFlags];
+                sum += sle.getFieldAmount(sfBalance).xrp().drops();
+                sum += sle[~sfRegularKey] ? 1 : 0;
+                sum += sle.isFieldPresent(sfDomain) ? 1 : 0;
+            });
+            BEAST_EXPECT(sum == count * 1003);
+        }
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(STObject, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STObject_manual, protocol, ripple);
 
 }  // namespace ripple
@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpl/basics/random.h>
+#include <xrpl/beast/unit_test.h>
+#include <xrpl/beast/utility/rngfill.h>
+#include <xrpl/protocol/digest.h>
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+using detail::sha512_engine;
+
+constexpr std::array engines{
+    sha512_engine::openssl,
+    sha512_engine::avx2,
+    sha512_engine::avx512};
+
+// Random messages with the given sizes, stored back to back
+struct Messages
+{
+    std::vector<std::uint8_t> data;
+    std::vector<Slice> slices;
+
+    Messages(std::vector<std::size_t> const& sizes)
+    {
+        std::size_t total = 0;
+        for (auto const size : sizes)
+            total += size;
+
+        data.resize(total);
+        beast::rngfill(data.data(), data.size(), default_prng());
+
+        std::size_t offset = 0;
+        for (auto const size : sizes)
+        {
+            slices.emplace_back(data.data() + offset, size);
+            offset += size;
+        }
+    }
+};
+
+}  // namespace
+
+class digest_test : public beast::unit_test::suite
+{
+    // Checks a batch against hashing each message with sha512Half
+    void
+    check(sha512_engine engine, std::vector<Slice> const& messages)
+    {
+        std::vector<uint256> digests(messages.size());
+        detail::sha512HalfBatch(engine, messages, digests);
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < messages.size(); ++i)
+        {
+            if (digests[i] != sha512Half(messages[i]))
+                ++mismatches;
+        }
+        BEAST_EXPECTS(mismatches == 0, detail::to_string(engine));
+    }
+
+    void
+    testKnownAnswer()
+    {
+        testcase("known answer");
+
+        // The first half of SHA-512("abc") from FIPS 180-2
+        uint256 const expected{
+            "DDAF35A193617ABACC417349AE20413112E6FA4E89A97EA20A9EEEE64B55D39A"};
+        std::string const abc = "abc";
+
+        BEAST_EXPECT(sha512Half(makeSlice(abc)) == expected);
+
+        for (auto const engine : engines)
+        {
+            if (!detail::sha512EngineSupported(engine))
+                continue;
+
+            std::vector<Slice> const messages(9, makeSlice(abc));
+            std::vector<uint256> digests(messages.size());
+            detail::sha512HalfBatch(engine, messages, digests);
+            for (auto const& digest : digests)
+                BEAST_EXPECTS(digest == expected, detail::to_string(engine));
+        }
+    }
+
+    void
+    testSizes()
+    {
+        testcase("message sizes");
+
+        // Every size up to three blocks, which covers the messages that
+        // need one or two padding blocks, in one mixed batch.
+        std::vector<std::size_t> sizes(3 * 128 + 1);
+        std::iota(sizes.begin(), sizes.end(), 0);
+        Messages const messages(sizes);
+
+        for (auto const engine : engines)
+        {
+            if (detail::sha512EngineSupported(engine))
+                check(engine, messages.slices);
+        }
+    }
+
+    void
+    testBatchSizes()
+    {
+        testcase("batch sizes");
+
+        // Batches that do not fill the lanes, or leave some lanes idle at
+        // the end, of inner node sized messages.
+        for (std::size_t count = 0; count <= 17; ++count)
+        {
+            Messages const messages(std::vector<std::size_t>(count, 516));
+
+            for (auto const engine : engines)
+            {
+                if (detail::sha512EngineSupported(engine))
+                    check(engine, messages.slices);
+            }
+
+            std::vector<uint256> digests(count);
+            sha512HalfBatch(messages.slices, digests);
+            for (std::size_t i = 0; i < count; ++i)
+                BEAST_EXPECT(digests[i] == sha512Half(messages.slices[i]));
+        }
+    }
+
+    void
+    testSupported()
+    {
+        testcase("supported engines");
+
+        BEAST_EXPECT(detail::sha512EngineSupported(sha512_engine::openssl));
+        for (auto const engine : engines)
+        {
+            log << detail::to_string(engine) << ": "
+                << (detail::sha512EngineSupported(engine) ? "supported"
+                                                          : "not supported")
+                << std::endl;
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testSupported();
+        testKnownAnswer();
+        testSizes();
+        testBatchSizes();
+    }
+};
+
+// Compares the throughput of the batched engines with hashing one message
+// at a time through OpenSSL, for inner node and typical leaf sized
+// messages.
+class digest_manual_test : public beast::unit_test::suite
+{
+    void
+    measure(std::string const& name, std::size_t size)
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        testcase(name);
+
+        std::size_t const count = 200'000;
+        Messages const messages(std::vector<std::size_t>(count, size));
+        std::vector<uint256> digests(count);
+
+        auto report = [&](std::string const& engine, auto elapsed) {
+            auto const seconds =
+                std::chrono::duration<double>(elapsed).count();
+            log << std::setw(8) << engine << ": " << std::fixed
+                << std::setprecision(0) << count / seconds << " hashes/s, "
+                << std::setprecision(1)
+                << count * size / seconds / (1024 * 1024) << " MiB/s"
+                << std::endl;
+        };
+
+        {
+            auto const start = clock_type::now();
+            for (std::size_t i = 0; i < count; ++i)
+                digests[i] = sha512Half(messages.slices[i]);
+            report("single", clock_type::now() - start);
+        }
+
+        for (auto const engine : engines)
+        {
+            if (!detail::sha512EngineSupported(engine))
+                continue;
+
+            std::vector<uint256> batched(count);
+            auto const start = clock_type::now();
+            detail::sha512HalfBatch(engine, messages.slices, batched);
+            report(detail::to_string(engine), clock_type::now() - start);
+            BEAST_EXPECT(batched == digests);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        measure("inner node (516 bytes)", 516);
+        measure("account state leaf (160 bytes)", 160);
+        measure("transaction (300 bytes)", 300);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(digest, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(digest_manual, protocol, ripple);
+
+}  // namespace ripple
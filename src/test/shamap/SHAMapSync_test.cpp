@@ -20,6 +20,8 @@
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
 
+#include <xrpld/nodestore/Backend.h>
+#include <xrpld/nodestore/Factory.h>
 #include <xrpld/shamap/SHAMap.h>
 #include <xrpld/shamap/SHAMapItem.h>
 
@@ -27,6 +29,9 @@
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/beast/xor_shift_engine.h>
 
+#include <chrono>
+#include <thread>
+
 namespace ripple {
 namespace tests {
 
@@ -86,8 +91,10 @@ public:
     }
 
     void
-    run() override
+    testSync()
     {
+        testcase("sync");
+
         using namespace beast::severities;
         test::SuiteJournal journal("SHAMapSync_test", *this);
 
@@ -186,9 +193,290 @@ public:
 
         destination.invariants();
     }
+
+    void
+    testLocalStore()
+    {
+        testcase("local store");
+
+        test::SuiteJournal journal("SHAMapSync_test", *this);
+
+        // Few reads in flight, so that the walk waits on them often
+        Section config;
+        config.set("type", "memory");
+        config.set("path", "SHAMapSync_test");
+        config.set("sync_reads", "4");
+
+        // A ledger we had before a restart
+        TestNodeFamily f(journal, config, 2);
+        SHAMap stored(SHAMapType::FREE, f);
+        for (int i = 0; i < 5000; ++i)
+            stored.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeRandomAS());
+        stored.flushDirty(hotACCOUNT_NODE);
+        stored.setImmutable();
+
+        // The ledger the network has moved on to
+        auto source = stored.snapShot(true);
+        for (int i = 0; i < 200; ++i)
+            source->addItem(SHAMapNodeType::tnACCOUNT_STATE, makeRandomAS());
+        auto const hash = source->getHash();
+        source->setImmutable();
+
+        int sourceNodes = 0;
+        source->visitNodes([&sourceNodes](auto const&) {
+            ++sourceNodes;
+            return true;
+        });
+
+        TestNodeFamily f2(journal, config, 2);
+        SHAMap destination(SHAMapType::FREE, f2);
+        destination.setSynching();
+
+        {
+            std::vector<std::pair<SHAMapNodeID, Blob>> a;
+            BEAST_EXPECT(source->getNodeFat(SHAMapNodeID(), a, false, 0));
+            BEAST_EXPECT(destination
+                             .addRootNode(hash, makeSlice(a[0].second), nullptr)
+                             .isGood());
+        }
+
+        // Only the nodes that changed should have to come from the network
+        int received = 0;
+        while (true)
+        {
+            auto const nodesMissing = destination.getMissingNodes(256, nullptr);
+            if (nodesMissing.empty())
+                break;
+
+            std::vector<std::pair<SHAMapNodeID, Blob>> b;
+            for (auto const& [nodeID, hash] : nodesMissing)
+            {
+                if (!source->getNodeFat(nodeID, b, false, 0))
+                    fail("", __FILE__, __LINE__);
+            }
+
+            for (auto const& [nodeID, blob] : b)
+            {
+                if (!destination.addKnownNode(nodeID, makeSlice(blob), nullptr)
+                         .isUseful())
+                    fail("", __FILE__, __LINE__);
+            }
+            received += b.size();
+        }
+
+        BEAST_EXPECT(source->deepCompare(destination));
+        BEAST_EXPECT(received > 0);
+        BEAST_EXPECT(received < sourceNodes / 2);
+        destination.invariants();
+    }
+
+    void
+    run() override
+    {
+        testSync();
+        testLocalStore();
+    }
+};
+
+/** A memory backend that takes a fixed time for each read, as a disk
+    would. A batch of reads takes no longer than a single read, as with a
+    device that serves many requests at once.
+*/
+class SlowBackend : public NodeStore::Backend
+{
+    std::unique_ptr<NodeStore::Backend> const backend_;
+    std::chrono::microseconds const latency_;
+
+public:
+    SlowBackend(
+        std::unique_ptr<NodeStore::Backend> backend,
+        std::chrono::microseconds latency)
+        : backend_(std::move(backend)), latency_(latency)
+    {
+    }
+
+    std::string
+    getName() override
+    {
+        return backend_->getName();
+    }
+
+    void
+    open(bool createIfMissing) override
+    {
+        backend_->open(createIfMissing);
+    }
+
+    bool
+    isOpen() override
+    {
+        return backend_->isOpen();
+    }
+
+    void
+    close() override
+    {
+        backend_->close();
+    }
+
+    NodeStore::Status
+    fetch(void const* key, std::shared_ptr<NodeObject>* pObject) override
+    {
+        std::this_thread::sleep_for(latency_);
+        return backend_->fetch(key, pObject);
+    }
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, NodeStore::Status>
+    fetchBatch(std::vector<uint256 const*> const& hashes) override
+    {
+        std::this_thread::sleep_for(latency_);
+        return backend_->fetchBatch(hashes);
+    }
+
+    void
+    store(std::shared_ptr<NodeObject> const& object) override
+    {
+        backend_->store(object);
+    }
+
+    void
+    storeBatch(NodeStore::Batch const& batch) override
+    {
+        backend_->storeBatch(batch);
+    }
+
+    void
+    sync() override
+    {
+    }
+
+    void
+    for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
+    {
+        backend_->for_each(std::move(f));
+    }
+
+    int
+    getWriteLoad() override
+    {
+        return 0;
+    }
+
+    void
+    setDeletePath() override
+    {
+    }
+
+    int
+    fdRequired() const override
+    {
+        return 0;
+    }
+};
+
+class SlowFactory : public NodeStore::Factory
+{
+public:
+    SlowFactory()
+    {
+        NodeStore::Manager::instance().insert(*this);
+    }
+
+    ~SlowFactory() override
+    {
+        NodeStore::Manager::instance().erase(*this);
+    }
+
+    std::string
+    getName() const override
+    {
+        return "SlowMemory";
+    }
+
+    std::unique_ptr<NodeStore::Backend>
+    createInstance(
+        size_t,
+        Section const& parameters,
+        std::size_t burstSize,
+        NodeStore::Scheduler& scheduler,
+        beast::Journal journal) override
+    {
+        Section memory(parameters);
+        memory.set("type", "memory");
+        return std::make_unique<SlowBackend>(
+            NodeStore::Manager::instance().make_Backend(
+                memory, burstSize, scheduler, journal),
+            std::chrono::microseconds(
+                get<int>(parameters, "latency_us", 100)));
+    }
+};
+
+// Times finding the missing nodes of a large map that is all in a slow
+// local store, as after a restart, for several numbers of reads in flight.
+// The number of items can be set with --unittest-arg=<items>.
+class SHAMapSync_manual_test : public beast::unit_test::suite
+{
+    beast::xor_shift_engine eng_;
+
+public:
+    void
+    run() override
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        SlowFactory factory;
+        beast::Journal const journal{beast::Journal::getNullSink()};
+
+        int const items = arg().empty() ? 100'000 : std::stoi(arg());
+
+        Section config;
+        config.set("type", "SlowMemory");
+        config.set("path", "SHAMapSync_manual");
+        config.set("latency_us", "1000");
+
+        SHAMapHash hash;
+        {
+            TestNodeFamily f(journal, config, 4);
+            SHAMap source(SHAMapType::FREE, f);
+            for (int i = 0; i < items; ++i)
+            {
+                Serializer s;
+                for (int d = 0; d < 3; ++d)
+                    s.add32(rand_int<std::uint32_t>(eng_));
+                source.addItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    make_shamapitem(s.getSHA512Half(), s.slice()));
+            }
+            source.flushDirty(hotACCOUNT_NODE);
+            hash = source.getHash();
+        }
+
+        for (int const reads : {16, 64, 256, 1024})
+        {
+            testcase(std::to_string(reads) + " reads in flight");
+
+            config.set("sync_reads", std::to_string(reads));
+            TestNodeFamily f(journal, config, 4);
+            SHAMap destination(SHAMapType::FREE, f);
+            destination.setSynching();
+            BEAST_EXPECT(destination.fetchRoot(hash, nullptr));
+
+            auto const start = clock_type::now();
+            auto const missing = destination.getMissingNodes(2048, nullptr);
+            auto const elapsed = clock_type::now() - start;
+            BEAST_EXPECT(missing.empty());
+
+            log << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       elapsed)
+                       .count()
+                << "ms, " << f.db().getFetchTotalCount() << " reads"
+                << std::endl;
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(SHAMapSync, shamap, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapSync_manual, shamap, ripple);
 
 }  // namespace tests
 }  // namespace ripple
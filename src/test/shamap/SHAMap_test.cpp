@@ -17,15 +17,22 @@
 */
 //==============================================================================
 
+#include <test/jtx/Env.h>
+#include <test/jtx/envconfig.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
 
+#include <xrpld/core/JobQueue.h>
 #include <xrpld/shamap/SHAMap.h>
 
 #include <xrpl/basics/Blob.h>
 #include <xrpl/basics/Buffer.h>
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/beast/utility/Journal.h>
+#include <xrpl/protocol/digest.h>
+
+#include <chrono>
+#include <set>
 
 namespace ripple {
 namespace tests {
@@ -105,6 +112,29 @@ operator!=(SHAMapItem const& a, uint256 const& b)
     return a.key() != b;
 }
 
+// Deterministic account state leaves for the flush tests. The contents of
+// leaf `i` depend on `version`, so bumping it simulates a modified entry.
+static void
+setItems(
+    SHAMap& map,
+    std::uint32_t begin,
+    std::uint32_t end,
+    std::uint32_t step = 1,
+    std::uint32_t version = 0)
+{
+    for (auto i = begin; i < end; i += step)
+    {
+        auto const key = sha512Half(i);
+        auto const data = sha512Half(key, version);
+        auto item = make_shamapitem(key, Slice{data.data(), data.size()});
+        if (version == 0)
+            map.addGiveItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(item));
+        else
+            map.updateGiveItem(
+                SHAMapNodeType::tnACCOUNT_STATE, std::move(item));
+    }
+}
+
 class SHAMap_test : public beast::unit_test::suite
 {
 public:
@@ -124,6 +154,112 @@ public:
 
         run(true, journal);
         run(false, journal);
+        testParallelFlush(journal);
+        testSplitNodes(journal);
+    }
+
+    void
+    testParallelFlush(beast::Journal const& journal)
+    {
+        testcase("parallel flush");
+
+        auto cfg = test::jtx::envconfig();
+        cfg->FORCE_MULTI_THREAD = true;
+        test::jtx::Env env{*this, std::move(cfg)};
+        JobQueue& jobQueue = env.app().getJobQueue();
+
+        for (unsigned int const threads : {2u, 4u, 16u})
+        {
+            tests::TestNodeFamily f(journal);
+            SHAMap serial(SHAMapType::STATE, f);
+            SHAMap parallel(SHAMapType::STATE, f);
+
+            setItems(serial, 0, 5000);
+            setItems(parallel, 0, 5000);
+
+            int const serialFlushed = serial.flushDirty(hotACCOUNT_NODE);
+            BEAST_EXPECT(
+                parallel.flushDirty(hotACCOUNT_NODE, jobQueue, threads) ==
+                serialFlushed);
+            BEAST_EXPECT(parallel.getHash() == serial.getHash());
+            parallel.invariants();
+
+            // Nothing is left to flush
+            BEAST_EXPECT(
+                parallel.flushDirty(hotACCOUNT_NODE, jobQueue, threads) == 0);
+
+            // Modify, add and remove some leaves of mutable snapshots, as
+            // when building the next ledger, and flush those.
+            auto serialNext = serial.snapShot(true);
+            auto parallelNext = parallel.snapShot(true);
+            for (auto& map : {serialNext, parallelNext})
+            {
+                setItems(*map, 0, 5000, 7, 1);
+                setItems(*map, 5000, 5100);
+                for (std::uint32_t i = 1; i < 5000; i += 101)
+                    map->delItem(sha512Half(i));
+            }
+
+            BEAST_EXPECT(
+                parallelNext->flushDirty(hotACCOUNT_NODE, jobQueue, threads) ==
+                serialNext->flushDirty(hotACCOUNT_NODE));
+            BEAST_EXPECT(parallelNext->getHash() == serialNext->getHash());
+            BEAST_EXPECT(parallel.getHash() == serial.getHash());
+            parallelNext->invariants();
+
+            // Every node of the flushed map made it to the database
+            std::size_t missing = 0;
+            parallelNext->visitNodes([&](SHAMapTreeNode& node) {
+                if (!f.db().fetchNodeObject(node.getHash().as_uint256(), 0))
+                    ++missing;
+                return true;
+            });
+            BEAST_EXPECT(missing == 0);
+        }
+    }
+
+    void
+    testSplitNodes(beast::Journal const& journal)
+    {
+        testcase("split nodes");
+
+        tests::TestNodeFamily f(journal);
+        SHAMap map(SHAMapType::STATE, f);
+        setItems(map, 0, 5000);
+        map.flushDirty(hotACCOUNT_NODE);
+        map.setImmutable();
+
+        std::set<uint256> all;
+        map.visitNodes([&](SHAMapTreeNode& node) {
+            all.insert(node.getHash().as_uint256());
+            return true;
+        });
+
+        for (int const depth : {0, 1, 2, 3})
+        {
+            // The nodes above the subtrees and the nodes of every subtree
+            // together are the nodes of the map, each visited once.
+            std::set<uint256> seen;
+            std::size_t visits = 0;
+            auto const visit = [&](SHAMapTreeNode& node) {
+                seen.insert(node.getHash().as_uint256());
+                ++visits;
+                return true;
+            };
+
+            auto const subtrees = map.splitNodes(depth, visit);
+            BEAST_EXPECT(!subtrees.empty());
+            BEAST_EXPECT(subtrees.size() <= (1u << (4 * depth)));
+            for (auto const& subtree : subtrees)
+                map.visitNodes(subtree, visit);
+
+            BEAST_EXPECT(seen == all);
+            BEAST_EXPECT(visits == all.size());
+        }
+
+        // Stopping on the root yields nothing to visit
+        BEAST_EXPECT(
+            map.splitNodes(2, [](SHAMapTreeNode&) { return false; }).empty());
     }
 
     void
@@ -402,7 +538,81 @@ class SHAMapPathProof_test : public beast::unit_test::suite
     }
 };
 
+// Measures the latency of flushing a large state map, both when it is
+// written for the first time and after a ledger's worth of modifications,
+// for several flush thread counts.
+class SHAMapFlush_test : public beast::unit_test::suite
+{
+    // Number of leaves in the state map
+    static constexpr std::uint32_t leafCount = 1'000'000;
+
+    // Every closeStep'th leaf is modified for the simulated ledger close
+    static constexpr std::uint32_t closeStep = 100;
+
+    template <class Duration>
+    static std::string
+    toMs(Duration d)
+    {
+        return std::to_string(
+                   std::chrono::duration_cast<std::chrono::microseconds>(d)
+                       .count() /
+                   1000.0) +
+            "ms";
+    }
+
+public:
+    void
+    run() override
+    {
+        using clock_type = std::chrono::steady_clock;
+        test::SuiteJournal journal("SHAMapFlush_test", *this);
+
+        auto cfg = test::jtx::envconfig();
+        cfg->FORCE_MULTI_THREAD = true;
+        test::jtx::Env env{*this, std::move(cfg)};
+        JobQueue& jobQueue = env.app().getJobQueue();
+
+        std::optional<SHAMapHash> fullHash;
+        std::optional<SHAMapHash> closeHash;
+
+        for (unsigned int const threads : {1u, 4u, 16u})
+        {
+            testcase(std::to_string(threads) + " flush threads");
+
+            tests::TestNodeFamily f(journal);
+            SHAMap map(SHAMapType::STATE, f);
+            setItems(map, 0, leafCount);
+
+            auto start = clock_type::now();
+            int const fullFlushed =
+                map.flushDirty(hotACCOUNT_NODE, jobQueue, threads);
+            auto const fullElapsed = clock_type::now() - start;
+
+            auto next = map.snapShot(true);
+            setItems(*next, 0, leafCount, closeStep, 1);
+
+            start = clock_type::now();
+            int const closeFlushed =
+                next->flushDirty(hotACCOUNT_NODE, jobQueue, threads);
+            auto const closeElapsed = clock_type::now() - start;
+
+            log << threads << " threads: full flush of " << fullFlushed
+                << " nodes in " << toMs(fullElapsed) << ", close flush of "
+                << closeFlushed << " nodes in " << toMs(closeElapsed)
+                << std::endl;
+
+            if (!fullHash)
+                fullHash = map.getHash();
+            if (!closeHash)
+                closeHash = next->getHash();
+            BEAST_EXPECT(map.getHash() == *fullHash);
+            BEAST_EXPECT(next->getHash() == *closeHash);
+        }
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(SHAMap, ripple_app, ripple);
 BEAST_DEFINE_TESTSUITE(SHAMapPathProof, ripple_app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapFlush, ripple_app, ripple);
 }  // namespace tests
 }  // namespace ripple
@@ -42,8 +42,21 @@ private:
 
     beast::Journal const j_;
 
+    static Section
+    memorySection()
+    {
+        Section section;
+        section.set("type", "memory");
+        section.set("path", "SHAMap_test");
+        return section;
+    }
+
 public:
-    TestNodeFamily(beast::Journal j)
+    TestNodeFamily(beast::Journal j) : TestNodeFamily(j, memorySection(), 1)
+    {
+    }
+
+    TestNodeFamily(beast::Journal j, Section const& config, int readThreads)
         : fbCache_(std::make_shared<FullBelowCache>(
               "App family full below cache",
               clock_,
@@ -56,11 +69,8 @@ public:
               j))
         , j_(j)
     {
-        Section testSection;
-        testSection.set("type", "memory");
-        testSection.set("path", "SHAMap_test");
         db_ = NodeStore::Manager::instance().make_Database(
-            megabytes(4), scheduler_, 1, testSection, j);
+            megabytes(4), scheduler_, readThreads, config, j);
     }
 
     NodeStore::Database&
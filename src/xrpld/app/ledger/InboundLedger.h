@@ -173,6 +173,10 @@ private:
     std::vector<uint256>
     neededStateHashes(int max, SHAMapSyncFilter* filter) const;
 
+    // How urgently the node store should service our reads
+    NodeStore::FetchPriority
+    fetchPriority() const;
+
     clock_type& m_clock;
     clock_type::time_point mLastAction;
 
@@ -29,6 +29,7 @@
 #include <xrpld/core/JobQueue.h>
 #include <xrpld/core/SociDB.h>
 #include <xrpld/nodestore/Database.h>
+#include <xrpld/nodestore/Snapshot.h>
 #include <xrpld/nodestore/detail/DatabaseNodeImp.h>
 
 #include <xrpl/basics/Log.h>
@@ -1138,4 +1139,54 @@ loadByHash(uint256 const& ledgerHash, Application& app, bool acquire)
     return {};
 }
 
+void
+writeSnapshot(Ledger const& ledger, std::string const& path)
+{
+    auto const& info = ledger.info();
+    NodeStore::SnapshotWriter writer(path, info.seq, info.hash);
+
+    {
+        Serializer s(128);
+        s.add32(HashPrefix::ledgerMaster);
+        addRaw(info, s);
+        writer.add(hotLEDGER, info.hash, s.slice());
+    }
+
+    auto const add = [&writer](NodeObjectType type) {
+        return [&writer, type](SHAMapTreeNode& node) {
+            // An empty map has nothing to store
+            if (node.getHash().isZero())
+                return true;
+
+            Serializer s;
+            node.serializeWithPrefix(s);
+            writer.add(type, node.getHash().as_uint256(), s.slice());
+            return true;
+        };
+    };
+    ledger.stateMap().visitNodes(add(hotACCOUNT_NODE));
+    ledger.txMap().visitNodes(add(hotTRANSACTION_NODE));
+
+    writer.finish();
+}
+
+bool
+verifySnapshot(
+    NodeStore::Snapshot const& snapshot,
+    Ledger const& ledger,
+    std::function<bool()> const& stopping)
+{
+    auto const& info = ledger.info();
+    if (snapshot.ledgerHash() != info.hash)
+        return false;
+
+    std::vector<uint256> roots{info.hash};
+    if (info.accountHash.isNonZero())
+        roots.push_back(info.accountHash);
+    if (info.txHash.isNonZero())
+        roots.push_back(info.txHash);
+
+    return snapshot.verify(roots, stopping);
+}
+
 }  // namespace ripple
@@ -41,6 +41,10 @@ class TransactionMaster;
 
 class SqliteStatement;
 
+namespace NodeStore {
+class Snapshot;
+}
+
 struct create_genesis_t
 {
     explicit create_genesis_t() = default;
@@ -454,6 +458,28 @@ loadByHash(uint256 const& ledgerHash, Application& app, bool acquire = true);
 extern std::tuple<std::shared_ptr<Ledger>, std::uint32_t, uint256>
 getLatestLedger(Application& app);
 
+/** Write the header and the state and transaction maps of a ledger to a
+    snapshot file, replacing any snapshot already there.
+
+    Throw:
+
+        SHAMapMissingNode if the ledger is not complete, or
+        std::runtime_error if the file can not be written.
+*/
+void
+writeSnapshot(Ledger const& ledger, std::string const& path);
+
+/** Returns true if the snapshot holds the whole of the ledger, intact.
+
+    @param stopping Polled while checking, which gives up once it returns
+                    true.
+*/
+bool
+verifySnapshot(
+    NodeStore::Snapshot const& snapshot,
+    Ledger const& ledger,
+    std::function<bool()> const& stopping);
+
 /** Deserialize a SHAMapItem containing a single STTx
 
     Throw:
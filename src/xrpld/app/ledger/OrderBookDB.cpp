@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <xrpld/app/ledger/AcceptedLedger.h>
 #include <xrpld/app/ledger/LedgerMaster.h>
 #include <xrpld/app/ledger/OrderBookDB.h>
 #include <xrpld/app/main/Application.h>
@@ -28,8 +29,107 @@
 #include <xrpl/basics/Log.h>
 #include <xrpl/protocol/Indexes.h>
 
+#include <array>
+
 namespace ripple {
 
+namespace {
+
+// The number of published ledgers whose changes are kept while a full
+// update runs
+constexpr std::size_t recentLedgers = 1024;
+
+// The book a directory is the root of, if it is a book directory root. The
+// directory may be a ledger entry, or its fields in metadata, from which
+// fields with default values are left out.
+std::optional<Book>
+getBookOfRoot(STObject const& dir, uint256 const& key)
+{
+    if (!dir.isFieldPresent(sfExchangeRate) || dir[~sfRootIndex] != key)
+        return std::nullopt;
+
+    Book book;
+    book.in.currency = dir[~sfTakerPaysCurrency].value_or(beast::zero);
+    book.in.account = dir[~sfTakerPaysIssuer].value_or(beast::zero);
+    book.out.currency = dir[~sfTakerGetsCurrency].value_or(beast::zero);
+    book.out.account = dir[~sfTakerGetsIssuer].value_or(beast::zero);
+    book.domain = dir[~sfDomainID];
+    return book;
+}
+
+// The two books an AMM makes
+std::array<Book, 2>
+getBooksOfAMM(STObject const& amm)
+{
+    auto const issue1 = amm[~sfAsset].value_or(xrpIssue()).get<Issue>();
+    auto const issue2 = amm[~sfAsset2].value_or(xrpIssue()).get<Issue>();
+    return {
+        Book{issue1, issue2, std::nullopt}, Book{issue2, issue1, std::nullopt}};
+}
+
+}  // namespace
+
+void
+OrderBookDB::Books::insert(Book const& book)
+{
+    if (book.domain)
+        domain[{book.in, *book.domain}].insert(book.out);
+    else
+        all[book.in].insert(book.out);
+
+    if (book.domain && isXRP(book.out))
+        xrpDomain.insert({book.in, *book.domain});
+    else if (isXRP(book.out))
+        xrp.insert(book.in);
+}
+
+void
+OrderBookDB::Books::add(Book const& book)
+{
+    if (++refs[book] == 1)
+        insert(book);
+}
+
+bool
+OrderBookDB::Books::remove(Book const& book)
+{
+    auto const ref = refs.find(book);
+    if (ref == refs.end())
+        return false;
+
+    if (--ref->second != 0)
+        return true;
+    refs.erase(ref);
+    erase(book);
+    return true;
+}
+
+void
+OrderBookDB::Books::erase(Book const& book)
+{
+    auto const eraseFrom = [&book](auto& container, auto const& key) {
+        if (auto it = container.find(key); it != container.end())
+        {
+            it->second.erase(book.out);
+            if (it->second.empty())
+                container.erase(it);
+        }
+    };
+
+    if (book.domain)
+    {
+        eraseFrom(domain, std::make_pair(book.in, *book.domain));
+        if (isXRP(book.out))
+            xrpDomain.erase({book.in, *book.domain});
+    }
+    else
+    {
+        eraseFrom(all, book.in);
+        if (isXRP(book.out))
+            xrp.erase(book.in);
+    }
+}
+
 OrderBookDB::OrderBookDB(Application& app)
     : app_(app), seq_(0), j_(app.journal("OrderBookDB"))
 {
@@ -44,6 +144,13 @@ OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
+    {
+        // Published ledgers keep the books current
+        std::lock_guard sl(mLock);
+        if (booksSeq_ != 0)
+            return;
+    }
+
     auto seq = seq_.load();
 
     if (seq != 0)
@@ -87,13 +194,13 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
-    decltype(allBooks_) allBooks;
-    decltype(xrpBooks_) xrpBooks;
-    decltype(domainBooks_) domainBooks;
-    decltype(xrpDomainBooks_) xrpDomainBooks;
-
-    allBooks.reserve(allBooks_.size());
-    xrpBooks.reserve(xrpBooks_.size());
+    Books books;
+    {
+        std::lock_guard sl(mLock);
+        books.all.reserve(books_.all.size());
+        books.xrp.reserve(books_.xrp.size());
+        books.refs.reserve(books_.refs.size());
+    }
 
     JLOG(j_.debug()) << "Beginning update (" << ledger->seq() << ")";
 
@@ -112,44 +219,21 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
                 return;
             }
 
-            if (sle->getType() == ltDIR_NODE &&
-                sle->isFieldPresent(sfExchangeRate) &&
-                sle->getFieldH256(sfRootIndex) == sle->key())
+            if (sle->getType() == ltDIR_NODE)
             {
-                Book book;
-
-                book.in.currency = sle->getFieldH160(sfTakerPaysCurrency);
-                book.in.account = sle->getFieldH160(sfTakerPaysIssuer);
-                book.out.currency = sle->getFieldH160(sfTakerGetsCurrency);
-                book.out.account = sle->getFieldH160(sfTakerGetsIssuer);
-                book.domain = (*sle)[~sfDomainID];
-
-                if (book.domain)
-                    domainBooks_[{book.in, *book.domain}].insert(book.out);
-                else
-                    allBooks[book.in].insert(book.out);
-
-                if (book.domain && isXRP(book.out))
-                    xrpDomainBooks.insert({book.in, *book.domain});
-                else if (isXRP(book.out))
-                    xrpBooks.insert(book.in);
-
-                ++cnt;
+                if (auto const book = getBookOfRoot(*sle, sle->key()))
+                {
+                    books.add(*book);
+                    ++cnt;
+                }
             }
             else if (sle->getType() == ltAMM)
             {
-                auto const issue1 = (*sle)[sfAsset].get<Issue>();
-                auto const issue2 = (*sle)[sfAsset2].get<Issue>();
-                auto addBook = [&](Issue const& in, Issue const& out) {
-                    allBooks[in].insert(out);
-
-                    if (isXRP(out))
-                        xrpBooks.insert(in);
-
+                for (auto const& book : getBooksOfAMM(*sle))
+                {
+                    books.add(book);
                     ++cnt;
-                };
-                addBook(issue1, issue2);
-                addBook(issue2, issue1);
+                }
             }
         }
     }
@@ -166,31 +250,156 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
 
     {
         std::lock_guard sl(mLock);
-        allBooks_.swap(allBooks);
-        xrpBooks_.swap(xrpBooks);
-        domainBooks_.swap(domainBooks);
-        xrpDomainBooks_.swap(xrpDomainBooks);
+        books_ = std::move(books);
+
+        // Catch up with the ledgers published during the scan
+        booksSeq_ = ledger->seq();
+        for (auto it = recent_.upper_bound(booksSeq_);
+             it != recent_.end() && it->first == booksSeq_ + 1;
+             ++it)
+        {
+            applyChanges(it->second);
+            booksSeq_ = it->first;
+        }
+
+        // The scan did not see the books of later ledgers' transactions
+        for (auto const& [book, seq] : provisional_)
+            books_.insert(book);
+        expireBooks();
+
+        JLOG(j_.debug()) << "Books current as of " << booksSeq_;
     }
 
     app_.getLedgerMaster().newOrderBookDB();
 }
 
+OrderBookDB::Changes
+OrderBookDB::getChanges(AcceptedLedger const& accepted)
+{
+    Changes changes;
+
+    for (auto const& tx : accepted)
+    {
+        for (auto const& node : tx->getMeta().getNodes())
+        {
+            bool const created = node.getFName() == sfCreatedNode;
+            if (!created && node.getFName() != sfDeletedNode)
+                continue;
+
+            auto const type = node.getFieldU16(sfLedgerEntryType);
+            if (type != ltDIR_NODE && type != ltAMM)
+                continue;
+
+            auto const fields = dynamic_cast<STObject const*>(
+                node.peekAtPField(created ? sfNewFields : sfFinalFields));
+            if (!fields)
+                continue;
+
+            if (type == ltDIR_NODE)
+            {
+                if (auto const book =
+                        getBookOfRoot(*fields, node[sfLedgerIndex]))
+                    changes.emplace_back(*book, created);
+            }
+            else
+            {
+                for (auto const& book : getBooksOfAMM(*fields))
+                    changes.emplace_back(book, created);
+            }
+        }
+    }
+
+    return changes;
+}
+
 void
-OrderBookDB::addOrderBook(Book const& book)
+OrderBookDB::applyChanges(Changes const& changes)
 {
-    bool toXRP = isXRP(book.out);
+    for (auto const& [book, created] : changes)
+    {
+        if (created)
+            books_.add(book);
+        else if (!books_.remove(book))
+            JLOG(j_.warn()) << "Book removed but not known: " << book;
+    }
+}
 
-    std::lock_guard sl(mLock);
+void
+OrderBookDB::expireBooks()
+{
+    for (auto it = provisional_.begin(); it != provisional_.end();)
+    {
+        if (it->second > booksSeq_)
+        {
+            ++it;
+            continue;
+        }
 
-    if (book.domain)
-        domainBooks_[{book.in, *book.domain}].insert(book.out);
-    else
-        allBooks_[book.in].insert(book.out);
+        if (books_.refs.count(it->first) == 0)
+            books_.erase(it->first);
+        it = provisional_.erase(it);
+    }
+}
+
+void
+OrderBookDB::processLedger(
+    std::shared_ptr<ReadView const> const& ledger,
+    AcceptedLedger const& accepted)
+{
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;  // pathfinding has been disabled
+
+    auto changes = getChanges(accepted);
+    auto const seq = ledger->seq();
+    bool fullUpdate = false;
+
+    {
+        std::lock_guard sl(mLock);
+
+        if (seq <= booksSeq_)
+            return;
+
+        auto const& kept = recent_[seq] = std::move(changes);
+        while (recent_.size() > recentLedgers)
+            recent_.erase(recent_.begin());
+
+        if (booksSeq_ != 0 && seq == booksSeq_ + 1)
+        {
+            applyChanges(kept);
+            booksSeq_ = seq;
+            expireBooks();
+            return;
+        }
+
+        if (booksSeq_ != 0)
+        {
+            JLOG(j_.info()) << "Books at " << booksSeq_ << " can't be brought"
+                            << " up to " << seq;
+            booksSeq_ = 0;
+            seq_.store(0);
+            fullUpdate = true;
+        }
+        else
+        {
+            // Unless one is pending, start a full update
+            fullUpdate = seq_.load() == 0;
+        }
+    }
+
+    if (fullUpdate)
+        setup(ledger);
+}
+
+void
+OrderBookDB::addOrderBook(Book const& book, LedgerIndex seq)
+{
+    std::lock_guard sl(mLock);
+    if (books_.refs.count(book) != 0)
+        return;
 
-    if (book.domain && toXRP)
-        xrpDomainBooks_.insert({book.in, *book.domain});
-    else if (toXRP)
-        xrpBooks_.insert(book.in);
+    books_.insert(book);
+    auto& due = provisional_[book];
+    due = std::max(due, seq);
 }
 
 // return list of all orderbooks that want this issuerID and currencyID
@@ -216,9 +425,9 @@ OrderBookDB::getBooksByTakerPays(
         };
 
         if (!domain)
-            getBooks(allBooks_, issue);
+            getBooks(books_.all, issue);
         else
-            getBooks(domainBooks_, std::make_pair(issue, *domain));
+            getBooks(books_.domain, std::make_pair(issue, *domain));
     }
 
     return ret;
@@ -233,13 +442,13 @@ OrderBookDB::getBookSize(
 
     if (!domain)
     {
-        if (auto it = allBooks_.find(issue); it != allBooks_.end())
+        if (auto it = books_.all.find(issue); it != books_.all.end())
             return static_cast<int>(it->second.size());
     }
     else
     {
-        if (auto it = domainBooks_.find({issue, *domain});
-            it != domainBooks_.end())
+        if (auto it = books_.domain.find({issue, *domain});
+            it != books_.domain.end())
             return static_cast<int>(it->second.size());
     }
 
@@ -251,8 +460,8 @@ OrderBookDB::isBookToXRP(Issue const& issue, std::optional<Domain> domain)
 {
     std::lock_guard sl(mLock);
     if (domain)
-        return xrpDomainBooks_.contains({issue, *domain});
-    return xrpBooks_.contains(issue);
+        return books_.xrpDomain.contains({issue, *domain});
+    return books_.xrp.contains(issue);
 }
 
 BookListeners::pointer
@@ -27,11 +27,15 @@
 #include <xrpl/protocol/MultiApiJson.h>
 #include <xrpl/protocol/UintTypes.h>
 
+#include <map>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace ripple {
 
+class AcceptedLedger;
+
 class OrderBookDB
 {
 public:
@@ -42,8 +46,26 @@ public:
     void
     update(std::shared_ptr<ReadView const> const& ledger);
 
+    /** Bring the books up to date with a published ledger.
+
+        Only the book directories and AMMs that the ledger's transactions
+        created or deleted are looked at. If the books do not reflect the
+        ledger before, the changes are kept, to be made once a full update
+        catches up, and a full update is started if none is pending.
+    */
+    void
+    processLedger(
+        std::shared_ptr<ReadView const> const& ledger,
+        AcceptedLedger const& accepted);
+
+    /** Add a book made by a transaction applied to a view.
+
+        Unless a ledger's metadata counts the book by the time the ledger
+        with sequence seq is published, the book is dropped again: the
+        transaction may have been applied to an open ledger only.
+    */
     void
-    addOrderBook(Book const&);
+    addOrderBook(Book const&, LedgerIndex seq);
 
     /** @return a list of all orderbooks that want this issuerID and currencyID.
      */
@@ -75,19 +97,66 @@ public:
         MultiApiJson const& jvObj);
 
 private:
+    struct Books
+    {
+        // Maps order books by "issue in" to "issue out":
+        hardened_hash_map<Issue, hardened_hash_set<Issue>> all;
+
+        hardened_hash_map<std::pair<Issue, Domain>, hardened_hash_set<Issue>>
+            domain;
+
+        // does an order book to XRP exist
+        hash_set<Issue> xrp;
+
+        // does an order book to XRP exist
+        hash_set<std::pair<Issue, Domain>> xrpDomain;
+
+        // The number of book directories and AMMs that make each book
+        hash_map<Book, std::uint32_t> refs;
+
+        // Add a book without counting it
+        void
+        insert(Book const& book);
+
+        // Remove a book whatever its count
+        void
+        erase(Book const& book);
+
+        void
+        add(Book const& book);
+
+        // Returns false if the book was not counted
+        bool
+        remove(Book const& book);
+    };
+
+    // Books a ledger gained (true) or lost (false)
+    using Changes = std::vector<std::pair<Book, bool>>;
+
+    static Changes
+    getChanges(AcceptedLedger const& accepted);
+
+    void
+    applyChanges(Changes const& changes);
+
+    // Drop the books added by transactions which no published ledger has
+    // counted by the time it was due to
+    void
+    expireBooks();
+
     Application& app_;
 
-    // Maps order books by "issue in" to "issue out":
-    hardened_hash_map<Issue, hardened_hash_set<Issue>> allBooks_;
+    Books books_;
 
-    hardened_hash_map<std::pair<Issue, Domain>, hardened_hash_set<Issue>>
-        domainBooks_;
+    // The ledger the books reflect, or 0 if they are not being kept current
+    LedgerIndex booksSeq_ = 0;
 
-    // does an order book to XRP exist
-    hash_set<Issue> xrpBooks_;
+    // The changes made by recently published ledgers
+    std::map<LedgerIndex, Changes> recent_;
 
-    // does an order book to XRP exist
-    hash_set<std::pair<Issue, Domain>> xrpDomainBooks_;
+    // The books added by transactions, with the ledger by which each must
+    // have been counted
+    hash_map<Book, LedgerIndex> provisional_;
 
     std::recursive_mutex mLock;
 
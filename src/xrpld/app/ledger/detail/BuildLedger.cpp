@@ -21,11 +21,16 @@
 #include <xrpld/app/ledger/Ledger.h>
 #include <xrpld/app/ledger/LedgerReplay.h>
 #include <xrpld/app/ledger/OpenLedger.h>
+#include <xrpld/app/ledger/detail/ParallelApply.h>
+#include <xrpld/app/main/Application.h>
 #include <xrpld/app/misc/CanonicalTXSet.h>
 #include <xrpld/app/tx/apply.h>
+#include <xrpld/core/Config.h>
 
 #include <xrpl/protocol/Feature.h>
 
+#include <algorithm>
+
 namespace ripple {
 
 /* Generic buildLedgerImpl that dispatches to ApplyTxs invocable with signature
@@ -68,8 +73,12 @@ buildLedgerImpl(
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
 
-        int const asf = built->stateMap().flushDirty(hotACCOUNT_NODE);
-        int const tmf = built->txMap().flushDirty(hotTRANSACTION_NODE);
+        auto& jobQueue = app.getJobQueue();
+        auto const threads = app.config().FLUSH_WORKERS;
+        int const asf = built->stateMap().flushDirty(
+            hotACCOUNT_NODE, jobQueue, threads);
+        int const tmf = built->txMap().flushDirty(
+            hotTRANSACTION_NODE, jobQueue, threads);
         JLOG(j.debug()) << "Flushed " << asf << " accounts and " << tmf
                         << " transaction nodes";
     }
@@ -85,23 +94,73 @@ buildLedgerImpl(
     return built;
 }
 
-/** Apply a set of consensus transactions to a ledger.
+// Apply each transaction in turn, and return the number applied
+static int
+applyPass(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    int pass,
+    bool certainRetry,
+    beast::Journal j)
+{
+    int changes = 0;
 
-  @param app Handle to application
-  @param txns the set of transactions to apply,
-  @param failed set of transactions that failed to apply
-  @param view ledger to apply to
-  @param j Journal for logging
-  @return number of transactions applied; transactions to retry left in txns
-*/
+    auto it = txns.begin();
 
-std::size_t
-applyTransactions(
+    while (it != txns.end())
+    {
+        auto const txid = it->first.getTXID();
+
+        try
+        {
+            if (pass == 0 && built->txExists(txid))
+            {
+                it = txns.erase(it);
+                continue;
+            }
+
+            switch (applyTransaction(
+                app, view, *it->second, certainRetry, tapNONE, j))
+            {
+                case ApplyTransactionResult::Success:
+                    it = txns.erase(it);
+                    ++changes;
+                    break;
+
+                case ApplyTransactionResult::Fail:
+                    failed.insert(txid);
+                    it = txns.erase(it);
+                    break;
+
+                case ApplyTransactionResult::Retry:
+                    ++it;
+            }
+        }
+        catch (std::exception const& ex)
+        {
+            JLOG(j.warn())
+                << "Transaction " << txid << " throws: " << ex.what();
+            failed.insert(txid);
+            it = txns.erase(it);
+        }
+    }
+
+    return changes;
+}
+
+// Make passes over the transactions until none remain, or a pass does not
+// apply any
+static std::size_t
+applyPasses(
     Application& app,
     std::shared_ptr<Ledger const> const& built,
     CanonicalTXSet& txns,
     std::set<TxID>& failed,
     OpenView& view,
+    bool parallel,
     beast::Journal j)
 {
     bool certainRetry = true;
@@ -112,47 +171,11 @@ applyTransactions(
     {
         JLOG(j.debug()) << (certainRetry ? "Pass: " : "Final pass: ") << pass
                         << " begins (" << txns.size() << " transactions)";
-        int changes = 0;
 
-        auto it = txns.begin();
-
-        while (it != txns.end())
-        {
-            auto const txid = it->first.getTXID();
-
-            try
-            {
-                if (pass == 0 && built->txExists(txid))
-                {
-                    it = txns.erase(it);
-                    continue;
-                }
-
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
-                {
-                    case ApplyTransactionResult::Success:
-                        it = txns.erase(it);
-                        ++changes;
-                        break;
-
-                    case ApplyTransactionResult::Fail:
-                        failed.insert(txid);
-                        it = txns.erase(it);
-                        break;
-
-                    case ApplyTransactionResult::Retry:
-                        ++it;
-                }
-            }
-            catch (std::exception const& ex)
-            {
-                JLOG(j.warn())
-                    << "Transaction " << txid << " throws: " << ex.what();
-                failed.insert(txid);
-                it = txns.erase(it);
-            }
-        }
+        int const changes = parallel
+            ? applyPassInParallel(
+                  app, *built, txns, failed, view, pass, certainRetry, j)
+            : applyPass(app, built, txns, failed, view, pass, certainRetry, j);
 
         JLOG(j.debug()) << (certainRetry ? "Pass: " : "Final pass: ") << pass
                         << " completed (" << changes << " changes)";
@@ -173,10 +196,78 @@ applyTransactions(
     // tried them in at least one final pass
     XRPL_ASSERT(
         txns.empty() || !certainRetry,
-        "ripple::applyTransactions : retry transactions");
+        "ripple::applyPasses : retry transactions");
     return count;
 }
 
+/** Apply a set of consensus transactions to a ledger.
+
+  @param app Handle to application
+  @param txns the set of transactions to apply,
+  @param failed set of transactions that failed to apply
+  @param view ledger to apply to
+  @param j Journal for logging
+  @return number of transactions applied; transactions to retry left in txns
+*/
+
+std::size_t
+applyTransactions(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    beast::Journal j)
+{
+    switch (app.config().LEDGER_APPLY)
+    {
+        case Config::LedgerApply::serial:
+            break;
+
+        case Config::LedgerApply::parallel:
+            return applyPasses(app, built, txns, failed, view, true, j);
+
+        case Config::LedgerApply::verify: {
+            // Apply in parallel to copies, and compare with the serial result,
+            // which is the one kept
+            OpenView parallelView(view);
+            CanonicalTXSet parallelTxns(txns);
+            std::set<TxID> parallelFailed(failed);
+            auto const parallelCount = applyPasses(
+                app,
+                built,
+                parallelTxns,
+                parallelFailed,
+                parallelView,
+                true,
+                j);
+
+            auto const count =
+                applyPasses(app, built, txns, failed, view, false, j);
+
+            auto const sameTxns = std::equal(
+                txns.begin(),
+                txns.end(),
+                parallelTxns.begin(),
+                parallelTxns.end(),
+                [](auto const& a, auto const& b) {
+                    return a.first == b.first;
+                });
+            if (parallelCount != count || !sameTxns ||
+                parallelFailed != failed ||
+                digestOfChanges(parallelView) != digestOfChanges(view))
+            {
+                JLOG(j.error()) << "Parallel transaction application diverged "
+                                   "from serial in ledger "
+                                << view.seq();
+            }
+            return count;
+        }
+    }
+
+    return applyPasses(app, built, txns, failed, view, false, j);
+}
+
 // Build a ledger from consensus transactions
 std::shared_ptr<Ledger>
 buildLedger(
@@ -202,7 +202,8 @@ neededHashes(
     uint256 const& root,
     SHAMap& map,
     int max,
-    SHAMapSyncFilter* filter)
+    SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority)
 {
     std::vector<uint256> ret;
 
@@ -212,7 +213,7 @@ neededHashes(
             ret.push_back(root);
         else
         {
-            auto mn = map.getMissingNodes(max, filter);
+            auto mn = map.getMissingNodes(max, filter, priority);
             ret.reserve(mn.size());
             for (auto const& n : mn)
                 ret.push_back(n.second);
@@ -225,14 +226,37 @@ neededHashes(
 std::vector<uint256>
 InboundLedger::neededTxHashes(int max, SHAMapSyncFilter* filter) const
 {
-    return neededHashes(mLedger->info().txHash, mLedger->txMap(), max, filter);
+    return neededHashes(
+        mLedger->info().txHash,
+        mLedger->txMap(),
+        max,
+        filter,
+        fetchPriority());
 }
 
 std::vector<uint256>
 InboundLedger::neededStateHashes(int max, SHAMapSyncFilter* filter) const
 {
     return neededHashes(
-        mLedger->info().accountHash, mLedger->stateMap(), max, filter);
+        mLedger->info().accountHash,
+        mLedger->stateMap(),
+        max,
+        filter,
+        fetchPriority());
+}
+
+NodeStore::FetchPriority
+InboundLedger::fetchPriority() const
+{
+    switch (mReason)
+    {
+        case Reason::CONSENSUS:
+            return NodeStore::FetchPriority::consensus;
+        case Reason::HISTORY:
+            return NodeStore::FetchPriority::background;
+        default:
+            return NodeStore::FetchPriority::catchup;
+    }
 }
 
 // See how much of the ledger data is stored locally
@@ -646,8 +670,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
 
             // Release the lock while we process the large state map
             sl.unlock();
-            auto nodes =
-                mLedger->stateMap().getMissingNodes(missingNodesFind, &filter);
+            auto nodes = mLedger->stateMap().getMissingNodes(
+                missingNodesFind, &filter, fetchPriority());
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -719,8 +743,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
             TransactionStateSF filter(
                 mLedger->txMap().family().db(), app_.getLedgerMaster());
 
-            auto nodes =
-                mLedger->txMap().getMissingNodes(missingNodesFind, &filter);
+            auto nodes = mLedger->txMap().getMissingNodes(
+                missingNodesFind, &filter, fetchPriority());
 
             if (nodes.empty())
             {
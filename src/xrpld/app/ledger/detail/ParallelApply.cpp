@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/app/ledger/Ledger.h>
+#include <xrpld/app/ledger/detail/ParallelApply.h>
+#include <xrpld/app/main/Application.h>
+#include <xrpld/app/tx/apply.h>
+#include <xrpld/core/JobQueue.h>
+#include <xrpld/ledger/RecordingView.h>
+
+#include <xrpl/protocol/digest.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// The number of transactions run speculatively at once
+constexpr std::size_t groupSize = 64;
+
+// Hashes the changes of the view applied to it
+class ChangeHasher final : public TxsRawView
+{
+    sha512_half_hasher h_;
+
+    void
+    add(int action, SLE const& sle)
+    {
+        using beast::hash_append;
+        hash_append(h_, action);
+        hash_append(h_, sle.key());
+        Serializer s;
+        sle.add(s);
+        h_(s.data(), s.size());
+    }
+
+public:
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        add(0, *sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        add(1, *sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        add(2, *sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        using beast::hash_append;
+        hash_append(h_, fee.drops());
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        using beast::hash_append;
+        hash_append(h_, key);
+        h_(txn->data(), txn->size());
+        if (metaData)
+            h_(metaData->data(), metaData->size());
+    }
+
+    uint256
+    digest()
+    {
+        return static_cast<typename sha512_half_hasher::result_type>(h_);
+    }
+};
+
+// A transaction run against the view as it was before its group
+struct Speculation
+{
+    // The number of transactions assumed to be in the ledger before it
+    std::size_t txCount = 0;
+
+    ReadSet reads;
+    std::vector<uint256> writes;
+    std::optional<RecordingView> base;
+    std::optional<OpenView> view;
+    ApplyTransactionResult result = ApplyTransactionResult::Fail;
+
+    // False if it threw, in which case it is run again
+    bool ran = false;
+};
+
+// Whether a transaction may have had a different result had it been run
+// after the changes to the written entries
+bool
+conflicts(Speculation const& s, std::set<uint256> const& written)
+{
+    if (s.reads.changedBy(written))
+        return true;
+
+    return std::any_of(
+        s.writes.begin(), s.writes.end(), [&written](uint256 const& key) {
+            return written.count(key) != 0;
+        });
+}
+
+}  // namespace
+
+int
+applyPassInParallel(
+    Application& app,
+    Ledger const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    int pass,
+    bool certainRetry,
+    beast::Journal j)
+{
+    int changes = 0;
+    std::size_t speculated = 0;
+    std::size_t rerun = 0;
+
+    std::vector<CanonicalTXSet::const_iterator> group;
+    group.reserve(groupSize);
+
+    auto it = txns.begin();
+    while (it != txns.end())
+    {
+        // Take the next group, dropping those already in the ledger
+        group.clear();
+        while (it != txns.end() && group.size() < groupSize)
+        {
+            auto const txid = it->first.getTXID();
+
+            try
+            {
+                if (pass == 0 && built.txExists(txid))
+                {
+                    it = txns.erase(it);
+                    continue;
+                }
+            }
+            catch (std::exception const& ex)
+            {
+                JLOG(j.warn())
+                    << "Transaction " << txid << " throws: " << ex.what();
+                failed.insert(txid);
+                it = txns.erase(it);
+                continue;
+            }
+
+            group.push_back(it++);
+        }
+
+        std::vector<Speculation> specs(group.size());
+        auto const txCount = view.txCount();
+        app.getJobQueue().parallelFor(
+            jtACCEPT,
+            "speculativeApply",
+            group.size(),
+            1,
+            [&](std::size_t first, std::size_t last) {
+                for (auto i = first; i < last; ++i)
+                {
+                    auto& s = specs[i];
+                    s.txCount = txCount + i;
+                    try
+                    {
+                        s.base.emplace(view, s.reads);
+                        s.view.emplace(batch_view, &*s.base, s.txCount);
+                        s.result = applyTransaction(
+                            app,
+                            *s.view,
+                            *group[i]->second,
+                            certainRetry,
+                            tapNONE,
+                            j);
+                        WriteRecorder writes(s.writes);
+                        s.view->apply(writes);
+                        s.ran = true;
+                    }
+                    catch (std::exception const&)
+                    {
+                        // It is run again when committed
+                    }
+                }
+            });
+        speculated += group.size();
+
+        // Commit in canonical order
+        std::set<uint256> written;
+        std::size_t i = 0;
+        for (; i < group.size(); ++i)
+        {
+            auto& s = specs[i];
+            if (view.txCount() != s.txCount)
+                break;
+
+            auto const txid = group[i]->first.getTXID();
+            auto result = ApplyTransactionResult::Fail;
+            if (s.ran && !conflicts(s, written))
+            {
+                s.view->apply(view);
+                written.insert(s.writes.begin(), s.writes.end());
+                result = s.result;
+            }
+            else
+            {
+                // Run it again, against the view as it is now
+                ++rerun;
+                try
+                {
+                    std::vector<uint256> writes;
+                    OpenView again(batch_view, view);
+                    result = applyTransaction(
+                        app,
+                        again,
+                        *group[i]->second,
+                        certainRetry,
+                        tapNONE,
+                        j);
+                    WriteRecorder recorder(writes);
+                    again.apply(recorder);
+                    again.apply(view);
+                    written.insert(writes.begin(), writes.end());
+                }
+                catch (std::exception const& ex)
+                {
+                    JLOG(j.warn())
+                        << "Transaction " << txid << " throws: " << ex.what();
+                    result = ApplyTransactionResult::Fail;
+                }
+            }
+
+            switch (result)
+            {
+                case ApplyTransactionResult::Success:
+                    txns.erase(group[i]);
+                    ++changes;
+                    break;
+
+                case ApplyTransactionResult::Fail:
+                    failed.insert(txid);
+                    txns.erase(group[i]);
+                    break;
+
+                case ApplyTransactionResult::Retry:
+                    break;
+            }
+        }
+
+        // A transaction was not added as assumed, so those after it are
+        // numbered wrongly. They start the next group.
+        if (i < group.size())
+            it = group[i];
+    }
+
+    JLOG(j.debug()) << "Parallel pass: " << speculated
+                    << " transactions run speculatively, " << rerun
+                    << " run again";
+    return changes;
+}
+
+uint256
+digestOfChanges(OpenView const& view)
+{
+    ChangeHasher hasher;
+    view.apply(hasher);
+    return hasher.digest();
+}
+
+}  // namespace ripple
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_PARALLELAPPLY_H_INCLUDED
+#define RIPPLE_APP_LEDGER_PARALLELAPPLY_H_INCLUDED
+
+#include <xrpld/app/misc/CanonicalTXSet.h>
+#include <xrpld/ledger/OpenView.h>
+
+#include <xrpl/beast/utility/Journal.h>
+
+#include <set>
+
+namespace ripple {
+
+class Application;
+class Ledger;
+
+/** Make one pass over consensus transactions, running them in parallel.
+
+    The transactions are taken in canonical order, in groups. Each one of a
+    group is run on a job queue thread, in a view stacked on `view` which
+    records the entries it reads and writes, and which numbers it as if each
+    earlier transaction of the group was added to the ledger. The results
+    are then committed in canonical order. A transaction is run again, on
+    the calling thread, if it read or wrote an entry that an earlier one of
+    the group wrote. If it would be numbered differently than assumed, the
+    group ends there, and the rest are run in the next group.
+
+    The effect on `view`, `txns` and `failed` is the same as applying each
+    transaction in turn.
+
+    @param built The ledger being built, which `view` is stacked on
+    @param pass The number of earlier passes
+    @param certainRetry Whether a transaction which fails in a way that may
+                        succeed later is kept for another pass
+    @return The number of transactions applied
+*/
+int
+applyPassInParallel(
+    Application& app,
+    Ledger const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    int pass,
+    bool certainRetry,
+    beast::Journal j);
+
+/** Return a digest of the changes a view holds over its base.
+
+    Views stacked on the same base which hold different state entries or
+    transactions have different digests.
+*/
+uint256
+digestOfChanges(OpenView const& view);
+
+}  // namespace ripple
+
+#endif
@@ -144,7 +144,8 @@ TransactionAcquire::trigger(std::shared_ptr<Peer> const& peer)
     else
     {
         ConsensusTransSetSF sf(app_, app_.getTempNodeCache());
-        auto nodes = mMap->getMissingNodes(256, &sf);
+        auto nodes = mMap->getMissingNodes(
+            256, &sf, NodeStore::FetchPriority::consensus);
 
         if (nodes.empty())
         {
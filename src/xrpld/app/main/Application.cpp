@@ -47,6 +47,7 @@
 #include <xrpld/app/rdb/RelationalDatabase.h>
 #include <xrpld/app/rdb/Wallet.h>
 #include <xrpld/app/tx/apply.h>
+#include <xrpld/core/ConfigSections.h>
 #include <xrpld/core/DatabaseCon.h>
 #include <xrpld/nodestore/DummyScheduler.h>
 #include <xrpld/overlay/Cluster.h>
@@ -61,6 +62,7 @@
 #include <xrpl/basics/ResolverAsio.h>
 #include <xrpl/basics/random.h>
 #include <xrpl/beast/asio/io_latency_probe.h>
+#include <xrpl/beast/core/CurrentThreadName.h>
 #include <xrpl/beast/core/LexicalCast.h>
 #include <xrpl/crypto/csprng.h>
 #include <xrpl/json/json_reader.h>
@@ -84,6 +86,7 @@
 #include <mutex>
 #include <optional>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 namespace ripple {
@@ -237,6 +240,9 @@ public:
 
     std::unique_ptr<GRPCServer> grpcServer_;
 
+    // Checks the snapshot a ledger was loaded from
+    std::jthread snapshotVerifier_;
+
     //--------------------------------------------------------------------------
 
     static std::size_t
@@ -319,7 +325,14 @@ public:
               m_collectorManager->group("jobq"),
               logs_->journal("JobQueue"),
               *logs_,
-              *perfLog_))
+              *perfLog_,
+              config_->WORK_STEALING,
+              [](std::unique_ptr<Config> const& config) {
+                  // A standalone server runs its jobs one at a time
+                  if (config->standalone() && !config->FORCE_MULTI_THREAD)
+                      return std::vector<JobPoolSetup>{};
+                  return setup_JobPools(*config);
+              }(config_)))
 
         , m_nodeStoreScheduler(*m_jobQueue)
 
@@ -476,6 +489,9 @@ public:
     {
         initAccountIdCache(config_->getValueFor(SizedItem::accountIdCacheSize));
 
+        m_jobQueue->setSlowJobTrace(
+            config_->JOB_TRACE_THRESHOLD, config_->JOB_TRACE_SAMPLE);
+
         add(m_resourceManager.get());
 
         //
@@ -1166,6 +1182,15 @@ private:
 
     void
     setMaxDisallowedLedger();
+
+    void
+    openSnapshot();
+
+    void
+    verifySnapshot(std::shared_ptr<Ledger const> const& ledger);
+
+    void
+    writeSnapshot();
 };
 
 //------------------------------------------------------------------------------
@@ -1267,6 +1292,8 @@ ApplicationImp::setup(boost::program_options::variables_map const& cmdline)
 
     Pathfinder::initPathTable();
 
+    openSnapshot();
+
     auto const startUp = config_->START_UP;
     JLOG(m_journal.debug()) << "startUp: " << startUp;
     if (startUp == Config::FRESH)
@@ -1638,6 +1665,7 @@ ApplicationImp::run()
     m_inboundTransactions->stop();
     m_inboundLedgers->stop();
     ledgerCleaner_->stop();
+    writeSnapshot();
     m_nodeStore->stop();
     perfLog_->stop();
 
@@ -2029,7 +2057,15 @@ ApplicationImp::loadOldLedger(
             return false;
         }
 
-        if (!loadLedger->walkLedger(journal("Ledger"), true))
+        if (auto const snapshot = m_nodeStore->getSnapshot();
+            snapshot && snapshot->ledgerHash() == loadLedger->info().hash)
+        {
+            // The ledger can be served from the snapshot at once, so the
+            // snapshot is checked in the background instead of the ledger
+            // being walked first.
+            verifySnapshot(loadLedger);
+        }
+        else if (!loadLedger->walkLedger(journal("Ledger"), true))
         {
             JLOG(m_journal.fatal()) << "Ledger is missing nodes.";
             UNREACHABLE(
@@ -2112,6 +2148,86 @@ ApplicationImp::loadOldLedger(
     return true;
 }
 
+void
+ApplicationImp::openSnapshot()
+{
+    auto const path =
+        get(config_->section(ConfigSection::nodeDatabase()), "snapshot");
+    if (path.empty() || !boost::filesystem::exists(path))
+        return;
+
+    try
+    {
+        auto snapshot = std::make_shared<NodeStore::Snapshot const>(path);
+        JLOG(m_journal.info())
+            << "Using snapshot of ledger " << snapshot->ledgerSeq() << " ("
+            << snapshot->size() << " objects)";
+        m_nodeStore->setSnapshot(std::move(snapshot));
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) << "Not using snapshot: " << e.what();
+    }
+}
+
+void
+ApplicationImp::verifySnapshot(std::shared_ptr<Ledger const> const& ledger)
+{
+    snapshotVerifier_ = std::jthread([this, ledger](std::stop_token stop) {
+        beast::setCurrentThreadName("SnapshotVerify");
+
+        auto const snapshot = m_nodeStore->getSnapshot();
+        if (!snapshot)
+            return;
+
+        auto const stopping = [this, &stop]() {
+            return isStopping() || stop.stop_requested();
+        };
+        if (ripple::verifySnapshot(*snapshot, *ledger, stopping))
+        {
+            JLOG(m_journal.info()) << "Verified snapshot of ledger "
+                                   << snapshot->ledgerSeq();
+            return;
+        }
+
+        if (stopping())
+            return;
+
+        JLOG(m_journal.error()) << "Snapshot of ledger "
+                                << snapshot->ledgerSeq()
+                                << " is damaged, no longer using it";
+        m_nodeStore->setSnapshot(nullptr);
+    });
+}
+
+void
+ApplicationImp::writeSnapshot()
+{
+    if (snapshotVerifier_.joinable())
+        snapshotVerifier_.join();
+
+    auto const path =
+        get(config_->section(ConfigSection::nodeDatabase()), "snapshot");
+    auto const ledger = m_ledgerMaster->getValidatedLedger();
+    if (path.empty() || !ledger)
+        return;
+
+    if (auto const snapshot = m_nodeStore->getSnapshot();
+        snapshot && snapshot->ledgerHash() == ledger->info().hash)
+        return;
+
+    try
+    {
+        ripple::writeSnapshot(*ledger, path);
+        JLOG(m_journal.info())
+            << "Wrote snapshot of ledger " << ledger->info().seq;
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) << "Unable to write snapshot: " << e.what();
+    }
+}
+
 bool
 ApplicationImp::serverOkay(std::string& reason)
 {
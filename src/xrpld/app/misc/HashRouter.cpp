@@ -20,32 +20,70 @@
 #include <xrpld/app/misc/HashRouter.h>
 #include <xrpld/core/Config.h>
 
+#include <xrpl/beast/container/aged_container_utility.h>
+
 namespace ripple {
 
+HashRouter::HashRouter(Setup const& setup, Stopwatch& clock)
+    : clock_(clock), setup_(setup), expired_(clock.now())
+{
+    for (auto& shard : shards_)
+        shard = std::make_unique<Shard>(clock);
+}
+
+template <class F>
 auto
-HashRouter::emplace(uint256 const& key) -> std::pair<Entry&, bool>
+HashRouter::withEntry(uint256 const& key, F&& f)
 {
-    auto iter = suppressionMap_.find(key);
+    // The hashes are already well mixed
+    auto& shard = *shards_[key.data()[0] % shardCount];
 
-    if (iter != suppressionMap_.end())
-    {
-        suppressionMap_.touch(iter);
-        return std::make_pair(std::ref(iter->second), false);
-    }
+    bool created = false;
+    auto result = [&] {
+        std::lock_guard lock(shard.mutex);
+
+        auto& map = shard.suppressionMap;
+        auto iter = map.find(key);
+        if (iter != map.end())
+        {
+            map.touch(iter);
+            return f(iter->second, false);
+        }
+
+        created = true;
+        return f(map.emplace(key, Entry()).first->second, true);
+    }();
 
     // See if any supressions need to be expired
-    expire(suppressionMap_, setup_.holdTime);
+    if (created)
+        expire();
 
-    return std::make_pair(
-        std::ref(suppressionMap_.emplace(key, Entry()).first->second), true);
+    return result;
 }
 
 void
-HashRouter::addSuppression(uint256 const& key)
+HashRouter::expire()
 {
-    std::lock_guard lock(mutex_);
+    using namespace std::chrono_literals;
+
+    // Entries only expire as time passes, so looking once a second is as
+    // good as looking on every insertion
+    auto const now = clock_.now();
+    auto last = expired_.load();
+    if (now < last + 1s || !expired_.compare_exchange_strong(last, now))
+        return;
 
-    emplace(key);
+    for (auto& shard : shards_)
+    {
+        std::lock_guard lock(shard->mutex);
+        beast::expire(shard->suppressionMap, setup_.holdTime);
+    }
+}
+
+void
+HashRouter::addSuppression(uint256 const& key)
+{
+    withEntry(key, [](Entry&, bool created) { return created; });
 }
 
 bool
@@ -57,22 +95,20 @@ HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer)
 std::pair<bool, std::optional<Stopwatch::time_point>>
 HashRouter::addSuppressionPeerWithStatus(uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard lock(mutex_);
-
-    auto result = emplace(key);
-    result.first.addPeer(peer);
-    return {result.second, result.first.relayed()};
+    return withEntry(key, [peer](Entry& s, bool created) {
+        s.addPeer(peer);
+        return std::make_pair(created, s.relayed());
+    });
 }
 
 bool
 HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard lock(mutex_);
-
-    auto [s, created] = emplace(key);
-    s.addPeer(peer);
-    flags = s.getFlags();
-    return created;
+    return withEntry(key, [peer, &flags](Entry& s, bool created) {
+        s.addPeer(peer);
+        flags = s.getFlags();
+        return created;
+    });
 }
 
 bool
@@ -82,21 +118,17 @@ HashRouter::shouldProcess(
     int& flags,
     std::chrono::seconds tx_interval)
 {
-    std::lock_guard lock(mutex_);
-
-    auto result = emplace(key);
-    auto& s = result.first;
-    s.addPeer(peer);
-    flags = s.getFlags();
-    return s.shouldProcess(suppressionMap_.clock().now(), tx_interval);
+    return withEntry(key, [&](Entry& s, bool) {
+        s.addPeer(peer);
+        flags = s.getFlags();
+        return s.shouldProcess(clock_.now(), tx_interval);
+    });
 }
 
 int
 HashRouter::getFlags(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
-
-    return emplace(key).first.getFlags();
+    return withEntry(key, [](Entry& s, bool) { return s.getFlags(); });
 }
 
 bool
@@ -104,29 +136,26 @@ HashRouter::setFlags(uint256 const& key, int flags)
 {
     XRPL_ASSERT(flags, "ripple::HashRouter::setFlags : valid input");
 
-    std::lock_guard lock(mutex_);
-
-    auto& s = emplace(key).first;
+    return withEntry(key, [flags](Entry& s, bool) {
+        if ((s.getFlags() & flags) == flags)
+            return false;
 
-    if ((s.getFlags() & flags) == flags)
-        return false;
-
-    s.setFlags(flags);
-    return true;
+        s.setFlags(flags);
+        return true;
+    });
 }
 
 auto
 HashRouter::shouldRelay(uint256 const& key)
     -> std::optional<std::set<PeerShortID>>
 {
-    std::lock_guard lock(mutex_);
-
-    auto& s = emplace(key).first;
-
-    if (!s.shouldRelay(suppressionMap_.clock().now(), setup_.relayTime))
-        return {};
+    return withEntry(
+        key, [this](Entry& s, bool) -> std::optional<std::set<PeerShortID>> {
+            if (!s.shouldRelay(clock_.now(), setup_.relayTime))
+                return {};
 
-    return s.releasePeerSet();
+            return s.releasePeerSet();
+        });
 }
 
 HashRouter::Setup
@@ -26,6 +26,10 @@
 #include <xrpl/basics/chrono.h>
 #include <xrpl/beast/container/aged_unordered_map.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 namespace ripple {
@@ -52,6 +56,10 @@ class Config;
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into shards by hash, each with its own lock, so that
+    threads handling different messages rarely wait for each other. Expired
+    entries are removed one shard at a time.
 */
 class HashRouter
 {
@@ -161,11 +169,29 @@ private:
         std::optional<Stopwatch::time_point> processed_;
     };
 
-public:
-    HashRouter(Setup const& setup, Stopwatch& clock)
-        : setup_(setup), suppressionMap_(clock)
+    // The hashes are spread over this many shards
+    static constexpr std::size_t shardCount = 16;
+
+    struct alignas(64) Shard
     {
-    }
+        explicit Shard(Stopwatch& clock) : suppressionMap(clock)
+        {
+        }
+
+        std::mutex mutex;
+
+        // Stores the suppressed hashes of the shard and their expiration
+        // time
+        beast::aged_unordered_map<
+            uint256,
+            Entry,
+            Stopwatch::clock_type,
+            hardened_hash<strong_hash>>
+            suppressionMap;
+    };
+
+public:
+    HashRouter(Setup const& setup, Stopwatch& clock);
 
     HashRouter&
     operator=(HashRouter const&) = delete;
@@ -225,22 +251,25 @@ public:
     shouldRelay(uint256 const& key);
 
 private:
-    // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool>
-    emplace(uint256 const&);
+    // Call f with the entry for a hash, and whether it was created, while
+    // holding the lock of its shard
+    template <class F>
+    auto
+    withEntry(uint256 const& key, F&& f);
 
-    std::mutex mutable mutex_;
+    // Remove expired entries, one shard at a time
+    void
+    expire();
+
+    Stopwatch& clock_;
 
     // Configurable parameters
     Setup const setup_;
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<
-        uint256,
-        Entry,
-        Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        suppressionMap_;
+    std::array<std::unique_ptr<Shard>, shardCount> shards_;
+
+    // When expired entries were last removed
+    std::atomic<Stopwatch::time_point> expired_;
 };
 
 HashRouter::Setup
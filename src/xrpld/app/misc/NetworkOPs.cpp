@@ -34,6 +34,7 @@
 #include <xrpld/app/misc/HashRouter.h>
 #include <xrpld/app/misc/LoadFeeTrack.h>
 #include <xrpld/app/misc/NetworkOPs.h>
+#include <xrpld/app/misc/SHAMapStore.h>
 #include <xrpld/app/misc/Transaction.h>
 #include <xrpld/app/misc/TxQ.h>
 #include <xrpld/app/misc/ValidatorKeys.h>
@@ -43,6 +44,7 @@
 #include <xrpld/app/tx/apply.h>
 #include <xrpld/consensus/Consensus.h>
 #include <xrpld/consensus/ConsensusParms.h>
+#include <xrpld/nodestore/Database.h>
 #include <xrpld/overlay/Cluster.h>
 #include <xrpld/overlay/Overlay.h>
 #include <xrpld/overlay/predicates.h>
@@ -54,6 +56,7 @@
 #include <xrpld/rpc/ServerHandler.h>
 
 #include <xrpl/basics/UptimeClock.h>
+#include <xrpl/basics/Number.h>
 #include <xrpl/basics/mulDiv.h>
 #include <xrpl/basics/safe_cast.h>
 #include <xrpl/basics/scope.h>
@@ -65,6 +68,7 @@
 #include <xrpl/protocol/MultiApiJson.h>
 #include <xrpl/protocol/NFTSyntheticSerializer.h>
 #include <xrpl/protocol/RPCErr.h>
+#include <xrpl/protocol/STAmount.h>
 #include <xrpl/protocol/TxFlags.h>
 #include <xrpl/protocol/jss.h>
 #include <xrpl/resource/Fees.h>
@@ -113,6 +117,18 @@ class NetworkOPsImp final : public NetworkOPs
                 "ripple::NetworkOPsImp::TransactionStatus::TransactionStatus : "
                 "valid inputs");
         }
+
+        ApplyFlags
+        getApplyFlags() const
+        {
+            ApplyFlags flags = tapNONE;
+            if (admin)
+                flags |= tapUNLIMITED;
+
+            if (failType == FailHard::yes)
+                flags |= tapFAIL_HARD;
+            return flags;
+        }
     };
 
     /**
@@ -801,6 +817,9 @@ private:
     DispatchState mDispatchState = DispatchState::none;
     std::vector<TransactionStatus> mTransactions;
 
+    // The number of transactions of a batch preflighted by one job.
+    static constexpr std::size_t preflightSliceSize = 8;
+
     StateAccounting accounting_{};
 
     std::set<uint256> pendingValidations_;
@@ -1398,6 +1417,26 @@ void
 NetworkOPsImp::processTransactionSet(CanonicalTXSet const& set)
 {
     auto ev = m_job_queue.makeLoadEvent(jtTXN_PROC, "ProcessTXNSet");
+
+    // Check the signatures on many threads first, so that the checks made
+    // one at a time below find them cached. Inner batch transactions are
+    // rejected below without being checked.
+    {
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve(set.size());
+        for (auto const& [_, tx] : set)
+        {
+            if (!tx->isFlag(tfInnerBatchTxn))
+                txs.push_back(tx);
+        }
+        checkValidity(
+            app_.getHashRouter(),
+            txs,
+            m_ledgerMaster.getCurrentLedger()->rules(),
+            app_.config(),
+            m_job_queue);
+    }
+
     std::vector<std::shared_ptr<Transaction>> candidates;
     candidates.reserve(set.size());
     for (auto const& [_, tx] : set)
@@ -1488,6 +1527,36 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
     batchLock.unlock();
 
+    // Preflight, which checks the signature too, depends only on the rules
+    // and the transaction, so it is done for the whole batch on many threads
+    // before the locks are taken. If the rules change meanwhile, it is done
+    // again under the locks.
+    std::vector<std::optional<PreflightResult>> preflights(transactions.size());
+    {
+        auto const rules = app_.openLedger().current()->rules();
+        auto const j = app_.journal("OpenLedger");
+        m_job_queue.parallelFor(
+            jtBATCH,
+            "preflight",
+            transactions.size(),
+            preflightSliceSize,
+            [&](std::size_t first, std::size_t last) {
+                STAmountSO stAmountSO{
+                    rules.enabled(fixSTAmountCanonicalize)};
+                NumberSO stNumberSO{rules.enabled(fixUniversalNumber)};
+                for (auto i = first; i < last; ++i)
+                {
+                    auto const& e = transactions[i];
+                    preflights[i].emplace(preflight(
+                        app_,
+                        rules,
+                        *e.transaction->getSTransaction(),
+                        e.getApplyFlags(),
+                        j));
+                }
+            });
+    }
+
     {
         std::unique_lock masterLock{app_.getMasterMutex(), std::defer_lock};
         bool changed = false;
@@ -1497,18 +1566,15 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
             std::lock(masterLock, ledgerLock);
 
             app_.openLedger().modify([&](OpenView& view, beast::Journal j) {
-                for (TransactionStatus& e : transactions)
+                for (std::size_t i = 0; i < transactions.size(); ++i)
                 {
-                    // we check before adding to the batch
-                    ApplyFlags flags = tapNONE;
-                    if (e.admin)
-                        flags |= tapUNLIMITED;
-
-                    if (e.failType == FailHard::yes)
-                        flags |= tapFAIL_HARD;
-
+                    TransactionStatus& e = transactions[i];
                     auto const result = app_.getTxQ().apply(
-                        app_, view, e.transaction->getSTransaction(), flags, j);
+                        app_,
+                        view,
+                        e.transaction->getSTransaction(),
+                        *preflights[i],
+                        j);
                     e.result = result.ter;
                     e.applied = result.applied;
                     changed = changed || result.applied;
@@ -2553,6 +2619,15 @@ NetworkOPsImp::setMode(OperatingMode om)
 
     accounting_.mode(om);
 
+    // A snapshot of the ledger the server stopped at only helps it catch up.
+    // Once it has, most of its fetches would miss the snapshot.
+    if (om == OperatingMode::FULL && !app_.config().standalone() &&
+        app_.getNodeStore().getSnapshot())
+    {
+        JLOG(m_journal.info()) << "Synchronized, no longer using snapshot";
+        app_.getNodeStore().setSnapshot(nullptr);
+    }
+
     JLOG(m_journal.info()) << "STATE->" << strOperatingMode();
     pubServer();
 }
@@ -2777,6 +2852,10 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
         {
             info[jss::pubkey_validator] = "none";
         }
+
+        if (auto const progress = app_.getSHAMapStore().getCopyProgress();
+            !progress.isNull())
+            info[jss::online_delete] = progress;
     }
 
     if (counters)
@@ -3097,6 +3176,8 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
         alpAccepted->getLedger().get() == lpAccepted.get(),
         "ripple::NetworkOPsImp::pubLedger : accepted input");
 
+    app_.getOrderBookDB().processLedger(lpAccepted, *alpAccepted);
+
     {
         JLOG(m_journal.debug())
             << "Publishing ledger " << lpAccepted->info().seq << " "
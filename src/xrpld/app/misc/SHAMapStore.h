@@ -97,6 +97,13 @@ public:
     */
     virtual std::optional<LedgerIndex>
     minimumOnline() const = 0;
+
+    /** Report the progress of copying a ledger forward before a rotation.
+
+        @return Null unless a copy is under way.
+    */
+    virtual Json::Value
+    getCopyProgress() const = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #include <xrpld/app/rdb/State.h>
 #include <xrpld/app/rdb/backend/SQLiteDatabase.h>
 #include <xrpld/core/ConfigSections.h>
+#include <xrpld/core/JobQueue.h>
 #include <xrpld/nodestore/Scheduler.h>
 #include <xrpld/nodestore/detail/DatabaseRotatingImp.h>
 #include <xrpld/shamap/SHAMapMissingNode.h>
@@ -79,6 +80,69 @@ SHAMapStoreImp::SavedStateDB::setLastRotated(LedgerIndex seq)
     ripple::setLastRotated(sqlDb_, seq);
 }
 
+std::vector<uint256>
+SHAMapStoreImp::SavedStateDB::getCopiedSubtrees(std::string const& writableDb)
+{
+    std::lock_guard lock(mutex_);
+    return ripple::getCopiedSubtrees(sqlDb_, writableDb);
+}
+
+void
+SHAMapStoreImp::SavedStateDB::addCopiedSubtrees(
+    std::string const& writableDb,
+    std::vector<uint256> const& hashes)
+{
+    std::lock_guard lock(mutex_);
+    ripple::addCopiedSubtrees(sqlDb_, writableDb, hashes);
+}
+
+void
+SHAMapStoreImp::SavedStateDB::clearCopiedSubtrees()
+{
+    std::lock_guard lock(mutex_);
+    ripple::clearCopiedSubtrees(sqlDb_);
+}
+
+//------------------------------------------------------------------------------
+
+void
+SHAMapStoreImp::Throttle::setRates(
+    std::uint64_t bytesPerSecond,
+    std::uint64_t opsPerSecond)
+{
+    std::lock_guard lock(mutex_);
+    bytesPerSecond_ = bytesPerSecond;
+    opsPerSecond_ = opsPerSecond;
+}
+
+void
+SHAMapStoreImp::Throttle::charge(std::size_t bytes)
+{
+    using namespace std::chrono;
+
+    // Time left unused while idle may be spent at once, up to this much
+    static constexpr milliseconds burst{100};
+
+    std::chrono::steady_clock::time_point until;
+    {
+        std::lock_guard lock(mutex_);
+        if (!bytesPerSecond_ && !opsPerSecond_)
+            return;
+
+        nanoseconds cost{0};
+        if (bytesPerSecond_)
+            cost = nanoseconds(bytes * 1'000'000'000ull / bytesPerSecond_);
+        if (opsPerSecond_)
+            cost =
+                std::max(cost, nanoseconds(1'000'000'000ull / opsPerSecond_));
+
+        next_ = std::max(next_, steady_clock::now() - burst) + cost;
+        until = next_;
+    }
+
+    std::this_thread::sleep_until(until);
+}
+
 //------------------------------------------------------------------------------
 
 SHAMapStoreImp::SHAMapStoreImp(
@@ -133,6 +197,16 @@ SHAMapStoreImp::SHAMapStoreImp(
         if (get_if_exists(section, "recovery_wait_seconds", temp))
             recoveryWaitTime_ = std::chrono::seconds{temp};
 
+        get_if_exists(section, "copy_threads", copyThreads_);
+        if (copyThreads_ < 1)
+            Throw<std::runtime_error>("copy_threads must be at least 1");
+
+        std::uint64_t copyBytesPerSecond = 0;
+        std::uint64_t copyOpsPerSecond = 0;
+        get_if_exists(section, "copy_bytes_per_second", copyBytesPerSecond);
+        get_if_exists(section, "copy_ops_per_second", copyOpsPerSecond);
+        throttle_.setRates(copyBytesPerSecond, copyOpsPerSecond);
+
         get_if_exists(section, "advisory_delete", advisoryDelete_);
 
         auto const minInterval = config.standalone()
@@ -244,16 +318,56 @@ SHAMapStoreImp::fdRequired() const
     return fdRequired_;
 }
 
+Json::Value
+SHAMapStoreImp::getCopyProgress() const
+{
+    Json::Value ret;
+
+    auto const ledger = copyProgress_.ledger.load();
+    if (!ledger)
+        return ret;
+
+    using namespace std::chrono;
+    auto const elapsed = duration_cast<seconds>(
+        steady_clock::now() - copyProgress_.start.load());
+    auto const subtrees = copyProgress_.subtrees.load();
+    auto const skipped = copyProgress_.subtreesSkipped.load();
+    auto const copied = copyProgress_.subtreesCopied.load();
+
+    ret[jss::ledger_index] = ledger;
+    ret["subtrees"] = subtrees;
+    ret["subtrees_skipped"] = skipped;
+    ret["subtrees_copied"] = copied;
+    ret["nodes_copied"] = std::to_string(copyProgress_.nodes.load());
+    ret["bytes_copied"] = std::to_string(copyProgress_.bytes.load());
+    ret["elapsed_seconds"] = static_cast<Json::UInt>(elapsed.count());
+
+    // The subtrees are about the same size, so the rate at which they have
+    // been copied so far predicts the rest
+    if (copied)
+    {
+        auto const remaining = subtrees - skipped - copied;
+        ret["eta_seconds"] =
+            static_cast<Json::UInt>(elapsed.count() * remaining / copied);
+    }
+
+    return ret;
+}
+
 bool
-SHAMapStoreImp::copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node)
+SHAMapStoreImp::copyNode(SHAMapTreeNode const& node)
 {
     // Copy a single record from node to dbRotating_
-    dbRotating_->fetchNodeObject(
+    auto const object = dbRotating_->fetchNodeObject(
         node.getHash().as_uint256(),
         0,
         NodeStore::FetchType::synchronous,
         true);
-    if (!(++nodeCount % checkHealthInterval_))
+    auto const bytes = object ? object->getData().size() : 0;
+    copyProgress_.bytes += bytes;
+    throttle_.charge(bytes);
+
+    if (!(++copyProgress_.nodes % checkHealthInterval_))
     {
         if (healthWait() == stopping)
             return false;
@@ -262,6 +376,126 @@ SHAMapStoreImp::copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node)
     return true;
 }
 
+std::optional<std::uint64_t>
+SHAMapStoreImp::copyMap(SHAMap const& map, LedgerIndex seq)
+{
+    copyProgress_.start = std::chrono::steady_clock::now();
+    copyProgress_.nodes = 0;
+    copyProgress_.bytes = 0;
+    copyProgress_.subtrees = 0;
+    copyProgress_.subtreesSkipped = 0;
+    copyProgress_.subtreesCopied = 0;
+    copyProgress_.ledger = seq;
+
+    // Set when a thread finds the server stopping or fails
+    std::atomic<bool> abort = false;
+    auto copy = [this, &abort](SHAMapTreeNode const& node) {
+        if (abort || !copyNode(node))
+        {
+            abort = true;
+            return false;
+        }
+        return true;
+    };
+
+    // The nodes above the subtrees are few, so copy them on this thread
+    auto subtrees = map.splitNodes(copySplitDepth_, copy);
+    if (abort)
+    {
+        copyProgress_.ledger = 0;
+        return std::nullopt;
+    }
+
+    // Subtrees are recorded against the backend they were copied into, so
+    // that none is taken as copied after that backend is rotated out
+    auto const writableDb = state_db_.getState().writableDb;
+
+    copyProgress_.subtrees = subtrees.size();
+    {
+        auto const copied = state_db_.getCopiedSubtrees(writableDb);
+        hash_set<uint256> const done(copied.begin(), copied.end());
+        std::erase_if(subtrees, [&done](auto const& node) {
+            return done.count(node->getHash().as_uint256()) != 0;
+        });
+    }
+    copyProgress_.subtreesSkipped = copyProgress_.subtrees - subtrees.size();
+
+    JLOG(journal_.debug()) << "copying " << subtrees.size() << " of "
+                           << copyProgress_.subtrees << " subtrees on "
+                           << copyThreads_ << " threads";
+
+    // Subtrees copied are recorded in batches, each in one transaction,
+    // rather than one at a time
+    std::mutex copiedMutex;
+    std::vector<uint256> copied;
+    auto lastRecorded = std::chrono::steady_clock::now();
+    auto recordCopied = [&](std::optional<uint256> const& hash) {
+        std::vector<uint256> batch;
+        {
+            std::lock_guard lock(copiedMutex);
+            if (hash)
+                copied.push_back(*hash);
+
+            auto const now = std::chrono::steady_clock::now();
+            if (hash && copied.size() < copiedBatchSize_ &&
+                now - lastRecorded < copiedBatchInterval_)
+                return;
+            lastRecorded = now;
+            batch.swap(copied);
+        }
+        if (!batch.empty())
+            state_db_.addCopiedSubtrees(writableDb, batch);
+    };
+
+    // Each slice takes the next subtree until none are left, so there are
+    // as many copying at once as slices, however the subtrees vary in size
+    std::atomic<std::size_t> next = 0;
+    auto work = [&](std::size_t, std::size_t) {
+        try
+        {
+            for (std::size_t i = next++; i < subtrees.size() && !abort;
+                 i = next++)
+            {
+                map.visitNodes(subtrees[i], copy);
+                if (abort)
+                    return;
+
+                // Every node below is in the writable backend now
+                recordCopied(subtrees[i]->getHash().as_uint256());
+                ++copyProgress_.subtreesCopied;
+            }
+        }
+        catch (...)
+        {
+            abort = true;
+            throw;
+        }
+    };
+
+    try
+    {
+        app_.getJobQueue().parallelFor(
+            jtCOPY_LEDGER, "SHAMapStore::copyMap", copyThreads_, 1, work);
+
+        // Those copied so far are kept even if the copy is cut short, so
+        // that the next attempt can resume
+        recordCopied(std::nullopt);
+    }
+    catch (...)
+    {
+        copyProgress_.ledger = 0;
+        recordCopied(std::nullopt);
+        throw;
+    }
+
+    copyProgress_.ledger = 0;
+
+    if (abort)
+        return std::nullopt;
+
+    return copyProgress_.nodes.load();
+}
+
 void
 SHAMapStoreImp::run()
 {
@@ -323,16 +557,13 @@ SHAMapStoreImp::run()
                 return;
 
             JLOG(journal_.debug()) << "copying ledger " << validatedSeq;
-            std::uint64_t nodeCount = 0;
+            std::optional<std::uint64_t> nodeCount;
 
             try
             {
-                validatedLedger->stateMap().snapShot(false)->visitNodes(
-                    std::bind(
-                        &SHAMapStoreImp::copyNode,
-                        this,
-                        std::ref(nodeCount),
-                        std::placeholders::_1));
+                nodeCount = copyMap(
+                    *validatedLedger->stateMap().snapShot(false),
+                    validatedSeq);
             }
             catch (SHAMapMissingNode const& e)
             {
@@ -342,11 +573,11 @@ SHAMapStoreImp::run()
                 continue;
             }
 
-            if (healthWait() == stopping)
+            if (!nodeCount || healthWait() == stopping)
                 return;
             // Only log if we completed without a "health" abort
             JLOG(journal_.debug()) << "copied ledger " << validatedSeq
-                                   << " nodecount " << nodeCount;
+                                   << " nodecount " << *nodeCount;
 
             JLOG(journal_.debug()) << "freshening caches";
             freshenCaches();
@@ -376,6 +607,9 @@ SHAMapStoreImp::run()
                     savedState.lastRotated = lastRotated;
                     state_db_.setState(savedState);
 
+                    // The copied subtrees are in the backend being retired
+                    state_db_.clearCopiedSubtrees();
+
                     clearCaches(validatedSeq);
                 });
 
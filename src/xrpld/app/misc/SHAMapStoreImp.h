@@ -29,6 +29,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <optional>
 #include <thread>
 
 namespace ripple {
@@ -65,6 +67,47 @@ private:
         setState(SavedState const& state);
         void
         setLastRotated(LedgerIndex seq);
+        std::vector<uint256>
+        getCopiedSubtrees(std::string const& writableDb);
+        void
+        addCopiedSubtrees(
+            std::string const& writableDb,
+            std::vector<uint256> const& hashes);
+        void
+        clearCopiedSubtrees();
+    };
+
+    /** Paces the copy to a budget of bytes and operations per second.
+
+        The threads that copy share the budget. A rate of zero is not
+        limited.
+    */
+    class Throttle
+    {
+        std::mutex mutex_;
+        std::chrono::steady_clock::time_point next_{};
+        std::uint64_t bytesPerSecond_ = 0;
+        std::uint64_t opsPerSecond_ = 0;
+
+    public:
+        void
+        setRates(std::uint64_t bytesPerSecond, std::uint64_t opsPerSecond);
+
+        // Charge one operation of the given size, sleeping if over budget
+        void
+        charge(std::size_t bytes);
+    };
+
+    // Progress of the ledger being copied forward, for server_info
+    struct CopyProgress
+    {
+        std::atomic<LedgerIndex> ledger{0};
+        std::atomic<std::chrono::steady_clock::time_point> start{};
+        std::atomic<std::uint32_t> subtrees{0};
+        std::atomic<std::uint32_t> subtreesSkipped{0};
+        std::atomic<std::uint32_t> subtreesCopied{0};
+        std::atomic<std::uint64_t> nodes{0};
+        std::atomic<std::uint64_t> bytes{0};
     };
 
     Application& app_;
@@ -75,6 +118,13 @@ private:
     std::string const dbPrefix_ = "rippledb";
     // check health/stop status as records are copied
     std::uint64_t const checkHealthInterval_ = 1000;
+    // depth of the subtrees that are copied in parallel, and recorded as
+    // copied so that an interrupted copy can resume
+    static int const copySplitDepth_ = 3;
+    // the most copied subtrees, and the longest time, to wait before
+    // recording those copied in one transaction
+    static std::size_t const copiedBatchSize_ = 64;
+    static constexpr std::chrono::seconds copiedBatchInterval_{5};
     // minimum # of ledgers to maintain for health of network
     static std::uint32_t const minimumDeletionInterval_ = 256;
     // minimum # of ledgers required for standalone mode.
@@ -107,6 +157,9 @@ private:
     /// recovery.
     /// See also: "recovery_wait_seconds" in rippled-example.cfg
     std::chrono::seconds recoveryWaitTime_{5};
+    std::uint32_t copyThreads_ = 4;
+    Throttle throttle_;
+    CopyProgress copyProgress_;
 
     // these do not exist upon SHAMapStore creation, but do exist
     // as of run() or before
@@ -174,10 +227,25 @@ public:
     std::optional<LedgerIndex>
     minimumOnline() const override;
 
+    Json::Value
+    getCopyProgress() const override;
+
 private:
     // callback for visitNodes
     bool
-    copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node);
+    copyNode(SHAMapTreeNode const& node);
+
+    /** Copy every node of a map into the writable backend, in parallel on
+        the JobQueue.
+
+        Subtrees recorded as copied by an earlier, interrupted attempt are
+        skipped.
+
+        @return The number of nodes copied, or nothing if the server is
+                stopping.
+    */
+    std::optional<std::uint64_t>
+    copyMap(SHAMap const& map, LedgerIndex seq);
     void
     run();
     void
@@ -33,6 +33,7 @@
 #include <boost/intrusive/set.hpp>
 
 #include <optional>
+#include <vector>
 
 namespace ripple {
 
@@ -278,6 +279,21 @@ public:
         ApplyFlags flags,
         beast::Journal j);
 
+    /**
+        Add a new transaction, as `apply` does, after its `preflight`.
+
+        The `preflight` may have been done on another thread, before the
+        view was locked. It is done again if the rules of the view are not
+        the ones it was done with.
+    */
+    ApplyResult
+    apply(
+        Application& app,
+        OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+        PreflightResult const& pfresult,
+        beast::Journal j);
+
     /**
         Fill the new open ledger with transactions from the queue.
 
@@ -426,6 +442,8 @@ private:
 
             @param app Rippled Application object.
             @param view View of the LCL that was just closed or received.
+            @param feeLevels The fee levels paid by the transactions in
+            `view`, sorted.
             @param timeLeap Indicates that rippled is under load so fees
             should grow faster.
             @param setup Customization params.
@@ -434,6 +452,7 @@ private:
         update(
             Application& app,
             ReadView const& view,
+            std::vector<FeeLevel64> const& feeLevels,
             bool timeLeap,
             TxQ::Setup const& setup);
 
@@ -602,6 +621,15 @@ private:
         ApplyResult
         apply(Application& app, OpenView& view, beast::Journal j);
 
+        /** Whether the last attempt to apply the transaction failed because
+            the account's sequence had not reached it, and still has not.
+
+            Applying it again would fail the same way, so the attempt can
+            be skipped. Only the account's root is read.
+        */
+        bool
+        seqStillAhead(ReadView const& view) const;
+
         /// Potential @ref TxConsequences of applying this transaction
         /// to the open ledger.
         TxConsequences const&
@@ -738,7 +766,7 @@ private:
         Application& app,
         OpenView& view,
         std::shared_ptr<STTx const> const& tx,
-        ApplyFlags flags,
+        PreflightResult const& pfresult,
         beast::Journal j);
 
     // Helper function that removes a replaced entry in _byFee.
@@ -63,6 +63,18 @@ getFeeLevelPaid(ReadView const& view, STTx const& tx)
         .value_or(FeeLevel64(std::numeric_limits<std::uint64_t>::max()));
 }
 
+// Reading the transactions of a ledger is costly, so this is done once, and
+// before any lock is taken
+static std::vector<FeeLevel64>
+getFeeLevelsPaid(ReadView const& view)
+{
+    std::vector<FeeLevel64> feeLevels;
+    for (auto const& tx : view.txs)
+        feeLevels.push_back(getFeeLevelPaid(view, *tx.first));
+    std::sort(feeLevels.begin(), feeLevels.end());
+    return feeLevels;
+}
+
 static std::optional<LedgerIndex>
 getLastLedgerSequence(STTx const& tx)
 {
@@ -84,21 +96,14 @@ std::size_t
 TxQ::FeeMetrics::update(
     Application& app,
     ReadView const& view,
+    std::vector<FeeLevel64> const& feeLevels,
     bool timeLeap,
     TxQ::Setup const& setup)
 {
-    std::vector<FeeLevel64> feeLevels;
-    auto const txBegin = view.txs.begin();
-    auto const txEnd = view.txs.end();
-    auto const size = std::distance(txBegin, txEnd);
-    feeLevels.reserve(size);
-    std::for_each(txBegin, txEnd, [&](auto const& tx) {
-        feeLevels.push_back(getFeeLevelPaid(view, *tx.first));
-    });
-    std::sort(feeLevels.begin(), feeLevels.end());
+    auto const size = feeLevels.size();
     XRPL_ASSERT(
-        size == feeLevels.size(),
-        "ripple::TxQ::FeeMetrics::update : fee levels size");
+        std::is_sorted(feeLevels.begin(), feeLevels.end()),
+        "ripple::TxQ::FeeMetrics::update : fee levels sorted");
 
     JLOG((timeLeap ? j_.warn() : j_.debug()))
         << "Ledger " << view.info().seq << " has " << size << " transactions. "
@@ -318,6 +323,28 @@ TxQ::MaybeTx::apply(Application& app, OpenView& view, beast::Journal j)
     return doApply(pcresult, app, view);
 }
 
+bool
+TxQ::MaybeTx::seqStillAhead(ReadView const& view) const
+{
+    if (!lastResult ||
+        (*lastResult != terPRE_SEQ && *lastResult != terPRE_TICKET))
+        return false;
+
+    // Preflight would run again, and its result may differ
+    if (pfresult->rules != view.rules() || pfresult->flags != flags)
+        return false;
+
+    // These are the checks of Transactor::checkSeqProxy that gave the result
+    auto const sle = view.read(keylet::account(account));
+    if (!sle)
+        return false;
+
+    SeqProxy const acctSeq = SeqProxy::sequence((*sle)[sfSequence]);
+    if (seqProxy.isSeq())
+        return acctSeq < seqProxy;
+    return acctSeq.value() <= seqProxy.value();
+}
+
 TxQ::TxQAccount::TxQAccount(std::shared_ptr<STTx const> const& txn)
     : TxQAccount(txn->getAccountID(sfAccount))
 {
@@ -740,13 +767,33 @@ TxQ::apply(
     // See if the transaction is valid, properly formed,
     // etc. before doing potentially expensive queue
     // replace and multi-transaction operations.
-    auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
+    return apply(app, view, tx, preflight(app, view.rules(), *tx, flags, j), j);
+}
+
+ApplyResult
+TxQ::apply(
+    Application& app,
+    OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+    PreflightResult const& pfresult,
+    beast::Journal j)
+{
+    XRPL_ASSERT(
+        &pfresult.tx == tx.get(),
+        "ripple::TxQ::apply : preflight of the transaction");
+    if (pfresult.rules != view.rules())
+        return apply(app, view, tx, pfresult.flags, j);
+
+    STAmountSO stAmountSO{view.rules().enabled(fixSTAmountCanonicalize)};
+    NumberSO stNumberSO{view.rules().enabled(fixUniversalNumber)};
+
+    auto flags = pfresult.flags;
     if (pfresult.ter != tesSUCCESS)
         return {pfresult.ter, false};
 
     // See if the transaction paid a high enough fee that it can go straight
     // into the ledger.
-    if (auto directApplied = tryDirectApply(app, view, tx, flags, j))
+    if (auto directApplied = tryDirectApply(app, view, tx, pfresult, j))
         return *directApplied;
 
     // If we get past tryDirectApply() without returning then we expect
@@ -1365,9 +1412,11 @@ TxQ::apply(
 void
 TxQ::processClosedLedger(Application& app, ReadView const& view, bool timeLeap)
 {
+    auto const feeLevels = getFeeLevelsPaid(view);
+
     std::lock_guard lock(mutex_);
 
-    feeMetrics_.update(app, view, timeLeap, setup_);
+    feeMetrics_.update(app, view, feeLevels, timeLeap, setup_);
     auto const& snapshot = feeMetrics_.getSnapshot();
 
     auto ledgerSeq = view.info().seq;
@@ -1475,8 +1524,12 @@ TxQ::accept(Application& app, OpenView& view)
             JLOG(j_.trace()) << "Applying queued transaction "
                              << candidateIter->txID << " to open ledger.";
 
+            // A transaction waiting on its account's sequence is only
+            // applied again once the sequence may have reached it
             auto const [txnResult, didApply, _metadata] =
-                candidateIter->apply(app, view, j_);
+                candidateIter->seqStillAhead(view)
+                ? ApplyResult{*candidateIter->lastResult, false}
+                : candidateIter->apply(app, view, j_);
 
             if (didApply)
             {
@@ -1575,26 +1628,40 @@ TxQ::accept(Application& app, OpenView& view)
     else
         parentHash_ = parentHash;
 
-    [[maybe_unused]] auto const startingSize = byFee_.size();
+    auto const startingSize = byFee_.size();
     // byFee_ doesn't "own" the candidate objects inside it, so it's
     // perfectly safe to wipe it and start over, repopulating from
     // byAccount_.
     //
     // In the absence of a "re-sort the list in place" function, this
-    // was the fastest method tried to repopulate the list.
-    // Other methods included: create a new list and moving items over one at a
-    // time, create a new list and merge the old list into it.
-    byFee_.clear();
-
-    MaybeTx::parentHashComp = parentHash;
-
+    // was the fastest method tried to repopulate the list: sort the
+    // candidates in a vector, then append them in order, which needs no
+    // searching or rebalancing of the tree. Other methods included: insert
+    // each candidate into the cleared list, create a new list and moving
+    // items over one at a time, create a new list and merge the old list
+    // into it.
+    std::vector<MaybeTx*> candidates;
+    candidates.reserve(startingSize);
     for (auto& [_, account] : byAccount_)
     {
         for (auto& [_, candidate] : account.transactions)
         {
-            byFee_.insert(candidate);
+            candidates.push_back(&candidate);
         }
     }
+
+    byFee_.clear();
+
+    MaybeTx::parentHashComp = parentHash;
+
+    std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [order = OrderCandidates{}](MaybeTx const* lhs, MaybeTx const* rhs) {
+            return order(*lhs, *rhs);
+        });
+    for (auto candidate : candidates)
+        byFee_.push_back(*candidate);
     XRPL_ASSERT(
         byFee_.size() == startingSize,
         "ripple::TxQ::accept : byFee size match");
@@ -1680,9 +1747,10 @@ TxQ::tryDirectApply(
     Application& app,
     OpenView& view,
     std::shared_ptr<STTx const> const& tx,
-    ApplyFlags flags,
+    PreflightResult const& pfresult,
     beast::Journal j)
 {
+    auto const flags = pfresult.flags;
     auto const account = (*tx)[sfAccount];
     auto const sleAccount = view.read(keylet::account(account));
 
@@ -1716,7 +1784,7 @@ TxQ::tryDirectApply(
                          << " to open ledger.";
 
         auto const [txnResult, didApply, metadata] =
-            ripple::apply(app, view, *tx, flags, j);
+            ripple::apply(app, view, pfresult);
 
         JLOG(j_.trace()) << "New transaction " << transactionID
                          << (didApply ? " applied successfully with "
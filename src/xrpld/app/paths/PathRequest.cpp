@@ -479,33 +479,88 @@ PathRequest::doAborting() const
     JLOG(m_journal.info()) << iIdentifier << " aborting early";
 }
 
-std::unique_ptr<Pathfinder> const&
+std::shared_ptr<Pathfinder>
+SharedPathfinders::get(
+    uint256 const& key,
+    std::function<std::shared_ptr<Pathfinder>()> const& build,
+    std::function<bool(void)> const& complete)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard sl(mutex_);
+        auto& e = entries_[key];
+        if (!e)
+            e = std::make_shared<Entry>();
+        entry = e;
+    }
+
+    std::lock_guard sl(entry->mutex);
+    if (entry->built)
+    {
+        ++reused_;
+        return entry->pathfinder;
+    }
+
+    auto pathfinder = build();
+    if (!complete || complete())
+    {
+        entry->built = true;
+        entry->pathfinder = pathfinder;
+    }
+    return pathfinder;
+}
+
+std::shared_ptr<Pathfinder> const&
 PathRequest::getPathFinder(
     std::shared_ptr<RippleLineCache> const& cache,
-    hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
+    hash_map<Currency, std::shared_ptr<Pathfinder>>& currency_map,
     Currency const& currency,
     STAmount const& dst_amount,
     int const level,
-    std::function<bool(void)> const& continueCallback)
+    std::function<bool(void)> const& continueCallback,
+    SharedPathfinders* shared)
 {
     auto i = currency_map.find(currency);
     if (i != currency_map.end())
         return i->second;
-    auto pathfinder = std::make_unique<Pathfinder>(
-        cache,
-        *raSrcAccount,
-        *raDstAccount,
-        currency,
-        std::nullopt,
-        dst_amount,
-        saSendMax,
-        domain,
-        app_);
-    if (pathfinder->findPaths(level, continueCallback))
-        pathfinder->computePathRanks(max_paths_, continueCallback);
-    else
-        pathfinder.reset();  // It's a bad request - clear it.
-    return currency_map[currency] = std::move(pathfinder);
+
+    auto build = [&]() {
+        auto pathfinder = std::make_shared<Pathfinder>(
+            cache,
+            *raSrcAccount,
+            *raDstAccount,
+            currency,
+            std::nullopt,
+            dst_amount,
+            saSendMax,
+            domain,
+            app_);
+        if (pathfinder->findPaths(level, continueCallback))
+            pathfinder->computePathRanks(max_paths_, continueCallback);
+        else
+            pathfinder.reset();  // It's a bad request - clear it.
+        return pathfinder;
+    };
+
+    if (!shared)
+        return currency_map[currency] = build();
+
+    // Everything the search depends on
+    Serializer s;
+    s.addBitString(*raSrcAccount);
+    s.addBitString(*raDstAccount);
+    s.addBitString(currency);
+    dst_amount.add(s);
+    s.add8(saSendMax ? 1 : 0);
+    if (saSendMax)
+        saSendMax->add(s);
+    s.add8(domain ? 1 : 0);
+    if (domain)
+        s.addBitString(*domain);
+    s.add32(level);
+
+    return currency_map[currency] =
+               shared->get(s.getSHA512Half(), build, continueCallback);
 }
 
 bool
@@ -513,7 +568,8 @@ PathRequest::findPaths(
     std::shared_ptr<RippleLineCache> const& cache,
     int const level,
     Json::Value& jvArray,
-    std::function<bool(void)> const& continueCallback)
+    std::function<bool(void)> const& continueCallback,
+    SharedPathfinders* shared)
 {
     auto sourceCurrencies = sciSourceCurrencies;
     if (sourceCurrencies.empty() && saSendMax)
@@ -537,7 +593,7 @@ PathRequest::findPaths(
     }
 
     auto const dst_amount = convertAmount(saDstAmount, convert_all_);
-    hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
+    hash_map<Currency, std::shared_ptr<Pathfinder>> currency_map;
     for (auto const& issue : sourceCurrencies)
     {
         if (continueCallback && !continueCallback())
@@ -552,7 +608,8 @@ PathRequest::findPaths(
             issue.currency,
             dst_amount,
             level,
-            continueCallback);
+            continueCallback,
+            shared);
         if (!pathfinder)
         {
             JLOG(m_journal.debug()) << iIdentifier << " No paths found";
@@ -675,7 +732,8 @@ Json::Value
 PathRequest::doUpdate(
     std::shared_ptr<RippleLineCache> const& cache,
     bool fast,
-    std::function<bool(void)> const& continueCallback)
+    std::function<bool(void)> const& continueCallback,
+    SharedPathfinders* shared)
 {
     using namespace std::chrono;
     JLOG(m_journal.debug())
@@ -744,7 +802,7 @@ PathRequest::doUpdate(
     JLOG(m_journal.debug()) << iIdentifier << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray, continueCallback))
+    if (findPaths(cache, iLevel, jvArray, continueCallback, shared))
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move(jvArray);
@@ -29,6 +29,7 @@
 #include <xrpl/json/json_value.h>
 #include <xrpl/protocol/UintTypes.h>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <optional>
@@ -46,6 +47,49 @@ class PathRequests;
 #define PFR_PJ_INVALID -1
 #define PFR_PJ_NOCHANGE 0
 
+/** Pathfinders shared by the requests updated against one ledger.
+
+    Requests which search from the same currency, between the same
+    accounts, for the same amount and at the same level, share one
+    Pathfinder, which the first of them to need it builds. The others wait
+    for it.
+*/
+class SharedPathfinders
+{
+public:
+    /** Return the Pathfinder for a search, building it if needed.
+
+        @param key Identifies the search
+        @param build Returns the Pathfinder, or null if the search is not
+                     valid
+        @param complete Called after building; returns false if the search
+                        was cut short, in which case it is not shared
+    */
+    std::shared_ptr<Pathfinder>
+    get(uint256 const& key,
+        std::function<std::shared_ptr<Pathfinder>()> const& build,
+        std::function<bool(void)> const& complete);
+
+    /** The number of searches that were shared rather than built. */
+    std::size_t
+    reused() const
+    {
+        return reused_;
+    }
+
+private:
+    struct Entry
+    {
+        std::mutex mutex;
+        bool built = false;
+        std::shared_ptr<Pathfinder> pathfinder;
+    };
+
+    std::mutex mutex_;
+    hash_map<uint256, std::shared_ptr<Entry>> entries_;
+    std::atomic<std::size_t> reused_{0};
+};
+
 class PathRequest final : public InfoSubRequest,
                           public std::enable_shared_from_this<PathRequest>,
                           public CountedObject<PathRequest>
@@ -102,7 +146,8 @@ public:
     doUpdate(
         std::shared_ptr<RippleLineCache> const&,
         bool fast,
-        std::function<bool(void)> const& continueCallback = {});
+        std::function<bool(void)> const& continueCallback = {},
+        SharedPathfinders* shared = nullptr);
     InfoSub::pointer
     getSubscriber() const;
     bool
@@ -112,14 +157,15 @@ private:
     bool
     isValid(std::shared_ptr<RippleLineCache> const& crCache);
 
-    std::unique_ptr<Pathfinder> const&
+    std::shared_ptr<Pathfinder> const&
     getPathFinder(
         std::shared_ptr<RippleLineCache> const&,
-        hash_map<Currency, std::unique_ptr<Pathfinder>>&,
+        hash_map<Currency, std::shared_ptr<Pathfinder>>&,
         Currency const&,
         STAmount const&,
         int const,
-        std::function<bool(void)> const&);
+        std::function<bool(void)> const&,
+        SharedPathfinders*);
 
     /** Finds and sets a PathSet in the JSON argument.
         Returns false if the source currencies are inavlid.
@@ -129,7 +175,8 @@ private:
         std::shared_ptr<RippleLineCache> const&,
         int const,
         Json::Value&,
-        std::function<bool(void)> const&);
+        std::function<bool(void)> const&,
+        SharedPathfinders*);
 
     int
     parseJson(Json::Value const&);
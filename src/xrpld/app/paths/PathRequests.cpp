@@ -28,6 +28,7 @@
 #include <xrpl/protocol/jss.h>
 
 #include <algorithm>
+#include <atomic>
 
 namespace ripple {
 
@@ -41,7 +42,7 @@ PathRequests::getLineCache(
 {
     std::lock_guard sl(mLock);
 
-    auto lineCache = lineCache_.lock();
+    auto lineCache = lineCache_;
 
     std::uint32_t const lineSeq = lineCache ? lineCache->getLedger()->seq() : 0;
     std::uint32_t const lgrSeq = ledger->seq();
@@ -56,11 +57,13 @@ PathRequests::getLineCache(
     {
         JLOG(mJournal.debug())
             << "getLineCache creating new cache for " << lgrSeq;
-        // Assign to the local before the member, because the member is a
-        // weak_ptr, and will immediately discard it if there are no other
-        // references.
-        lineCache_ = lineCache = std::make_shared<RippleLineCache>(
-            ledger, app_.journal("RippleLineCache"));
+        auto const j = app_.journal("RippleLineCache");
+        if (lineCache)
+            lineCache =
+                std::make_shared<RippleLineCache>(ledger, *lineCache, j);
+        else
+            lineCache = std::make_shared<RippleLineCache>(ledger, j);
+        lineCache_ = lineCache;
     }
     return lineCache;
 }
@@ -82,12 +85,12 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
     }
 
     bool newRequests = app_.getLedgerMaster().isNewPathRequest();
-    bool mustBreak = false;
 
     JLOG(mJournal.trace()) << "updateAll seq=" << cache->getLedger()->seq()
                            << ", " << requests.size() << " requests";
 
-    int processed = 0, removed = 0;
+    std::atomic<int> processed = 0;
+    int removed = 0;
 
     auto getSubscriber =
         [](PathRequest::pointer const& request) -> InfoSub::pointer {
@@ -100,90 +103,140 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
         return nullptr;
     };
 
+    // Update a request, and return whether it should be removed
+    auto updateRequest = [&](PathRequest::pointer const& request,
+                             SharedPathfinders& shared) {
+        auto continueCallback = [&getSubscriber, &request]() {
+            // This callback is used by doUpdate to determine whether to
+            // continue working. If getSubscriber returns null, that
+            // indicates that this request is no longer relevant.
+            return (bool)getSubscriber(request);
+        };
+        if (!request->needsUpdate(newRequests, cache->getLedger()->seq()))
+            return false;
+
+        if (auto ipSub = getSubscriber(request))
+        {
+            if (!ipSub->getConsumer().warn())
+            {
+                // Release the shared ptr to the subscriber so that
+                // it can be freed if the client disconnects, and
+                // thus fail to lock later.
+                ipSub.reset();
+                Json::Value update =
+                    request->doUpdate(cache, false, continueCallback, &shared);
+                request->updateComplete();
+                update[jss::type] = "path_find";
+                if ((ipSub = getSubscriber(request)))
+                {
+                    ipSub->send(update, false);
+                    ++processed;
+                    return false;
+                }
+            }
+        }
+        else if (request->hasCompletion())
+        {
+            // One-shot request with completion function
+            request->doUpdate(cache, false, {}, &shared);
+            request->updateComplete();
+            ++processed;
+        }
+        return true;
+    };
+
+    std::size_t const threads = app_.config().PATH_SEARCH_THREADS;
+
     do
     {
         JLOG(mJournal.trace()) << "updateAll looping";
-        for (auto const& wr : requests)
-        {
-            if (app_.getJobQueue().isStopping())
-                break;
 
-            auto request = wr.lock();
-            bool remove = true;
-            JLOG(mJournal.trace())
-                << "updateAll request " << (request ? "" : "not ") << "found";
+        // Requests for the same paths, on this pass's ledger, share them
+        SharedPathfinders shared;
+
+        // Requests are taken in order by the threads, so that none waits
+        // behind the slow requests of another client
+        std::atomic<std::size_t> next = 0;
+        std::atomic<bool> stop = false;
+        std::atomic<bool> mustBreak = false;
+        std::vector<char> removals(requests.size(), 0);
+        std::vector<PathRequest::pointer> removing(requests.size());
 
-            if (request)
+        auto work = [&](std::size_t, std::size_t) {
+            for (std::size_t i; !stop && (i = next++) < requests.size();)
             {
-                auto continueCallback = [&getSubscriber, &request]() {
-                    // This callback is used by doUpdate to determine whether to
-                    // continue working. If getSubscriber returns null, that
-                    // indicates that this request is no longer relevant.
-                    return (bool)getSubscriber(request);
-                };
-                if (!request->needsUpdate(
-                        newRequests, cache->getLedger()->seq()))
+                if (app_.getJobQueue().isStopping())
+                {
+                    stop = true;
+                    break;
+                }
+
+                auto request = requests[i].lock();
+                JLOG(mJournal.trace()) << "updateAll request "
+                                       << (request ? "" : "not ") << "found";
+
+                bool remove = true;
+                try
+                {
+                    remove = !request || updateRequest(request, shared);
+                }
+                catch (std::exception const& ex)
+                {
+                    JLOG(mJournal.warn())
+                        << "updateAll request throws: " << ex.what();
                     remove = false;
-                else
+                }
+
+                if (remove)
                 {
-                    if (auto ipSub = getSubscriber(request))
-                    {
-                        if (!ipSub->getConsumer().warn())
-                        {
-                            // Release the shared ptr to the subscriber so that
-                            // it can be freed if the client disconnects, and
-                            // thus fail to lock later.
-                            ipSub.reset();
-                            Json::Value update = request->doUpdate(
-                                cache, false, continueCallback);
-                            request->updateComplete();
-                            update[jss::type] = "path_find";
-                            if ((ipSub = getSubscriber(request)))
-                            {
-                                ipSub->send(update, false);
-                                remove = false;
-                                ++processed;
-                            }
-                        }
-                    }
-                    else if (request->hasCompletion())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate(cache, false);
-                        request->updateComplete();
-                        ++processed;
-                    }
+                    removals[i] = 1;
+                    removing[i] = std::move(request);
                 }
-            }
 
-            if (remove)
-            {
-                std::lock_guard sl(mLock);
-
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if(
-                    requests_.begin(),
-                    requests_.end(),
-                    [&removed, &request](auto const& wl) {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase(ret, requests_.end());
+                // We weren't handling new requests and then
+                // there was a new request
+                if (!newRequests && app_.getLedgerMaster().isNewPathRequest())
+                {
+                    mustBreak = true;
+                    stop = true;
+                }
             }
+        };
+
+        if (threads > 1 && requests.size() > 1)
+            app_.getJobQueue().parallelFor(
+                jtPATH_REQUEST,
+                "PathRequests::updateAll",
+                std::min(threads, requests.size()),
+                1,
+                work);
+        else
+            work(0, 1);
 
-            mustBreak =
-                !newRequests && app_.getLedgerMaster().isNewPathRequest();
+        JLOG(mJournal.debug()) << "updateAll shared " << shared.reused()
+                               << " path searches";
 
-            // We weren't handling new requests and then
-            // there was a new request
-            if (mustBreak)
-                break;
+        if (std::find(removals.begin(), removals.end(), 1) != removals.end())
+        {
+            std::lock_guard sl(mLock);
+
+            // Remove any dangling weak pointers or weak
+            // pointers that refer to these path requests.
+            auto ret = std::remove_if(
+                requests_.begin(),
+                requests_.end(),
+                [&removed, &removing](auto const& wl) {
+                    auto r = wl.lock();
+
+                    if (r &&
+                        std::find(removing.begin(), removing.end(), r) ==
+                            removing.end())
+                        return false;
+                    ++removed;
+                    return true;
+                });
+
+            requests_.erase(ret, requests_.end());
         }
 
         if (mustBreak)
@@ -216,7 +269,16 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
         }
     } while (!app_.getJobQueue().isStopping());
 
-    JLOG(mJournal.debug()) << "updateAll complete: " << processed
+    {
+        // Without requests, no ledger's cache needs to start from this one.
+        // Destroy it outside of the lock.
+        std::shared_ptr<RippleLineCache> lastCache;
+        std::lock_guard sl(mLock);
+        if (requests_.empty())
+            lastCache = std::move(lineCache_);
+    }
+
+    JLOG(mJournal.debug()) << "updateAll complete: " << processed.load()
                            << " processed and " << removed << " removed";
 }
 
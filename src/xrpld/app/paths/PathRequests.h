@@ -111,8 +111,9 @@ private:
     // Track all requests
     std::vector<PathRequest::wptr> requests_;
 
-    // Use a RippleLineCache
-    std::weak_ptr<RippleLineCache> lineCache_;
+    // The RippleLineCache for the latest ledger, kept while there are
+    // requests so that the next ledger's cache can start from it
+    std::shared_ptr<RippleLineCache> lineCache_;
 
     std::atomic<int> mLastIdentifier;
 
@@ -156,6 +156,32 @@ smallestUsefulAmount(STAmount const& amount, int maxPaths)
 {
     return divide(amount, STAmount(maxPaths + 2), amount.issue());
 }
+
+// Whether a path failed for a reason that does not depend on the amount, so
+// that it would fail for any amount
+bool
+failsForAnyAmount(TER result)
+{
+    return isTemMalformed(result) || result == terNO_LINE ||
+        result == terNO_RIPPLE || result == terNO_ACCOUNT;
+}
+
+void
+addPath(Serializer& s, STPath const& path)
+{
+    s.add32(static_cast<std::uint32_t>(path.size()));
+    for (auto const& element : path)
+    {
+        auto const type = element.getNodeType();
+        s.add8(type);
+        if (type & STPathElement::typeAccount)
+            s.addBitString(element.getAccountID());
+        if (type & STPathElement::typeCurrency)
+            s.addBitString(element.getCurrency());
+        if (type & STPathElement::typeIssuer)
+            s.addBitString(element.getIssuerID());
+    }
+}
 }  // namespace
 
 Pathfinder::Pathfinder(
@@ -352,6 +378,55 @@ Pathfinder::getPathLiquidity(
                                    //      deliver to be worth keeping.
     STAmount& amountOut,           // OUT: The actual liquidity along the path.
     uint64_t& qualityOut) const    // OUT: The returned initial quality
+{
+    // What the liquidity depends on, but for the amounts
+    Serializer s;
+    s.addBitString(mSrcAccount);
+    s.addBitString(mDstAccount);
+    mSrcAmount.add(s);
+    s.addBitString(mDstAmount.getCurrency());
+    s.addBitString(mDstAmount.getIssuer());
+    s.add8(mDomain ? 1 : 0);
+    if (mDomain)
+        s.addBitString(*mDomain);
+    addPath(s, path);
+
+    // A path which can't be used for any amount is not tried again
+    auto const pathKey = s.getSHA512Half();
+    if (auto const known = mRLCache->getPathLiquidity(pathKey))
+        return known->result;
+
+    minDstAmount.add(s);
+    mDstAmount.add(s);
+    s.add8(convert_all_ ? 1 : 0);
+    auto const key = s.getSHA512Half();
+    if (auto const known = mRLCache->getPathLiquidity(key))
+    {
+        if (known->result == tesSUCCESS)
+        {
+            amountOut = known->amount;
+            qualityOut = known->quality;
+        }
+        return known->result;
+    }
+
+    auto const result =
+        computePathLiquidity(path, minDstAmount, amountOut, qualityOut);
+    if (failsForAnyAmount(result))
+        mRLCache->setPathLiquidity(pathKey, {result, {}, 0});
+    else if (result == tesSUCCESS)
+        mRLCache->setPathLiquidity(key, {result, amountOut, qualityOut});
+    else if (result != tefEXCEPTION)
+        mRLCache->setPathLiquidity(key, {result, {}, 0});
+    return result;
+}
+
+TER
+Pathfinder::computePathLiquidity(
+    STPath const& path,
+    STAmount const& minDstAmount,
+    STAmount& amountOut,
+    uint64_t& qualityOut) const
 {
     STPathSet pathSet;
     pathSet.push_back(path);
@@ -733,10 +808,28 @@ Pathfinder::getPathsOut(
     if (!inserted)
         return it->second;
 
+    // Another Pathfinder on this ledger may have counted them
+    Serializer s;
+    s.addBitString(currency);
+    s.addBitString(account);
+    s.add8(direction == LineDirection::outgoing ? 1 : 0);
+    s.add8(isDstCurrency ? 1 : 0);
+    if (isDstCurrency)
+        s.addBitString(dstAccount);
+    s.add8(mDomain ? 1 : 0);
+    if (mDomain)
+        s.addBitString(*mDomain);
+    auto const key = s.getSHA512Half();
+    if (auto const count = mRLCache->getPathsOut(key))
+        return it->second = *count;
+
     auto sleAccount = mLedger->read(keylet::account(account));
 
     if (!sleAccount)
+    {
+        mRLCache->setPathsOut(key, 0);
         return 0;
+    }
 
     int aFlags = sleAccount->getFieldU32(sfFlags);
     bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
@@ -782,6 +875,7 @@ Pathfinder::getPathsOut(
             }
         }
     }
+    mRLCache->setPathsOut(key, count);
     it->second = count;
     return count;
 }
@@ -128,7 +128,8 @@ private:
       computePathRanks:
           rippleCalculate
           getPathLiquidity:
-              rippleCalculate
+              computePathLiquidity:
+                  rippleCalculate
 
       getBestPaths
      */
@@ -176,6 +177,15 @@ private:
         STAmount& amountOut,           // OUT: The actual liquidity on the path.
         uint64_t& qualityOut) const;   // OUT: The returned initial quality
 
+    // Compute the liquidity for a path, without looking for a result found
+    // earlier on the same ledger.
+    TER
+    computePathLiquidity(
+        STPath const& path,
+        STAmount const& minDstAmount,
+        STAmount& amountOut,
+        uint64_t& qualityOut) const;
+
     // Does this path end on an account-to-account link whose last account has
     // set the "no ripple" flag on the link?
     bool
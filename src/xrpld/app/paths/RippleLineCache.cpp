@@ -20,6 +20,8 @@
 #include <xrpld/app/paths/RippleLineCache.h>
 #include <xrpld/app/paths/TrustLine.h>
 
+#include <xrpl/protocol/LedgerFormats.h>
+
 namespace ripple {
 
 RippleLineCache::RippleLineCache(
@@ -30,6 +32,69 @@ RippleLineCache::RippleLineCache(
     JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq;
 }
 
+RippleLineCache::RippleLineCache(
+    std::shared_ptr<ReadView const> const& ledger,
+    RippleLineCache& previous,
+    beast::Journal j)
+    : RippleLineCache(ledger, j)
+{
+    auto const& parent = previous.ledger_;
+    if (ledger_->open() || parent->open() ||
+        ledger_->seq() != parent->seq() + 1 ||
+        ledger_->info().parentHash != parent->info().hash)
+        return;
+
+    // The accounts whose trust lines the ledger's transactions changed
+    hash_set<AccountID> changed;
+    try
+    {
+        for (auto const& [tx, meta] : ledger_->txs)
+        {
+            if (!meta)
+                return;
+
+            for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+            {
+                if (node.getFieldU16(sfLedgerEntryType) != ltRIPPLE_STATE)
+                    continue;
+
+                auto const fields = dynamic_cast<STObject const*>(
+                    node.peekAtPField(
+                        node.getFName() == sfCreatedNode ? sfNewFields
+                                                         : sfFinalFields));
+                if (!fields)
+                    return;
+
+                if (auto const low = (*fields)[~sfLowLimit])
+                    changed.insert(low->getIssuer());
+                if (auto const high = (*fields)[~sfHighLimit])
+                    changed.insert(high->getIssuer());
+            }
+        }
+    }
+    catch (std::exception const& ex)
+    {
+        JLOG(journal_.info()) << "not reusing lines of ledger "
+                              << parent->seq() << ": " << ex.what();
+        return;
+    }
+
+    std::lock_guard sl(previous.mLock);
+    lines_.reserve(previous.lines_.size());
+    for (auto const& [key, lines] : previous.lines_)
+    {
+        if (changed.contains(key.account_))
+            continue;
+        lines_.emplace(key, lines);
+        if (lines)
+            totalLineCount_ += lines->size();
+    }
+
+    JLOG(journal_.debug()) << "reused lines of " << lines_.size() << " of "
+                           << previous.lines_.size() << " accounts from ledger "
+                           << parent->seq();
+}
+
 RippleLineCache::~RippleLineCache()
 {
     JLOG(journal_.debug()) << "destroyed for ledger " << ledger_->info().seq
@@ -130,4 +195,38 @@ RippleLineCache::getRippleLines(
     return it->second;
 }
 
+std::optional<int>
+RippleLineCache::getPathsOut(uint256 const& key)
+{
+    std::lock_guard sl(memoLock_);
+    if (auto const it = pathsOut_.find(key); it != pathsOut_.end())
+        return it->second;
+    return std::nullopt;
+}
+
+void
+RippleLineCache::setPathsOut(uint256 const& key, int count)
+{
+    std::lock_guard sl(memoLock_);
+    pathsOut_.emplace(key, count);
+}
+
+std::optional<RippleLineCache::PathLiquidity>
+RippleLineCache::getPathLiquidity(uint256 const& key)
+{
+    std::lock_guard sl(memoLock_);
+    if (auto const it = pathLiquidity_.find(key); it != pathLiquidity_.end())
+        return it->second;
+    return std::nullopt;
+}
+
+void
+RippleLineCache::setPathLiquidity(
+    uint256 const& key,
+    PathLiquidity const& liquidity)
+{
+    std::lock_guard sl(memoLock_);
+    pathLiquidity_.emplace(key, liquidity);
+}
+
 }  // namespace ripple
@@ -25,9 +25,12 @@
 
 #include <xrpl/basics/CountedObject.h>
 #include <xrpl/basics/hardened_hash.h>
+#include <xrpl/protocol/STAmount.h>
+#include <xrpl/protocol/TER.h>
 
 #include <cstddef>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace ripple {
@@ -39,6 +42,19 @@ public:
     explicit RippleLineCache(
         std::shared_ptr<ReadView const> const& l,
         beast::Journal j);
+
+    /** Create a cache which starts with the trust lines of a cache for the
+        parent ledger.
+
+        If `ledger` is the closed ledger following that of `previous`, the
+        lines of each account that no trust line changed in `ledger` are
+        shared with `previous`, and need not be read again.
+    */
+    RippleLineCache(
+        std::shared_ptr<ReadView const> const& ledger,
+        RippleLineCache& previous,
+        beast::Journal j);
+
     ~RippleLineCache();
 
     std::shared_ptr<ReadView const> const&
@@ -62,6 +78,35 @@ public:
     std::shared_ptr<std::vector<PathFindTrustLine>>
     getRippleLines(AccountID const& accountID, LineDirection direction);
 
+    /** The liquidity of a path, as found by a Pathfinder. */
+    struct PathLiquidity
+    {
+        TER result;
+        STAmount amount;
+        std::uint64_t quality = 0;
+    };
+
+    /** Results which Pathfinders searching this ledger share.
+
+        Each depends only on the ledger and on what its key is made from,
+        so a result found for one request is good for any other. None is
+        carried over to the cache of the next ledger.
+
+        @{
+    */
+    std::optional<int>
+    getPathsOut(uint256 const& key);
+
+    void
+    setPathsOut(uint256 const& key, int count);
+
+    std::optional<PathLiquidity>
+    getPathLiquidity(uint256 const& key);
+
+    void
+    setPathLiquidity(uint256 const& key, PathLiquidity const& liquidity);
+    /** @} */
+
 private:
     std::mutex mLock;
 
@@ -125,6 +170,10 @@ private:
         AccountKey::Hash>
         lines_;
     std::size_t totalLineCount_ = 0;
+
+    std::mutex memoLock_;
+    hash_map<uint256, int> pathsOut_;
+    hash_map<uint256, PathLiquidity> pathLiquidity_;
 };
 
 }  // namespace ripple
@@ -82,6 +82,25 @@ protected:
 
     std::optional<Cache> cache_;
 
+    // The transfer rates of the book's issuers, which no payment can change
+    mutable std::optional<Rate> transferRateIn_;
+    mutable std::optional<Rate> transferRateOut_;
+
+    Rate
+    issuerTransferRate(ReadView const& v, AccountID const& issuer) const
+    {
+        XRPL_ASSERT(
+            issuer == book_.in.account || issuer == book_.out.account,
+            "ripple::BookStep::issuerTransferRate : issuer of the book");
+        auto& rate = issuer == book_.in.account ? transferRateIn_
+                                                : transferRateOut_;
+        if (!flowCacheEnabled())
+            return transferRate(v, issuer);
+        if (!rate)
+            rate = transferRate(v, issuer);
+        return *rate;
+    }
+
     static uint32_t
     getMaxOffersToConsume(StrandContext const& ctx)
     {
@@ -147,6 +166,12 @@ public:
         return book_;
     }
 
+    bool
+    bookStepAMM() const override
+    {
+        return ammLiquidity_.has_value();
+    }
+
     std::pair<std::optional<Quality>, DebtDirection>
     qualityUpperBound(ReadView const& v, DebtDirection prevStepDir)
         const override;
@@ -342,7 +367,7 @@ public:
         auto rate = [&](AccountID const& id) {
             if (isXRP(id) || id == this->strandDst_)
                 return parityRate;
-            return transferRate(v, id);
+            return this->issuerTransferRate(v, id);
         };
 
         auto const trIn =
@@ -545,7 +570,7 @@ public:
         auto rate = [&](AccountID const& id) {
             if (isXRP(id) || id == this->strandDst_)
                 return parityRate;
-            return transferRate(v, id);
+            return this->issuerTransferRate(v, id);
         };
 
         auto const trIn =
@@ -728,7 +753,7 @@ BookStep<TIn, TOut, TDerived>::forEachOffer(
     auto rate = [this, &sb](AccountID const& id) -> std::uint32_t {
         if (isXRP(id) || id == this->strandDst_)
             return QUALITY_ONE;
-        return transferRate(sb, id).value;
+        return issuerTransferRate(sb, id).value;
     };
 
     std::uint32_t const trIn =
@@ -66,6 +66,19 @@ protected:
 
     std::optional<Cache> cache_;
 
+    // The transfer rate of src, which no payment can change
+    mutable std::optional<Rate> srcTransferRate_;
+
+    Rate
+    srcTransferRate(ReadView const& sb) const
+    {
+        if (!flowCacheEnabled())
+            return transferRate(sb, src_);
+        if (!srcTransferRate_)
+            srcTransferRate_ = transferRate(sb, src_);
+        return *srcTransferRate_;
+    }
+
     // Compute the maximum value that can flow from src->dst at
     // the best available quality.
     // return: first element is max amount that can flow,
@@ -795,7 +808,7 @@ DirectStepI<TDerived>::qualitiesSrcIssues(
         "issue");
 
     std::uint32_t const srcQOut = redeems(prevStepDebtDirection)
-        ? transferRate(sb, src_).value
+        ? srcTransferRate(sb).value
         : QUALITY_ONE;
     auto dstQIn =
         static_cast<TDerived const*>(this)->quality(sb, QualityDirection::in);
@@ -848,7 +861,7 @@ DirectStepI<TDerived>::qualityUpperBound(
     {
         std::uint32_t const srcQOut = [&]() -> std::uint32_t {
             if (redeems(prevStepDir) && issues(dir))
-                return transferRate(v, src_).value;
+                return srcTransferRate(v).value;
             return QUALITY_ONE;
         }();
         auto dstQIn = static_cast<TDerived const*>(this)->quality(
@@ -26,9 +26,24 @@
 #include <xrpl/protocol/XRPAmount.h>
 
 #include <algorithm>
+#include <atomic>
 
 namespace ripple {
 
+static std::atomic<bool> flowCache{true};
+
+bool
+flowCacheEnabled()
+{
+    return flowCache.load(std::memory_order_relaxed);
+}
+
+void
+setFlowCacheEnabled(bool enabled)
+{
+    flowCache = enabled;
+}
+
 // Check equal with tolerance
 bool
 checkNear(IOUAmount const& expected, IOUAmount const& actual)
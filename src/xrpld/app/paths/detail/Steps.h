@@ -56,6 +56,18 @@ issues(DebtDirection dir)
     return dir == DebtDirection::issues;
 }
 
+/** Whether flow keeps what it learned about a strand across iterations.
+
+    That is the strands' quality upper bounds and their steps' transfer
+    rates. Payments and offers have the same results either way; this is
+    turned off only to check that they do.
+*/
+bool
+flowCacheEnabled();
+
+void
+setFlowCacheEnabled(bool enabled);
+
 /**
    A step in a payment path
 
@@ -226,6 +238,16 @@ public:
         return std::nullopt;
     }
 
+    /**
+       If this step is a BookStep, return whether it also takes liquidity
+       from an AMM.
+    */
+    virtual bool
+    bookStepAMM() const
+    {
+        return false;
+    }
+
     /**
        Check if amount is zero
     */
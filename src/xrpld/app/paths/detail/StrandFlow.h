@@ -28,6 +28,8 @@
 #include <xrpld/app/paths/detail/FlatSets.h>
 #include <xrpld/app/paths/detail/FlowDebugInfo.h>
 #include <xrpld/app/paths/detail/Steps.h>
+#include <xrpld/ledger/PaymentSandbox.h>
+#include <xrpld/ledger/RecordingView.h>
 
 #include <xrpl/basics/Log.h>
 #include <xrpl/protocol/Feature.h>
@@ -38,7 +40,10 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <numeric>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -355,6 +360,83 @@ qualityUpperBound(ReadView const& v, Strand const& strand)
     }
     return q;
 };
+
+/** The quality upper bounds of strands, kept while what they were computed
+    from is unchanged.
+
+    A strand's bound depends on the entries its steps read, and on what the
+    steps kept from the last time the strand ran. So a bound is forgotten
+    when its strand runs, or when an entry it was computed from is written.
+    The bound of a strand through a book with an AMM is not kept, since the
+    AMM's offer also depends on the AMMContext.
+*/
+class StrandQualities
+{
+private:
+    struct Bound
+    {
+        std::optional<Quality> quality;
+        ReadSet reads;
+    };
+
+    std::map<Strand const*, Bound> bounds_;
+
+public:
+    /** Return the bound of a strand.
+
+        A bound that is computed is kept only if `keep` is set. It is not
+        worth recording what it was computed from when the strand is about
+        to run.
+    */
+    std::optional<Quality>
+    get(ReadView const& v, Strand const& strand, bool keep)
+    {
+        if (auto const it = bounds_.find(&strand); it != bounds_.end())
+            return it->second.quality;
+
+        // BookStep decides whether it uses an AMM when it is built
+        if (!keep || !flowCacheEnabled() ||
+            std::any_of(strand.begin(), strand.end(), [](auto const& step) {
+                return step->bookStepAMM();
+            }))
+            return qualityUpperBound(v, strand);
+
+        Bound bound;
+        RecordingView const recording(v, bound.reads);
+        bound.quality = qualityUpperBound(recording, strand);
+        return bounds_.emplace(&strand, std::move(bound)).first->second.quality;
+    }
+
+    // The strand ran, so its steps may have changed
+    void
+    ran(Strand const& strand)
+    {
+        bounds_.erase(&strand);
+    }
+
+    // The changes in `sb` are to be applied to the view the bounds were
+    // computed from
+    void
+    changed(PaymentSandbox const& sb)
+    {
+        if (bounds_.empty())
+            return;
+
+        std::vector<uint256> keys;
+        WriteRecorder recorder(keys);
+        sb.visitChanges(recorder);
+        std::set<uint256> const written(keys.begin(), keys.end());
+        std::erase_if(bounds_, [&written](auto const& bound) {
+            return bound.second.reads.changedBy(written);
+        });
+    }
+
+    void
+    clear()
+    {
+        bounds_.clear();
+    }
+};
 /// @endcond
 
 /// @cond INTERNAL
@@ -441,7 +523,10 @@ public:
     // Start a new iteration in the search for liquidity
     // Set the current strands to the strands in `next_`
     void
-    activateNext(ReadView const& v, std::optional<Quality> const& limitQuality)
+    activateNext(
+        ReadView const& v,
+        std::optional<Quality> const& limitQuality,
+        StrandQualities& qualities)
     {
         // add the strands in `next_` to `cur_`, sorted by theoretical quality.
         // Best quality first.
@@ -459,7 +544,7 @@ public:
                         // should not happen
                         continue;
                     }
-                    if (auto const qual = qualityUpperBound(v, *strand))
+                    if (auto const qual = qualities.get(v, *strand, true))
                     {
                         if (limitQuality && *qual < *limitQuality)
                         {
@@ -620,6 +705,7 @@ flow(
 
     // non-dry strands
     ActiveStrands activeStrands(strands);
+    StrandQualities strandQualities;
 
     // Keeping a running sum of the amount in the order they are processed
     // will not give the best precision. Keep a collection so they may be summed
@@ -649,7 +735,7 @@ flow(
             return {telFAILED_PROCESSING, std::move(ofrsToRmOnFail)};
         }
 
-        activeStrands.activateNext(sb, limitQuality);
+        activeStrands.activateNext(sb, limitQuality, strandQualities);
 
         ammContext.setMultiPath(activeStrands.size() > 1);
 
@@ -687,12 +773,14 @@ flow(
             ammContext.clear();
             if (offerCrossing && limitQuality)
             {
-                auto const strandQ = qualityUpperBound(sb, *strand);
+                // The strand runs next, unless its bound rules it out
+                auto const strandQ = strandQualities.get(sb, *strand, false);
                 if (!strandQ || *strandQ < *limitQuality)
                     continue;
             }
             auto f = flow<TInAmt, TOutAmt>(
                 sb, *strand, remainingIn, limitRemainingOut, j);
+            strandQualities.ran(*strand);
 
             // rm bad offers even if the strand fails
             SetUnion(ofrsToRm, f.ofrsToRm);
@@ -794,6 +882,7 @@ flow(
                             << " out: " << to_string(best->out)
                             << " remainingOut: " << to_string(remainingOut);
 
+            strandQualities.changed(best->sb);
             best->sb.apply(sb);
             ammContext.update();
         }
@@ -807,6 +896,7 @@ flow(
         if (!ofrsToRm.empty())
         {
             SetUnion(ofrsToRmOnFail, ofrsToRm);
+            strandQualities.clear();
             for (auto const& o : ofrsToRm)
             {
                 if (auto ok = sb.peek(keylet::offer(o)))
@@ -93,6 +93,37 @@ setSavedState(soci::session& session, SavedState const& state);
 void
 setLastRotated(soci::session& session, LedgerIndex seq);
 
+/**
+ * @brief getCopiedSubtrees Returns the hashes of the SHAMap subtrees that
+ *        have already been copied into a writable database.
+ * @param session Session with the database.
+ * @param writableDb The name of the writable database.
+ * @return The hashes of the subtrees.
+ */
+std::vector<uint256>
+getCopiedSubtrees(soci::session& session, std::string const& writableDb);
+
+/**
+ * @brief addCopiedSubtrees Records SHAMap subtrees that have been copied
+ *        into a writable database.
+ * @param session Session with the database.
+ * @param writableDb The name of the writable database.
+ * @param hashes The hashes of the subtrees.
+ */
+void
+addCopiedSubtrees(
+    soci::session& session,
+    std::string const& writableDb,
+    std::vector<uint256> const& hashes);
+
+/**
+ * @brief clearCopiedSubtrees Forgets every copied subtree, once the writable
+ *        database has been rotated out.
+ * @param session Session with the database.
+ */
+void
+clearCopiedSubtrees(soci::session& session);
+
 }  // namespace ripple
 
 #endif
@@ -43,6 +43,12 @@ initStateDB(
                "  CanDeleteSeq           INTEGER"
                ");";
 
+    session << "CREATE TABLE IF NOT EXISTS CopiedSubtrees ("
+               "  Hash                   CHARACTER(64),"
+               "  WritableDb             TEXT,"
+               "  PRIMARY KEY (Hash, WritableDb)"
+               ");";
+
     std::int64_t count = 0;
     {
         // SOCI requires boost::optional (not std::optional) as the parameter.
@@ -127,4 +133,47 @@ setLastRotated(soci::session& session, LedgerIndex seq)
         soci::use(seq);
 }
 
+std::vector<uint256>
+getCopiedSubtrees(soci::session& session, std::string const& writableDb)
+{
+    std::vector<uint256> hashes;
+    std::string hex;
+    soci::statement st =
+        (session.prepare << "SELECT Hash FROM CopiedSubtrees"
+                            " WHERE WritableDb = :writableDb;",
+         soci::into(hex),
+         soci::use(writableDb));
+    st.execute();
+    while (st.fetch())
+    {
+        uint256 hash;
+        if (hash.parseHex(hex))
+            hashes.push_back(hash);
+    }
+    return hashes;
+}
+
+void
+addCopiedSubtrees(
+    soci::session& session,
+    std::string const& writableDb,
+    std::vector<uint256> const& hashes)
+{
+    soci::transaction tr(session);
+    for (auto const& hash : hashes)
+    {
+        auto const hex = to_string(hash);
+        session << "INSERT OR IGNORE INTO CopiedSubtrees"
+                   " VALUES (:hash, :writableDb);",
+            soci::use(hex), soci::use(writableDb);
+    }
+    tr.commit();
+}
+
+void
+clearCopiedSubtrees(soci::session& session)
+{
+    session << "DELETE FROM CopiedSubtrees;";
+}
+
 }  // namespace ripple
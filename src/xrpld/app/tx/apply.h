@@ -27,12 +27,15 @@
 #include <xrpl/beast/utility/Journal.h>
 #include <xrpl/protocol/STTx.h>
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
 class Application;
 class HashRouter;
+class JobQueue;
 
 /** Describes the pre-processing validity of a transaction.
 
@@ -67,6 +70,25 @@ checkValidity(
     Rules const& rules,
     Config const& config);
 
+/** Checks the signatures and local checks of several transactions.
+
+    The transactions are split into slices, which are checked by jobs on
+    the job queue's threads as well as by the calling thread. The caller
+    takes slices until none are left, so it never waits for a job which
+    has yet to start, and may be a job itself.
+
+    Each transaction is checked as `checkValidity` checks one, and the
+    results are cached in the same way, so that calls for the single
+    transactions afterwards find them.
+*/
+void
+checkValidity(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules,
+    Config const& config,
+    JobQueue& jobQueue);
+
 /** Sets the validity of a given transaction in the cache.
 
     @warning Use with extreme care.
@@ -128,6 +150,17 @@ apply(
     ApplyFlags flags,
     beast::Journal journal);
 
+/** Apply a transaction to an `OpenView`, after its `preflight`.
+
+    The `preflight` may have been done on another thread, before the
+    view was locked. If the rules of the view are not the ones it was
+    done with, `preclaim` does it again.
+
+    @see apply
+*/
+ApplyResult
+apply(Application& app, OpenView& view, PreflightResult const& preflightResult);
+
 /** Enum class for return value from `applyTransaction`
 
     @see applyTransaction
@@ -333,7 +333,7 @@ applyCreate(
             auto const dir = keylet::quality(keylet::book(book), uRate);
             if (auto const bookExisted = static_cast<bool>(sb.read(dir));
                 !bookExisted)
-                ctx_.app.getOrderBookDB().addOrderBook(book);
+                ctx_.app.getOrderBookDB().addOrderBook(book, sb.seq());
         };
     addOrderBook(amount.issue(), amount2.issue(), getRate(amount2, amount));
     addOrderBook(amount2.issue(), amount.issue(), getRate(amount, amount2));
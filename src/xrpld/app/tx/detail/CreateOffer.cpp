@@ -1028,7 +1028,7 @@ CreateOffer::applyHybrid(
     bookArr.push_back(std::move(bookInfo));
 
     if (!bookExists)
-        ctx_.app.getOrderBookDB().addOrderBook(book);
+        ctx_.app.getOrderBookDB().addOrderBook(book, sb.seq());
 
     sleOffer->setFieldArray(sfAdditionalBooks, bookArr);
     return tesSUCCESS;
@@ -1379,7 +1379,7 @@ CreateOffer::applyGuts(Sandbox& sb, Sandbox& sbCancel)
     sb.insert(sleOffer);
 
     if (!bookExisted)
-        ctx_.app.getOrderBookDB().addOrderBook(book);
+        ctx_.app.getOrderBookDB().addOrderBook(book, sb.seq());
 
     JLOG(j_.debug()) << "final result: success";
 
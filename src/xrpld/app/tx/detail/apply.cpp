@@ -20,6 +20,7 @@
 #include <xrpld/app/misc/HashRouter.h>
 #include <xrpld/app/tx/apply.h>
 #include <xrpld/app/tx/applySteps.h>
+#include <xrpld/core/JobQueue.h>
 
 #include <xrpl/basics/Log.h>
 #include <xrpl/protocol/Feature.h>
@@ -109,6 +110,38 @@ checkValidity(
     return {Validity::Valid, ""};
 }
 
+void
+checkValidity(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules,
+    Config const& config,
+    JobQueue& jobQueue)
+{
+    // Large enough that taking a slice costs little beside checking it
+    constexpr std::size_t sliceSize = 16;
+
+    jobQueue.parallelFor(
+        jtTX_CHECK,
+        "checkValidity",
+        txs.size(),
+        sliceSize,
+        [&](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; ++i)
+            {
+                // An exception is thrown again when the transaction is
+                // checked on its own, where the caller handles it
+                try
+                {
+                    checkValidity(router, *txs[i], rules, config);
+                }
+                catch (std::exception const&)
+                {
+                }
+            }
+        });
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid, Validity validity)
 {
@@ -166,6 +199,12 @@ apply(
     });
 }
 
+ApplyResult
+apply(Application& app, OpenView& view, PreflightResult const& preflightResult)
+{
+    return apply(app, view, [&]() { return preflightResult; });
+}
+
 static bool
 applyBatchTransactions(
     Application& app,
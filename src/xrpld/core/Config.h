@@ -197,6 +197,10 @@ public:
     int PATH_SEARCH_FAST = 2;
     int PATH_SEARCH_MAX = 3;
 
+    // The number of threads which update pathfinding requests on each
+    // ledger. With more than one, requests are updated in parallel.
+    std::size_t PATH_SEARCH_THREADS = 1;
+
     // Validation
     std::optional<std::size_t>
         VALIDATION_QUORUM;  // validations to consider ledger authoritative
@@ -234,6 +238,20 @@ public:
     int WORKERS = 0;           // jobqueue thread count. default: upto 6
     int IO_WORKERS = 0;        // io svc thread count. default: 2
     int PREFETCH_WORKERS = 0;  // prefetch thread count. default: 4
+    int FLUSH_WORKERS = 1;     // SHAMap flush thread count. default: 1
+
+    // Dispatch jobqueue jobs from per-worker queues rather than one set
+    bool WORK_STEALING = false;
+
+    // How the transactions of a consensus ledger are applied: one at a time,
+    // speculatively in parallel, or both, comparing the results
+    enum class LedgerApply { serial, parallel, verify };
+    LedgerApply LEDGER_APPLY = LedgerApply::serial;
+
+    // Log jobs which wait or run for this long, one in every JOB_TRACE_SAMPLE
+    // of them. Zero turns the trace off.
+    std::chrono::milliseconds JOB_TRACE_THRESHOLD{0};
+    std::uint32_t JOB_TRACE_SAMPLE = 1;
 
     // Can only be set in code, specifically unit tests
     bool FORCE_MULTI_THREAD = false;
@@ -51,10 +51,15 @@ struct ConfigSection
 #define SECTION_ELB_SUPPORT "elb_support"
 #define SECTION_FEE_DEFAULT "fee_default"
 #define SECTION_FETCH_DEPTH "fetch_depth"
+#define SECTION_FLUSH_WORKERS "flush_workers"
 #define SECTION_INSIGHT "insight"
 #define SECTION_IO_WORKERS "io_workers"
 #define SECTION_IPS "ips"
 #define SECTION_IPS_FIXED "ips_fixed"
+#define SECTION_JOB_POOLS "job_pools"
+#define SECTION_JOB_SCHEDULER "job_scheduler"
+#define SECTION_JOB_TRACE "job_trace"
+#define SECTION_LEDGER_APPLY "ledger_apply"
 #define SECTION_LEDGER_HISTORY "ledger_history"
 #define SECTION_LEDGER_REPLAY "ledger_replay"
 #define SECTION_MAX_TRANSACTIONS "max_transactions"
@@ -67,6 +72,7 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH "path_search"
 #define SECTION_PATH_SEARCH_FAST "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX "path_search_max"
+#define SECTION_PATH_SEARCH_THREADS "path_search_threads"
 #define SECTION_PEER_PRIVATE "peer_private"
 #define SECTION_PEERS_MAX "peers_max"
 #define SECTION_PEERS_IN_MAX "peers_in_max"
@@ -27,8 +27,20 @@
 
 #include <functional>
 
+#if (defined(__clang_major__) && __clang_major__ < 15)
+#include <experimental/source_location>
+#else
+#include <source_location>
+#endif
+
 namespace ripple {
 
+#if (defined(__clang_major__) && __clang_major__ < 15)
+using source_location = std::experimental::source_location;
+#else
+using std::source_location;
+#endif
+
 // Note that this queue should only be used for CPU-bound jobs
 // It is primarily intended for signature checking
 
@@ -41,6 +53,7 @@ enum JobType {
     // insert a job at a specific priority, simply add it at the right location.
 
     jtPACK,               // Make a fetch pack for a peer
+    jtCOPY_LEDGER,        // Copy a ledger forward before rotation
     jtPUBOLDLEDGER,       // An old ledger has been accepted
     jtCLIENT,             // A placeholder for the priority of all jtCLIENT jobs
     jtCLIENT_SUBSCRIBE,   // A websocket subscription by a client
@@ -54,12 +67,14 @@ enum JobType {
     jtVALIDATION_ut,      // A validation from an untrusted source
     jtMANIFEST,           // A validator's manifest
     jtUPDATE_PF,          // Update pathfinding requests
+    jtPATH_REQUEST,       // Update some of the pathfinding requests
     jtTRANSACTION_l,      // A local transaction
     jtREPLAY_REQ,         // Peer request a ledger delta or a skip list
     jtLEDGER_REQ,         // Peer request ledger/txnset data
     jtPROPOSAL_ut,        // A proposal from an untrusted source
     jtREPLAY_TASK,        // A Ledger replay task/subtask
     jtTRANSACTION,        // A transaction received from the network
+    jtTX_CHECK,           // Check signatures of received transactions
     jtMISSING_TXN,        // Request missing transactions
     jtREQUESTED_TXN,      // Reply with requested transactions
     jtBATCH,              // Apply batched transactions
@@ -117,11 +132,19 @@ public:
         std::string const& name,
         std::uint64_t index,
         LoadMonitor& lm,
-        std::function<void()> const& job);
+        std::function<void()> const& job,
+        source_location const& where = source_location::current());
 
     JobType
     getType() const;
 
+    std::string const&
+    getName() const;
+
+    /** Returns where the job was added to the queue. */
+    source_location const&
+    where() const;
+
     /** Returns the time when the job was queued. */
     clock_type::time_point const&
     queue_time() const;
@@ -147,6 +170,7 @@ private:
     std::shared_ptr<LoadEvent> m_loadEvent;
     std::string mName;
     clock_type::time_point m_queue_time;
+    source_location m_where;
 };
 
 using JobCounter = ClosureCounter<void>;
@@ -23,13 +23,17 @@
 #include <xrpld/core/ClosureCounter.h>
 #include <xrpld/core/JobTypeData.h>
 #include <xrpld/core/JobTypes.h>
+#include <xrpld/core/detail/WorkStealingPool.h>
 #include <xrpld/core/detail/Workers.h>
 
+#include <xrpl/basics/BasicConfig.h>
 #include <xrpl/basics/LocalValue.h>
 #include <xrpl/json/json_value.h>
 
 #include <boost/coroutine/all.hpp>
 
+#include <deque>
+
 namespace ripple {
 
 namespace perf {
@@ -42,6 +46,30 @@ struct Coro_create_t
     explicit Coro_create_t() = default;
 };
 
+/** A pool of threads which runs the jobs of some types only. */
+struct JobPoolSetup
+{
+    std::string name;
+    int threads = 0;
+    std::vector<JobType> types;
+
+    // The CPUs the threads are restricted to, or empty for any
+    std::vector<int> cpus;
+};
+
+/** Returns the pools declared in the [job_pools] section of a config.
+
+    Each name listed in [job_pools] is that of a section which sets the
+    `threads` of the pool, the `types` of job it runs by name, and
+    optionally the `cpus` its threads run on, as in "0-3,8". A pool named
+    `default` may set only `cpus`, for the threads which run every other
+    type.
+
+    @throws std::runtime_error if a pool is not valid.
+*/
+std::vector<JobPoolSetup>
+setup_JobPools(BasicConfig const& config);
+
 /** A pool of threads to perform work.
 
     A job posted will always run to completion.
@@ -51,8 +79,15 @@ struct Coro_create_t
 
     When the JobQueue stops, it waits for all jobs
     and coroutines to finish.
+
+    Jobs are either kept in one priority ordered set and run by Workers, or
+    handed to a WorkStealingPool, which keeps them itself.
+
+    Jobs of some types may be run by pools of threads of their own, so that
+    jobs which block, such as those reading ledgers from disk, do not hold
+    up those of other types. Each pool has its own set or WorkStealingPool.
 */
-class JobQueue : private Workers::Callback
+class JobQueue
 {
 public:
     /** Coroutines must run to completion. */
@@ -145,7 +180,9 @@ public:
         beast::insight::Collector::ptr const& collector,
         beast::Journal journal,
         Logs& logs,
-        perf::PerfLog& perfLog);
+        perf::PerfLog& perfLog,
+        bool workStealing = false,
+        std::vector<JobPoolSetup> const& pools = {});
     ~JobQueue();
 
     /** Adds a job to the JobQueue.
@@ -154,6 +191,7 @@ public:
         @param name Name of the job.
         @param jobHandler Lambda with signature void (Job&).  Called when the
        job is executed.
+        @param where The caller, which is reported if the job is slow.
 
         @return true if jobHandler added to queue.
     */
@@ -163,12 +201,17 @@ public:
             decltype(std::declval<JobHandler&&>()()),
             void>::value>>
     bool
-    addJob(JobType type, std::string const& name, JobHandler&& jobHandler)
+    addJob(
+        JobType type,
+        std::string const& name,
+        JobHandler&& jobHandler,
+        source_location const& where = source_location::current())
     {
         if (auto optionalCountedJob =
                 jobCounter_.wrap(std::forward<JobHandler>(jobHandler)))
         {
-            return addRefCountedJob(type, name, std::move(*optionalCountedJob));
+            return addRefCountedJob(
+                type, name, std::move(*optionalCountedJob), where);
         }
         return false;
     }
@@ -219,6 +262,44 @@ public:
     Json::Value
     getJson(int c = 0);
 
+    /** Add the latency histograms of each job type, and any slow jobs
+        traced, to the result of get_counts.
+    */
+    void
+    getCountsJson(Json::Value& obj);
+
+    /** Trace jobs which wait or run for at least a threshold.
+
+        One in every sampleEvery such jobs is logged, and kept with the
+        name of the caller which added it to be reported by getCountsJson.
+        A threshold of zero turns tracing off, which is the default.
+    */
+    void
+    setSlowJobTrace(
+        std::chrono::milliseconds threshold,
+        std::uint32_t sampleEvery = 1);
+
+    /** Calls a function for the slices of a range of indexes, on the
+        calling thread and on jobs.
+
+        The calling thread takes slices until none are left, and then waits
+        for those taken by jobs, so it never waits for a job which has yet
+        to start, and may be a job itself.
+
+        @param count The number of indexes, from zero.
+        @param sliceSize The number of indexes in each slice but the last.
+        @param f Called with the first index of a slice and one past its
+        last. If it throws, the slices not yet started are skipped, and the
+        first exception is rethrown once every slice started has finished.
+    */
+    void
+    parallelFor(
+        JobType type,
+        std::string const& name,
+        std::size_t count,
+        std::size_t sliceSize,
+        std::function<void(std::size_t, std::size_t)> const& f);
+
     /** Block until no jobs running. */
     void
     rendezvous();
@@ -242,23 +323,101 @@ private:
 
     using JobDataMap = std::map<JobType, JobTypeData>;
 
+    // Threads, and the jobs waiting for them
+    class Pool : public Workers::Callback, public WorkStealingPool::Callback
+    {
+    public:
+        Pool(
+            JobQueue& jq,
+            std::string const& name,
+            int threads,
+            std::vector<int> const& cpus,
+            bool workStealing,
+            int instanceBase);
+
+        JobQueue& jq;
+        std::string const name;
+        std::vector<int> const cpus;
+
+        // Added to the instances of a WorkStealingPool, which number its
+        // threads from zero, to tell the threads of every pool apart
+        int const instanceBase;
+
+        // Guarded by the JobQueue's mutex
+        std::set<Job> jobSet;
+        int processCount = 0;
+
+        // The time spent running jobs, for the utilization
+        std::atomic<std::uint64_t> busy{0};
+        beast::insight::Gauge utilization;
+
+        Workers workers;
+        std::unique_ptr<WorkStealingPool> stealing;
+
+        int
+        getNumberOfThreads() const;
+
+        // The percentage of its threads' time spent running jobs since the
+        // last sample, which is taken at most once a second
+        std::uint64_t
+        getUtilization();
+
+        bool
+        idle() const;
+
+    private:
+        void
+        processTask(int instance) override;
+
+        void
+        processJob(Job& job, int instance) override;
+
+        void
+        onThreadStart(int instance) override;
+
+        std::mutex sampleMutex_;
+        Job::clock_type::time_point sampled_;
+        std::uint64_t busySampled_ = 0;
+        std::uint64_t utilization_ = 0;
+    };
+
+    struct SlowJob
+    {
+        JobType type;
+        std::string name;
+        source_location where;
+        std::chrono::microseconds queued;
+        std::chrono::microseconds ran;
+        std::chrono::system_clock::time_point finished;
+    };
+
+    // The number of slow jobs kept for getCountsJson
+    static constexpr std::size_t slowJobsKept = 64;
+
     beast::Journal m_journal;
     mutable std::mutex m_mutex;
+
+    // Guards the counts kept by collect(), which reads the histograms
+    // without taking m_mutex
+    std::mutex collectMutex_;
+
     std::uint64_t m_lastJob;
-    std::set<Job> m_jobSet;
     JobCounter jobCounter_;
     std::atomic_bool stopping_{false};
     std::atomic_bool stopped_{false};
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
-    // The number of jobs currently in processTask()
-    int m_processCount;
-
     // The number of suspended coroutines
     int nSuspend_ = 0;
 
-    Workers m_workers;
+    // Set if the jobs are dispatched by work stealing, in which case the
+    // job sets of the pools and the counts in m_jobData are not used.
+    bool const workStealing_;
+
+    // The first pool runs the jobs of every type not given to another
+    std::vector<std::unique_ptr<Pool>> pools_;
+    std::vector<Pool*> poolOf_;
 
     // Statistics tracking
     perf::PerfLog& perfLog_;
@@ -266,6 +425,13 @@ private:
     beast::insight::Gauge job_count;
     beast::insight::Hook hook;
 
+    // Slow job tracing. The threshold is zero when it is off.
+    std::atomic<std::chrono::microseconds::rep> traceThreshold_{0};
+    std::atomic<std::uint32_t> traceSample_{1};
+    std::atomic<std::uint64_t> slowJobs_{0};
+    std::mutex traceMutex_;
+    std::deque<SlowJob> traced_;
+
     std::condition_variable cv_;
 
     void
@@ -285,32 +451,33 @@ private:
     addRefCountedJob(
         JobType type,
         std::string const& name,
-        JobFunction const& func);
+        JobFunction const& func,
+        source_location const& where);
 
-    // Returns the next Job we should run now.
+    // Returns the next Job of a pool we should run now.
     //
     // RunnableJob:
     //  A Job in the JobSet whose slots count for its type is greater than zero.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  The pool's jobSet must not be empty.
+    //  The pool's jobSet holds at least one RunnableJob
     //
     // Post-conditions:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from the pool's jobSet.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
     // Invariants:
     //  The calling thread owns the JobLock
     void
-    getNextJob(Job& job);
+    getNextJob(Pool& pool, Job& job);
 
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not exist in the jobSet of its pool.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -323,10 +490,10 @@ private:
     void
     finishJob(JobType type);
 
-    // Runs the next appropriate waiting Job.
+    // Runs the next appropriate waiting Job of a pool.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must exist in the pool's JobSet
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -334,7 +501,36 @@ private:
     // Invariants:
     //  <none>
     void
-    processTask(int instance) override;
+    processTask(Pool& pool, int instance);
+
+    // Runs a job which was taken from the queue.
+    //
+    // Pre-conditions:
+    //  The job is counted as running.
+    //
+    // Post-conditions:
+    //  The job has been done and its timing recorded.
+    void
+    processJob(Pool& pool, Job& job, int instance);
+
+    // Returns the pool which runs jobs of a type.
+    Pool&
+    getPool(JobType type) const;
+
+    // True if no job is waiting or running in a pool. The caller owns the
+    // JobLock.
+    bool
+    idle() const;
+
+    // Records a job which waited or ran for at least the trace threshold.
+    void
+    traceSlowJob(
+        Job const& job,
+        std::chrono::microseconds queued,
+        std::chrono::microseconds ran);
+
+    int
+    getNumberOfThreads() const;
 
     // Returns the limit of running jobs for the given job type.
     // For jobs with no limit, we return the largest int. Hopefully that
@@ -21,6 +21,7 @@
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
 #include <xrpld/core/JobTypeInfo.h>
+#include <xrpld/core/LatencyHistogram.h>
 
 #include <xrpl/basics/Log.h>
 #include <xrpl/beast/insight/Collector.h>
@@ -52,6 +53,16 @@ public:
     beast::insight::Event dequeue;
     beast::insight::Event execute;
 
+    /* Time spent waiting in the queue, and running, of every job */
+    LatencyHistogram dequeueLatency;
+    LatencyHistogram executeLatency;
+
+    /* The 99th percentiles since the last collection, for insight */
+    beast::insight::Gauge dequeueP99;
+    beast::insight::Gauge executeP99;
+    LatencyHistogram::Counts dequeueCollected{};
+    LatencyHistogram::Counts executeCollected{};
+
     JobTypeData(
         JobTypeInfo const& info_,
         beast::insight::Collector::ptr const& collector,
@@ -70,6 +81,8 @@ public:
         {
             dequeue = m_collector->make_event(info.name() + "_q");
             execute = m_collector->make_event(info.name());
+            dequeueP99 = m_collector->make_gauge(info.name() + "_q_p99");
+            executeP99 = m_collector->make_gauge(info.name() + "_p99");
         }
     }
 
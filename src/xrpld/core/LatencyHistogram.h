@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_LATENCYHISTOGRAM_H_INCLUDED
+#define RIPPLE_CORE_LATENCYHISTOGRAM_H_INCLUDED
+
+#include <xrpl/json/json_value.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+/** A histogram of latencies which may be recorded from any thread.
+
+    Values are kept in microseconds, in buckets of the kind HdrHistogram
+    uses: each power of two range is split into eight buckets of equal
+    width, so a value read back is within 12.5% of the values recorded in
+    its bucket. Values of 2^37 microseconds, about 38 hours, or more go in
+    the last bucket.
+
+    Recording a value is one relaxed atomic increment and a relaxed load of
+    the maximum, which is only raised, by compare and swap, when the value
+    is larger. No lock is taken, so it can stay on in production. The counts are never reset. A
+    caller that wants the distribution over an interval subtracts a
+    snapshot taken at the start of it.
+*/
+class LatencyHistogram
+{
+public:
+    static constexpr int subBucketBits = 3;
+    static constexpr int subBuckets = 1 << subBucketBits;
+    static constexpr int maxExponent = 36;
+    static constexpr int bucketCount =
+        (maxExponent - subBucketBits + 2) * subBuckets;
+
+    using Counts = std::array<std::uint64_t, bucketCount>;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram&
+    operator=(LatencyHistogram const&) = delete;
+
+    void
+    record(std::chrono::microseconds latency) noexcept;
+
+    /** The counts of each bucket. */
+    Counts
+    counts() const noexcept;
+
+    /** The largest value recorded. */
+    std::chrono::microseconds
+    max() const noexcept
+    {
+        return std::chrono::microseconds(max_.load(std::memory_order_relaxed));
+    }
+
+    /** Returns the bucket a value is counted in. */
+    static int
+    bucket(std::uint64_t value) noexcept;
+
+    /** Returns the largest value counted in a bucket. */
+    static std::uint64_t
+    bucketMax(int bucket) noexcept;
+
+    /** Returns the number of values in counts. */
+    static std::uint64_t
+    total(Counts const& counts) noexcept;
+
+    /** Returns the counts less those of an earlier snapshot. */
+    static Counts
+    since(Counts const& counts, Counts const& earlier) noexcept;
+
+    /** Returns the value which the fraction p of the values in counts are
+        at or below, rounded up to the top of its bucket. Zero if there are
+        no values.
+    */
+    static std::chrono::microseconds
+    percentile(Counts const& counts, double p) noexcept;
+
+    /** Returns the count, the 50th, 90th, 99th and 99.9th percentiles and
+        the maximum, in microseconds.
+    */
+    Json::Value
+    getJson() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> counts_{};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+}  // namespace ripple
+
+#endif
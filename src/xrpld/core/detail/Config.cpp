@@ -685,6 +685,14 @@ Config::loadFromString(std::string const& fileContents)
         PATH_SEARCH_FAST = beast::lexicalCastThrow<int>(strTemp);
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX = beast::lexicalCastThrow<int>(strTemp);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_THREADS, strTemp, j_))
+    {
+        PATH_SEARCH_THREADS = beast::lexicalCastThrow<std::size_t>(strTemp);
+        if (PATH_SEARCH_THREADS == 0)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_PATH_SEARCH_THREADS
+                "] section; the value must be greater than 0");
+    }
 
     if (getSingleSection(secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE = strTemp;
@@ -728,6 +736,66 @@ Config::loadFromString(std::string const& fileContents)
                 ": must be between 1 and 1024 inclusive.");
     }
 
+    if (getSingleSection(secConfig, SECTION_FLUSH_WORKERS, strTemp, j_))
+    {
+        FLUSH_WORKERS = beast::lexicalCastThrow<int>(strTemp);
+
+        if (FLUSH_WORKERS < 1 || FLUSH_WORKERS > 16)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_FLUSH_WORKERS
+                ": must be between 1 and 16 inclusive.");
+    }
+
+    if (getSingleSection(secConfig, SECTION_JOB_SCHEDULER, strTemp, j_))
+    {
+        if (boost::iequals(strTemp, "work_stealing"))
+            WORK_STEALING = true;
+        else if (boost::iequals(strTemp, "priority"))
+            WORK_STEALING = false;
+        else
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_JOB_SCHEDULER
+                ": must be priority or work_stealing.");
+    }
+
+    if (getSingleSection(secConfig, SECTION_LEDGER_APPLY, strTemp, j_))
+    {
+        if (boost::iequals(strTemp, "serial"))
+            LEDGER_APPLY = LedgerApply::serial;
+        else if (boost::iequals(strTemp, "parallel"))
+            LEDGER_APPLY = LedgerApply::parallel;
+        else if (boost::iequals(strTemp, "verify"))
+            LEDGER_APPLY = LedgerApply::verify;
+        else
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_LEDGER_APPLY
+                ": must be serial, parallel or verify.");
+    }
+
+    if (exists(SECTION_JOB_TRACE))
+    {
+        auto const sec = section(SECTION_JOB_TRACE);
+
+        try
+        {
+            if (auto val = sec.get("threshold"))
+                JOB_TRACE_THRESHOLD = std::chrono::milliseconds{
+                    beast::lexicalCastThrow<std::uint32_t>(*val)};
+            if (auto val = sec.get("sample"))
+                JOB_TRACE_SAMPLE = beast::lexicalCastThrow<std::uint32_t>(*val);
+        }
+        catch (...)
+        {
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_JOB_TRACE
+                ": threshold and sample must be numbers.");
+        }
+
+        if (JOB_TRACE_SAMPLE == 0)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_JOB_TRACE ": sample must be at least 1.");
+    }
+
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
@@ -36,12 +36,14 @@ Job::Job(
     std::string const& name,
     std::uint64_t index,
     LoadMonitor& lm,
-    std::function<void()> const& job)
+    std::function<void()> const& job,
+    source_location const& where)
     : mType(type)
     , mJobIndex(index)
     , mJob(job)
     , mName(name)
     , m_queue_time(clock_type::now())
+    , m_where(where)
 {
     m_loadEvent = std::make_shared<LoadEvent>(std::ref(lm), name, false);
 }
@@ -52,6 +54,18 @@ Job::getType() const
     return mType;
 }
 
+std::string const&
+Job::getName() const
+{
+    return mName;
+}
+
+source_location const&
+Job::where() const
+{
+    return m_where;
+}
+
 Job::clock_type::time_point const&
 Job::queue_time() const
 {
@@ -17,10 +17,16 @@
 */
 //==============================================================================
 
+#include <xrpld/core/ConfigSections.h>
 #include <xrpld/core/JobQueue.h>
 #include <xrpld/perflog/PerfLog.h>
 
+#include <xrpl/basics/chrono.h>
 #include <xrpl/basics/contract.h>
+#include <xrpl/beast/core/CurrentThreadAffinity.h>
+#include <xrpl/beast/core/LexicalCast.h>
+
+#include <boost/algorithm/string.hpp>
 
 #include <mutex>
 
@@ -31,16 +37,18 @@ JobQueue::JobQueue(
     beast::insight::Collector::ptr const& collector,
     beast::Journal journal,
     Logs& logs,
-    perf::PerfLog& perfLog)
+    perf::PerfLog& perfLog,
+    bool workStealing,
+    std::vector<JobPoolSetup> const& pools)
     : m_journal(journal)
     , m_lastJob(0)
     , m_invalidJobData(JobTypes::instance().getInvalid(), collector, logs)
-    , m_processCount(0)
-    , m_workers(*this, &perfLog, "JobQueue", threadCount)
+    , workStealing_(workStealing)
     , perfLog_(perfLog)
     , m_collector(collector)
 {
-    JLOG(m_journal.info()) << "Using " << threadCount << "  threads";
+    JLOG(m_journal.info()) << "Using " << threadCount << "  threads"
+                           << (workStealing ? " with work stealing" : "");
 
     hook = m_collector->make_hook(std::bind(&JobQueue::collect, this));
     job_count = m_collector->make_gauge("job_count");
@@ -63,26 +71,96 @@ JobQueue::JobQueue(
             (void)result.second;
         }
     }
+
+    // The threads of every pool are numbered apart in the perf log
+    std::vector<int> defaultCpus;
+    int threads = threadCount;
+    for (auto const& setup : pools)
+    {
+        if (setup.name == "default")
+            defaultCpus = setup.cpus;
+        else
+            threads += setup.threads;
+    }
+    perfLog.resizeJobs(threads);
+
+    // Started last, as the threads may run jobs at once
+    pools_.push_back(std::make_unique<Pool>(
+        *this, "JobQueue", threadCount, defaultCpus, workStealing, 0));
+    poolOf_.assign(jtNS_WRITE + 1, pools_.front().get());
+
+    int instanceBase = threadCount;
+    for (auto const& setup : pools)
+    {
+        if (setup.name == "default")
+            continue;
+
+        JLOG(m_journal.info()) << "Using " << setup.threads
+                               << " threads for the jobs of pool "
+                               << setup.name;
+        pools_.push_back(std::make_unique<Pool>(
+            *this,
+            setup.name,
+            setup.threads,
+            setup.cpus,
+            workStealing,
+            instanceBase));
+        instanceBase += setup.threads;
+        for (auto const type : setup.types)
+            poolOf_[type] = pools_.back().get();
+    }
 }
 
 JobQueue::~JobQueue()
 {
     // Must unhook before destroying
     hook = beast::insight::Hook();
+
+    // Stop the threads before the job data they use is destroyed
+    pools_.clear();
 }
 
 void
 JobQueue::collect()
 {
-    std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    {
+        std::lock_guard lock(m_mutex);
+        std::size_t waiting = 0;
+        for (auto const& pool : pools_)
+        {
+            waiting += pool->stealing ? pool->stealing->getWaiting()
+                                      : pool->jobSet.size();
+            pool->utilization = pool->getUtilization();
+        }
+        job_count = waiting;
+    }
+
+    // The tail latencies of the jobs run since the last collection. The
+    // histograms are lock free, so jobs are queued while this runs.
+    std::lock_guard lock(collectMutex_);
+    auto const p99 = [](LatencyHistogram const& histogram,
+                        LatencyHistogram::Counts& collected) {
+        auto const counts = histogram.counts();
+        auto const ret = LatencyHistogram::percentile(
+            LatencyHistogram::since(counts, collected), 0.99);
+        collected = counts;
+        return static_cast<std::uint64_t>(ret.count());
+    };
+    for (auto& [type, data] : m_jobData)
+    {
+        if (data.info.special())
+            continue;
+        data.dequeueP99 = p99(data.dequeueLatency, data.dequeueCollected);
+        data.executeP99 = p99(data.executeLatency, data.executeCollected);
+    }
 }
 
 bool
 JobQueue::addRefCountedJob(
     JobType type,
     std::string const& name,
-    JobFunction const& func)
+    JobFunction const& func,
+    source_location const& where)
 {
     XRPL_ASSERT(
         type != jtINVALID,
@@ -103,14 +181,25 @@ JobQueue::addRefCountedJob(
     // do not add jobs to a queue with no threads
     XRPL_ASSERT(
         (type >= jtCLIENT && type <= jtCLIENT_WEBSOCKET) ||
-            m_workers.getNumberOfThreads() > 0,
+            getNumberOfThreads() > 0,
         "ripple::JobQueue::addRefCountedJob : threads available or job "
         "requires no threads");
 
+    Pool& pool = getPool(type);
+    if (pool.stealing)
+    {
+        // The pool keeps the jobs of each type in order, so they need no
+        // index to sort them by
+        perfLog_.jobQueue(type);
+        pool.stealing->addJob(
+            std::make_unique<Job>(type, name, 0, data.load(), func, where));
+        return true;
+    }
+
     {
         std::lock_guard lock(m_mutex);
-        auto result =
-            m_jobSet.emplace(type, name, ++m_lastJob, data.load(), func);
+        auto result = pool.jobSet.emplace(
+            type, name, ++m_lastJob, data.load(), func, where);
         auto const& job = *result.first;
 
         JobType const type(job.getType());
@@ -118,7 +207,7 @@ JobQueue::addRefCountedJob(
             type != jtINVALID,
             "ripple::JobQueue::addRefCountedJob : has valid job type");
         XRPL_ASSERT(
-            m_jobSet.find(job) != m_jobSet.end(),
+            pool.jobSet.find(job) != pool.jobSet.end(),
             "ripple::JobQueue::addRefCountedJob : job found");
         perfLog_.jobQueue(type);
 
@@ -126,7 +215,7 @@ JobQueue::addRefCountedJob(
 
         if (data.waiting + data.running < getJobLimit(type))
         {
-            m_workers.addTask();
+            pool.workers.addTask();
         }
         else
         {
@@ -141,6 +230,9 @@ JobQueue::addRefCountedJob(
 int
 JobQueue::getJobCount(JobType t) const
 {
+    if (workStealing_)
+        return getPool(t).stealing->getWaiting(t);
+
     std::lock_guard lock(m_mutex);
 
     JobDataMap::const_iterator c = m_jobData.find(t);
@@ -151,6 +243,12 @@ JobQueue::getJobCount(JobType t) const
 int
 JobQueue::getJobCountTotal(JobType t) const
 {
+    if (workStealing_)
+    {
+        auto const& pool = *getPool(t).stealing;
+        return pool.getWaiting(t) + pool.getRunning(t);
+    }
+
     std::lock_guard lock(m_mutex);
 
     JobDataMap::const_iterator c = m_jobData.find(t);
@@ -164,6 +262,16 @@ JobQueue::getJobCountGE(JobType t) const
     // return the number of jobs at this priority level or greater
     int ret = 0;
 
+    if (workStealing_)
+    {
+        for (auto const& x : m_jobData)
+        {
+            if (x.first >= t)
+                ret += getPool(x.first).stealing->getWaiting(x.first);
+        }
+        return ret;
+    }
+
     std::lock_guard lock(m_mutex);
 
     for (auto const& x : m_jobData)
@@ -216,7 +324,7 @@ JobQueue::getJson(int c)
     using namespace std::chrono_literals;
     Json::Value ret(Json::objectValue);
 
-    ret["threads"] = m_workers.getNumberOfThreads();
+    ret["threads"] = getNumberOfThreads();
 
     Json::Value priorities = Json::arrayValue;
 
@@ -234,8 +342,9 @@ JobQueue::getJson(int c)
 
         LoadMonitor::Stats stats(data.stats());
 
-        int waiting(data.waiting);
-        int running(data.running);
+        auto const stealing = getPool(x.first).stealing.get();
+        int waiting(stealing ? stealing->getWaiting(x.first) : data.waiting);
+        int running(stealing ? stealing->getRunning(x.first) : data.running);
 
         if ((stats.count != 0) || (waiting != 0) ||
             (stats.latencyPeak != 0ms) || (running != 0))
@@ -261,19 +370,145 @@ JobQueue::getJson(int c)
 
             if (running != 0)
                 pri["in_progress"] = running;
+
+            // Since the server started, in microseconds
+            if (auto const ran = data.executeLatency.counts();
+                LatencyHistogram::total(ran) != 0)
+            {
+                pri["queued_p99_us"] = static_cast<Json::UInt>(
+                    LatencyHistogram::percentile(
+                        data.dequeueLatency.counts(), 0.99)
+                        .count());
+                pri["ran_p99_us"] = static_cast<Json::UInt>(
+                    LatencyHistogram::percentile(ran, 0.99).count());
+            }
         }
     }
 
     ret["job_types"] = priorities;
 
+    if (pools_.size() > 1)
+    {
+        Json::Value& pools = ret["pools"] = Json::arrayValue;
+        for (auto const& pool : pools_)
+        {
+            Json::Value& entry = pools.append(Json::objectValue);
+            entry["name"] = pool->name;
+            entry["threads"] = pool->getNumberOfThreads();
+            entry["utilization"] =
+                static_cast<Json::UInt>(pool->getUtilization());
+        }
+    }
+
     return ret;
 }
 
 void
 JobQueue::rendezvous()
 {
+    if (workStealing_)
+    {
+        // A job of one pool may add a job to another that was already
+        // waited for
+        auto const allIdle = [this]() {
+            return std::all_of(pools_.begin(), pools_.end(), [](auto& pool) {
+                return pool->stealing->idle();
+            });
+        };
+        do
+        {
+            for (auto& pool : pools_)
+                pool->stealing->rendezvous();
+        } while (!allIdle());
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(lock, [this] { return idle(); });
+}
+
+void
+JobQueue::parallelFor(
+    JobType type,
+    std::string const& name,
+    std::size_t count,
+    std::size_t sliceSize,
+    std::function<void(std::size_t, std::size_t)> const& f)
+{
+    XRPL_ASSERT(
+        sliceSize > 0, "ripple::JobQueue::parallelFor : nonzero slice size");
+
+    // Shared with the jobs, which may start after this returns, when no
+    // slice is left for them
+    struct Slices
+    {
+        std::function<void(std::size_t, std::size_t)> const* f;
+        std::size_t count;
+        std::size_t sliceSize;
+        std::size_t slices;
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        void
+        work()
+        {
+            for (std::size_t slice; (slice = next++) < slices;)
+            {
+                // Once a slice throws, those left are counted but not run
+                if (!failed.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        auto const first = slice * sliceSize;
+                        (*f)(first, std::min(count, first + sliceSize));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        failed = true;
+                    }
+                }
+                if (++done == slices)
+                {
+                    std::lock_guard lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+
+    auto const slices = std::make_shared<Slices>();
+    slices->f = &f;
+    slices->count = count;
+    slices->sliceSize = sliceSize;
+    slices->slices = (count + sliceSize - 1) / sliceSize;
+
+    // The caller takes a slice too, and no more jobs are added than there
+    // are threads to run them
+    std::size_t const jobs = slices->slices == 0
+        ? 0
+        : std::min<std::size_t>(slices->slices - 1, getNumberOfThreads());
+    for (std::size_t i = 0; i < jobs; ++i)
+    {
+        if (!addJob(type, name, [slices]() { slices->work(); }))
+            break;
+    }
+
+    slices->work();
+
+    // No slice is running once every one is done, so f and what it refers
+    // to are no longer used when this returns or throws
+    std::unique_lock lock(slices->mutex);
+    slices->finished.wait(
+        lock, [&slices] { return slices->done == slices->slices; });
+    if (slices->error)
+        std::rethrow_exception(slices->error);
 }
 
 JobTypeData&
@@ -304,14 +539,19 @@ JobQueue::stop()
         // but there may still be some threads between the return of
         // `Job::doJob` and the return of `JobQueue::processTask`. That is why
         // we must wait on the condition variable to make these assertions.
+        if (workStealing_)
+            rendezvous();
         std::unique_lock<std::mutex> lock(m_mutex);
-        cv_.wait(
-            lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
-        XRPL_ASSERT(
-            m_processCount == 0,
-            "ripple::JobQueue::stop : all processes completed");
-        XRPL_ASSERT(
-            m_jobSet.empty(), "ripple::JobQueue::stop : all jobs completed");
+        cv_.wait(lock, [this] { return idle(); });
+        for (auto const& pool : pools_)
+        {
+            XRPL_ASSERT(
+                pool->processCount == 0,
+                "ripple::JobQueue::stop : all processes completed");
+            XRPL_ASSERT(
+                pool->jobSet.empty(),
+                "ripple::JobQueue::stop : all jobs completed");
+        }
         XRPL_ASSERT(
             nSuspend_ == 0, "ripple::JobQueue::stop : no coros suspended");
         stopped_ = true;
@@ -325,13 +565,14 @@ JobQueue::isStopped() const
 }
 
 void
-JobQueue::getNextJob(Job& job)
+JobQueue::getNextJob(Pool& pool, Job& job)
 {
+    auto& jobSet = pool.jobSet;
     XRPL_ASSERT(
-        !m_jobSet.empty(), "ripple::JobQueue::getNextJob : non-empty jobs");
+        !jobSet.empty(), "ripple::JobQueue::getNextJob : non-empty jobs");
 
     std::set<Job>::const_iterator iter;
-    for (iter = m_jobSet.begin(); iter != m_jobSet.end(); ++iter)
+    for (iter = jobSet.begin(); iter != jobSet.end(); ++iter)
     {
         JobType const type = iter->getType();
         XRPL_ASSERT(
@@ -355,10 +596,9 @@ JobQueue::getNextJob(Job& job)
     }
 
     XRPL_ASSERT(
-        iter != m_jobSet.end(),
-        "ripple::JobQueue::getNextJob : found next job");
+        iter != jobSet.end(), "ripple::JobQueue::getNextJob : found next job");
     job = *iter;
-    m_jobSet.erase(iter);
+    jobSet.erase(iter);
 }
 
 void
@@ -378,49 +618,26 @@ JobQueue::finishJob(JobType type)
             "ripple::JobQueue::finishJob : job limit");
 
         --data.deferred;
-        m_workers.addTask();
+        getPool(type).workers.addTask();
     }
 
     --data.running;
 }
 
 void
-JobQueue::processTask(int instance)
+JobQueue::processTask(Pool& pool, int instance)
 {
     JobType type;
 
     {
-        using namespace std::chrono;
-        Job::clock_type::time_point const start_time(Job::clock_type::now());
+        Job job;
         {
-            Job job;
-            {
-                std::lock_guard lock(m_mutex);
-                getNextJob(job);
-                ++m_processCount;
-            }
-            type = job.getType();
-            JobTypeData& data(getJobTypeData(type));
-            JLOG(m_journal.trace()) << "Doing " << data.name() << "job";
-
-            // The amount of time that the job was in the queue
-            auto const q_time =
-                ceil<microseconds>(start_time - job.queue_time());
-            perfLog_.jobStart(type, q_time, start_time, instance);
-
-            job.doJob();
-
-            // The amount of time it took to execute the job
-            auto const x_time =
-                ceil<microseconds>(Job::clock_type::now() - start_time);
-
-            if (x_time >= 10ms || q_time >= 10ms)
-            {
-                getJobTypeData(type).dequeue.notify(q_time);
-                getJobTypeData(type).execute.notify(x_time);
-            }
-            perfLog_.jobFinish(type, x_time, instance);
+            std::lock_guard lock(m_mutex);
+            getNextJob(pool, job);
+            ++pool.processCount;
         }
+        type = job.getType();
+        processJob(pool, job, instance);
     }
 
     {
@@ -429,7 +646,7 @@ JobQueue::processTask(int instance)
         // otherwise destructors with side effects can access
         // parent objects that are already destroyed.
         finishJob(type);
-        if (--m_processCount == 0 && m_jobSet.empty())
+        if (--pool.processCount == 0 && pool.jobSet.empty())
             cv_.notify_all();
     }
 
@@ -437,6 +654,147 @@ JobQueue::processTask(int instance)
     // to the associated LoadEvent object (in the Job) may be destroyed.
 }
 
+void
+JobQueue::processJob(Pool& pool, Job& job, int instance)
+{
+    using namespace std::chrono;
+    Job::clock_type::time_point const start_time(Job::clock_type::now());
+
+    JobType const type = job.getType();
+    JobTypeData& data(getJobTypeData(type));
+    JLOG(m_journal.trace()) << "Doing " << data.name() << "job";
+
+    // The amount of time that the job was in the queue
+    auto const q_time = ceil<microseconds>(start_time - job.queue_time());
+    perfLog_.jobStart(type, q_time, start_time, instance);
+
+    job.doJob();
+
+    // The amount of time it took to execute the job
+    auto const x_time = ceil<microseconds>(Job::clock_type::now() - start_time);
+    pool.busy.fetch_add(x_time.count(), std::memory_order_relaxed);
+
+    if (x_time >= 10ms || q_time >= 10ms)
+    {
+        data.dequeue.notify(q_time);
+        data.execute.notify(x_time);
+    }
+    data.dequeueLatency.record(q_time);
+    data.executeLatency.record(x_time);
+
+    if (auto const threshold = traceThreshold_.load(std::memory_order_relaxed);
+        threshold != 0 &&
+        (q_time.count() >= threshold || x_time.count() >= threshold))
+    {
+        traceSlowJob(job, q_time, x_time);
+    }
+    perfLog_.jobFinish(type, x_time, instance);
+}
+
+void
+JobQueue::traceSlowJob(
+    Job const& job,
+    std::chrono::microseconds queued,
+    std::chrono::microseconds ran)
+{
+    auto const n = slowJobs_.fetch_add(1, std::memory_order_relaxed);
+    if (n % traceSample_.load(std::memory_order_relaxed) != 0)
+        return;
+
+    auto const& where = job.where();
+    JLOG(m_journal.warn()) << "Slow job " << job.getName() << " waited "
+                           << queued.count() << "us and ran " << ran.count()
+                           << "us, added by " << where.function_name()
+                           << " at " << where.file_name() << ":"
+                           << where.line();
+
+    std::lock_guard lock(traceMutex_);
+    if (traced_.size() == slowJobsKept)
+        traced_.pop_front();
+    traced_.push_back(
+        {job.getType(),
+         job.getName(),
+         where,
+         queued,
+         ran,
+         std::chrono::system_clock::now()});
+}
+
+void
+JobQueue::setSlowJobTrace(
+    std::chrono::milliseconds threshold,
+    std::uint32_t sampleEvery)
+{
+    using namespace std::chrono;
+    traceSample_ = std::max<std::uint32_t>(sampleEvery, 1);
+    traceThreshold_ = duration_cast<microseconds>(threshold).count();
+}
+
+void
+JobQueue::getCountsJson(Json::Value& obj)
+{
+    Json::Value latency(Json::objectValue);
+    for (auto& [type, data] : m_jobData)
+    {
+        if (data.info.special() ||
+            LatencyHistogram::total(data.dequeueLatency.counts()) == 0)
+            continue;
+
+        Json::Value& entry = latency[data.name()] = Json::objectValue;
+        entry["queued"] = data.dequeueLatency.getJson();
+        entry["ran"] = data.executeLatency.getJson();
+    }
+    obj["job_latency"] = latency;
+
+    if (traceThreshold_.load() == 0)
+        return;
+
+    Json::Value traced(Json::arrayValue);
+    {
+        std::lock_guard lock(traceMutex_);
+        for (auto const& job : traced_)
+        {
+            Json::Value& entry = traced.append(Json::objectValue);
+            entry["job_type"] = JobTypes::name(job.type);
+            entry["name"] = job.name;
+            entry["added_by"] = std::string(job.where.function_name()) +
+                " at " + job.where.file_name() + ":" +
+                std::to_string(job.where.line());
+            entry["queued"] = static_cast<Json::UInt>(job.queued.count());
+            entry["ran"] = static_cast<Json::UInt>(job.ran.count());
+            entry["finished"] = to_string_iso(
+                std::chrono::floor<std::chrono::seconds>(job.finished));
+        }
+    }
+    obj["slow_jobs"] = traced;
+    obj["slow_jobs_total"] = std::to_string(slowJobs_.load());
+}
+
+int
+JobQueue::getNumberOfThreads() const
+{
+    int ret = 0;
+    for (auto const& pool : pools_)
+        ret += pool->getNumberOfThreads();
+    return ret;
+}
+
+JobQueue::Pool&
+JobQueue::getPool(JobType type) const
+{
+    if (type < 0 || type >= static_cast<int>(poolOf_.size()))
+        return *pools_.front();
+    return *poolOf_[type];
+}
+
+bool
+JobQueue::idle() const
+{
+    return std::all_of(pools_.begin(), pools_.end(), [](auto const& pool) {
+        return pool->idle();
+    });
+}
+
 int
 JobQueue::getJobLimit(JobType type)
 {
@@ -448,4 +806,202 @@ JobQueue::getJobLimit(JobType type)
     return j.limit();
 }
 
+//------------------------------------------------------------------------------
+
+JobQueue::Pool::Pool(
+    JobQueue& jq_,
+    std::string const& name_,
+    int threads,
+    std::vector<int> const& cpus_,
+    bool workStealing,
+    int instanceBase_)
+    : jq(jq_)
+    , name(name_)
+    , cpus(cpus_)
+    , instanceBase(instanceBase_)
+    , utilization(jq.m_collector->make_gauge(name + "_utilization"))
+    , workers(*this, nullptr, name, workStealing ? 0 : threads)
+    , sampled_(Job::clock_type::now())
+{
+    if (workStealing)
+    {
+        WorkStealingPool::Callback& callback = *this;
+        stealing = std::make_unique<WorkStealingPool>(
+            callback, nullptr, name, threads);
+    }
+}
+
+int
+JobQueue::Pool::getNumberOfThreads() const
+{
+    return stealing ? stealing->getNumberOfThreads()
+                    : workers.getNumberOfThreads();
+}
+
+std::uint64_t
+JobQueue::Pool::getUtilization()
+{
+    using namespace std::chrono;
+    std::lock_guard lock(sampleMutex_);
+
+    auto const now = Job::clock_type::now();
+    auto const elapsed = duration_cast<microseconds>(now - sampled_).count();
+    if (elapsed < 1'000'000)
+        return utilization_;
+
+    // A job counts as busy when it finishes, so a long one may put a sample
+    // over the limit
+    auto const total = busy.load(std::memory_order_relaxed);
+    auto const capacity = static_cast<std::uint64_t>(elapsed) *
+        std::max(getNumberOfThreads(), 1);
+    utilization_ =
+        std::min<std::uint64_t>((total - busySampled_) * 100 / capacity, 100);
+    busySampled_ = total;
+    sampled_ = now;
+    return utilization_;
+}
+
+bool
+JobQueue::Pool::idle() const
+{
+    if (stealing)
+        return stealing->idle();
+    return processCount == 0 && jobSet.empty();
+}
+
+void
+JobQueue::Pool::processTask(int instance)
+{
+    jq.processTask(*this, instanceBase + instance);
+}
+
+void
+JobQueue::Pool::processJob(Job& job, int instance)
+{
+    jq.processJob(*this, job, instanceBase + instance);
+}
+
+void
+JobQueue::Pool::onThreadStart(int instance)
+{
+    if (!cpus.empty() && !beast::setCurrentThreadAffinity(cpus))
+    {
+        JLOG(jq.m_journal.warn())
+            << "Unable to restrict the threads of job pool " << name
+            << " to their CPUs";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Parses a list of CPUs such as "0-3,8"
+std::vector<int>
+parseCpus(std::string const& pool, std::string const& list)
+{
+    std::vector<int> ret;
+    std::vector<std::string> items;
+    boost::split(items, list, boost::is_any_of(","));
+    for (auto item : items)
+    {
+        boost::trim(item);
+        auto const dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (!beast::lexicalCastChecked(first, item.substr(0, dash)) ||
+            (dash != std::string::npos &&
+             !beast::lexicalCastChecked(last, item.substr(dash + 1))) ||
+            first < 0)
+        {
+            Throw<std::runtime_error>(
+                "Job pool " + pool + " has invalid cpus: " + list);
+        }
+        if (dash == std::string::npos)
+            last = first;
+        if (last < first)
+            Throw<std::runtime_error>(
+                "Job pool " + pool + " has invalid cpus: " + list);
+        for (int cpu = first; cpu <= last; ++cpu)
+            ret.push_back(cpu);
+    }
+    return ret;
+}
+
+}  // namespace
+
+std::vector<JobPoolSetup>
+setup_JobPools(BasicConfig const& config)
+{
+    std::vector<JobPoolSetup> ret;
+    if (!config.exists(SECTION_JOB_POOLS))
+        return ret;
+
+    std::set<JobType> mapped;
+    for (auto const& name : config.section(SECTION_JOB_POOLS).values())
+    {
+        if (std::any_of(ret.begin(), ret.end(), [&name](auto const& setup) {
+                return setup.name == name;
+            }))
+            Throw<std::runtime_error>("Job pool " + name + " is listed twice");
+        if (!config.exists(name))
+            Throw<std::runtime_error>("Job pool " + name + " has no section");
+
+        auto const& section = config.section(name);
+        JobPoolSetup setup;
+        setup.name = name;
+        if (auto const cpus = section.get("cpus"))
+            setup.cpus = parseCpus(name, *cpus);
+
+        if (name == "default")
+        {
+            if (section.exists("threads") || section.exists("types"))
+                Throw<std::runtime_error>(
+                    "Job pool default may only set cpus");
+            ret.push_back(std::move(setup));
+            continue;
+        }
+
+        auto const threads = section.get("threads");
+        if (!threads || !beast::lexicalCastChecked(setup.threads, *threads) ||
+            setup.threads < 1)
+            Throw<std::runtime_error>(
+                "Job pool " + name + " needs a positive number of threads");
+
+        std::vector<std::string> types;
+        boost::split(
+            types, section.get("types").value_or(""), boost::is_any_of(","));
+        for (auto type : types)
+        {
+            boost::trim(type);
+            if (type.empty())
+                continue;
+
+            auto const& jobTypes = JobTypes::instance();
+            auto const iter = std::find_if(
+                jobTypes.begin(), jobTypes.end(), [&type](auto const& x) {
+                    return x.second.name() == type;
+                });
+            if (iter == jobTypes.end())
+                Throw<std::runtime_error>(
+                    "Job pool " + name + " has unknown job type " + type);
+
+            // Special types are never queued, so no pool would run them
+            if (iter->second.special())
+                Throw<std::runtime_error>(
+                    "Job pool " + name + " has job type " + type +
+                    ", which is never queued");
+            if (!mapped.insert(iter->first).second)
+                Throw<std::runtime_error>(
+                    "Job type " + type + " is in more than one job pool");
+            setup.types.push_back(iter->first);
+        }
+        if (setup.types.empty())
+            Throw<std::runtime_error>("Job pool " + name + " has no types");
+
+        ret.push_back(std::move(setup));
+    }
+    return ret;
+}
+
 }  // namespace ripple
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/core/LatencyHistogram.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace ripple {
+
+void
+LatencyHistogram::record(std::chrono::microseconds latency) noexcept
+{
+    auto const value = static_cast<std::uint64_t>(
+        std::max(latency.count(), std::chrono::microseconds::rep{0}));
+
+    counts_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+
+    // Raising the maximum is rare once the histogram has warmed up, so the
+    // load is nearly always the only access
+    auto m = max_.load(std::memory_order_relaxed);
+    while (value > m &&
+           !max_.compare_exchange_weak(m, value, std::memory_order_relaxed))
+        ;
+}
+
+LatencyHistogram::Counts
+LatencyHistogram::counts() const noexcept
+{
+    Counts ret;
+    for (int i = 0; i < bucketCount; ++i)
+        ret[i] = counts_[i].load(std::memory_order_relaxed);
+    return ret;
+}
+
+int
+LatencyHistogram::bucket(std::uint64_t value) noexcept
+{
+    // Values below subBuckets each have a bucket of their own. Above that,
+    // the bucket is given by the position of the top bit and the bits
+    // which follow it.
+    if (value < subBuckets)
+        return static_cast<int>(value);
+
+    int const exponent = std::bit_width(value) - 1;
+    if (exponent > maxExponent)
+        return bucketCount - 1;
+
+    auto const sub = (value >> (exponent - subBucketBits)) & (subBuckets - 1);
+    return (exponent - subBucketBits + 1) * subBuckets + static_cast<int>(sub);
+}
+
+std::uint64_t
+LatencyHistogram::bucketMax(int bucket) noexcept
+{
+    if (bucket < subBuckets)
+        return bucket;
+
+    int const exponent = bucket / subBuckets + subBucketBits - 1;
+    std::uint64_t const sub = bucket % subBuckets;
+    auto const width = std::uint64_t{1} << (exponent - subBucketBits);
+    return ((subBuckets + sub) << (exponent - subBucketBits)) + width - 1;
+}
+
+std::uint64_t
+LatencyHistogram::total(Counts const& counts) noexcept
+{
+    std::uint64_t ret = 0;
+    for (auto const c : counts)
+        ret += c;
+    return ret;
+}
+
+LatencyHistogram::Counts
+LatencyHistogram::since(Counts const& counts, Counts const& earlier) noexcept
+{
+    Counts ret;
+    for (int i = 0; i < bucketCount; ++i)
+        ret[i] = counts[i] - earlier[i];
+    return ret;
+}
+
+std::chrono::microseconds
+LatencyHistogram::percentile(Counts const& counts, double p) noexcept
+{
+    auto const n = total(counts);
+    if (n == 0)
+        return std::chrono::microseconds{0};
+
+    auto const rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(p * n)));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < bucketCount; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return std::chrono::microseconds(bucketMax(i));
+    }
+    return std::chrono::microseconds(bucketMax(bucketCount - 1));
+}
+
+Json::Value
+LatencyHistogram::getJson() const
+{
+    auto const c = counts();
+    auto const m = max();
+
+    // The top of a bucket may be above every value in it
+    auto const at = [&c, m](double p) {
+        return static_cast<Json::UInt>(std::min(percentile(c, p), m).count());
+    };
+
+    Json::Value ret(Json::objectValue);
+    ret["count"] = std::to_string(total(c));
+    ret["p50"] = at(0.5);
+    ret["p90"] = at(0.9);
+    ret["p99"] = at(0.99);
+    ret["p999"] = at(0.999);
+    ret["max"] = static_cast<Json::UInt>(m.count());
+    return ret;
+}
+
+}  // namespace ripple
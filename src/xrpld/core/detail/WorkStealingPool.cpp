@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/core/JobTypes.h>
+#include <xrpld/core/detail/WorkStealingPool.h>
+#include <xrpld/perflog/PerfLog.h>
+
+#include <xrpl/beast/core/CurrentThreadName.h>
+#include <xrpl/beast/utility/instrumentation.h>
+
+#include <bit>
+
+namespace ripple {
+
+namespace {
+
+// The pool and the thread instance of the calling thread, if it is a
+// thread of a pool
+thread_local WorkStealingPool const* currentPool = nullptr;
+thread_local int currentInstance = -1;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(
+    Callback& callback,
+    perf::PerfLog* perfLog,
+    std::string const& threadNames,
+    int numberOfThreads)
+    : callback_(callback), threadNames_(threadNames)
+{
+    for (auto const& [type, info] : JobTypes::instance())
+    {
+        if (type >= 0 && type < numberOfTypes)
+            types_[type].limit = info.limit();
+    }
+
+    if (perfLog)
+        perfLog->resizeJobs(numberOfThreads);
+
+    workers_.reserve(numberOfThreads);
+    for (int i = 0; i < numberOfThreads; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+
+    // The threads may steal from every worker, so start them once all exist
+    for (int i = 0; i < numberOfThreads; ++i)
+        workers_[i]->thread = std::thread(&WorkStealingPool::run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+
+    for (auto& worker : workers_)
+        worker->thread.join();
+
+    // Jobs of a type which was never allowed to run
+    for (auto& queue : types_)
+    {
+        Job* job;
+        while (queue.injected.pop(job))
+            delete job;
+    }
+    for (auto& worker : workers_)
+    {
+        for (auto& jobs : worker->jobs)
+        {
+            for (auto job : jobs)
+                delete job;
+        }
+    }
+}
+
+int
+WorkStealingPool::getNumberOfThreads() const noexcept
+{
+    return static_cast<int>(workers_.size());
+}
+
+void
+WorkStealingPool::addJob(std::unique_ptr<Job> job)
+{
+    auto const type = job->getType();
+    XRPL_ASSERT(
+        type >= 0 && type < numberOfTypes,
+        "ripple::WorkStealingPool::addJob : valid job type");
+
+    auto& queue = types_[type];
+    auto const bit = std::uint64_t{1} << type;
+
+    ++outstanding_;
+    if (currentPool == this)
+    {
+        auto& worker = *workers_[currentInstance];
+        std::lock_guard lock(worker.mutex);
+        worker.jobs[type].push_back(job.release());
+        ++queue.local;
+    }
+    else
+    {
+        queue.injected.push(job.release());
+    }
+
+    // The count is raised after the job is queued, and the bit set after
+    // the count is raised. A thread which clears the bit checks the count
+    // again afterwards, so the bit of a waiting job is never left clear.
+    ++queue.waiting;
+    if ((pending_.load() & bit) == 0)
+        pending_.fetch_or(bit);
+
+    if (queue.running.load() < queue.limit)
+        wakeOne();
+}
+
+int
+WorkStealingPool::getWaiting(JobType type) const noexcept
+{
+    if (type < 0 || type >= numberOfTypes)
+        return 0;
+
+    // The count is lowered when a job is taken, which may happen before
+    // the thread that queued it raised it.
+    return std::max(types_[type].waiting.load(), 0);
+}
+
+int
+WorkStealingPool::getRunning(JobType type) const noexcept
+{
+    if (type < 0 || type >= numberOfTypes)
+        return 0;
+    return types_[type].running.load();
+}
+
+std::size_t
+WorkStealingPool::getWaiting() const noexcept
+{
+    std::size_t ret = 0;
+    for (auto const& queue : types_)
+        ret += std::max(queue.waiting.load(), 0);
+    return ret;
+}
+
+bool
+WorkStealingPool::idle() const noexcept
+{
+    return outstanding_.load() == 0;
+}
+
+void
+WorkStealingPool::rendezvous()
+{
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return outstanding_.load() == 0; });
+}
+
+Job*
+WorkStealingPool::pop(TypeQueue& queue, JobType type, int instance)
+{
+    auto const popFrom = [&queue, type](Worker& worker) -> Job* {
+        std::lock_guard lock(worker.mutex);
+        auto& jobs = worker.jobs[type];
+        if (jobs.empty())
+            return nullptr;
+
+        auto const job = jobs.front();
+        jobs.pop_front();
+        --queue.local;
+        return job;
+    };
+
+    if (queue.local.load() > 0)
+    {
+        if (auto const job = popFrom(*workers_[instance]))
+            return job;
+    }
+
+    if (Job * job; queue.injected.pop(job))
+        return job;
+
+    if (queue.local.load() > 0)
+    {
+        auto const n = workers_.size();
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            if (auto const job = popFrom(*workers_[(instance + i) % n]))
+                return job;
+        }
+    }
+
+    return nullptr;
+}
+
+Job*
+WorkStealingPool::take(int instance)
+{
+    auto mask = pending_.load();
+    while (mask != 0)
+    {
+        auto const type = 63 - std::countl_zero(mask);
+        auto const bit = std::uint64_t{1} << type;
+        mask &= ~bit;
+
+        auto& queue = types_[type];
+
+        // Claim a slot below the limit before looking for a job, so that
+        // the limit is never exceeded
+        auto running = queue.running.load();
+        do
+        {
+            if (running >= queue.limit)
+                break;
+        } while (!queue.running.compare_exchange_weak(running, running + 1));
+        if (running >= queue.limit)
+            continue;
+
+        auto const job = pop(queue, static_cast<JobType>(type), instance);
+        if (job)
+            --queue.waiting;
+        else
+            --queue.running;
+
+        // The count is checked again after the bit is cleared, in case a
+        // job was queued meanwhile by a thread which saw the bit still set.
+        if (queue.waiting.load() <= 0)
+        {
+            pending_.fetch_and(~bit);
+            if (queue.waiting.load() > 0)
+                pending_.fetch_or(bit);
+        }
+
+        if (job)
+            return job;
+    }
+
+    return nullptr;
+}
+
+void
+WorkStealingPool::execute(Job* job, int instance)
+{
+    auto const type = job->getType();
+
+    callback_.processJob(*job, instance);
+
+    // The job is destroyed before it stops counting as running, as it is
+    // in JobQueue::processTask
+    delete job;
+
+    auto& queue = types_[type];
+    --queue.running;
+
+    // This thread will look for another job, but may prefer a job of a
+    // higher priority over one that was waiting for the slot just freed
+    if (queue.waiting.load() > 0)
+        wakeOne();
+
+    if (--outstanding_ == 0)
+    {
+        std::lock_guard lock(mutex_);
+        idle_.notify_all();
+    }
+}
+
+void
+WorkStealingPool::wakeOne()
+{
+    if (sleepers_.load() == 0)
+        return;
+
+    std::lock_guard lock(mutex_);
+    if (signals_ < sleepers_.load())
+    {
+        ++signals_;
+        wakeup_.notify_one();
+    }
+}
+
+void
+WorkStealingPool::run(int instance)
+{
+    beast::setCurrentThreadName(threadNames_);
+    currentPool = this;
+    currentInstance = instance;
+    callback_.onThreadStart(instance);
+
+    for (;;)
+    {
+        if (auto const job = take(instance))
+        {
+            execute(job, instance);
+
+            // Put the name back in case the job changed it
+            beast::setCurrentThreadName(threadNames_);
+            continue;
+        }
+
+        // Announce that this thread is going to sleep before looking for a
+        // job once more. A thread that queues a job after this looks, sees
+        // the announcement and wakes a sleeper.
+        ++sleepers_;
+        if (auto const job = take(instance))
+        {
+            --sleepers_;
+            execute(job, instance);
+            beast::setCurrentThreadName(threadNames_);
+            continue;
+        }
+
+        std::unique_lock lock(mutex_);
+        if (stopping_)
+        {
+            --sleepers_;
+            break;
+        }
+
+        wakeup_.wait(lock, [this] { return signals_ > 0 || stopping_; });
+        if (signals_ > 0)
+            --signals_;
+        --sleepers_;
+    }
+
+    currentPool = nullptr;
+    currentInstance = -1;
+}
+
+}  // namespace ripple
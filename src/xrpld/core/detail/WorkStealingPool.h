@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_WORKSTEALINGPOOL_H_INCLUDED
+#define RIPPLE_CORE_WORKSTEALINGPOOL_H_INCLUDED
+
+#include <xrpld/core/Job.h>
+
+#include <boost/lockfree/queue.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+namespace perf {
+class PerfLog;
+}
+
+/**
+ * `WorkStealingPool` is a thread pool which queues jobs itself, unlike
+ * `Workers`, which relies on its callback to keep them.
+ *
+ * Each job type has a lock-free queue that jobs posted from other threads
+ * are injected into. A job posted from one of the pool's own threads is
+ * instead kept in a deque of that thread, which other threads steal from
+ * when they have nothing better to do. No lock is shared by all threads:
+ * a deque's mutex is only contended when its jobs are being stolen, and
+ * the mutex idle threads sleep on is only taken to sleep or to wake one.
+ *
+ * A thread looking for work considers the job types from the highest
+ * priority down, and takes a job of the first type that has one waiting
+ * and fewer running than its `JobTypeInfo` limit. This is the same choice
+ * that `JobQueue` makes from its priority ordered set. Jobs of one type
+ * run in the order they were posted, except that a thread runs the jobs
+ * in its own deque before those that were injected.
+ *
+ * A job that is waiting only because its type is at its limit is picked up
+ * by the thread that finishes the job holding the slot, or by a thread
+ * that it wakes.
+ */
+class WorkStealingPool
+{
+public:
+    /** Called to run jobs. */
+    struct Callback
+    {
+        virtual ~Callback() = default;
+        Callback() = default;
+        Callback(Callback const&) = delete;
+        Callback&
+        operator=(Callback const&) = delete;
+
+        /** Run a job.
+
+            The call is made on a thread owned by the pool, which counts the
+            job as running until the call returns.
+
+            @param instance The worker thread instance.
+        */
+        virtual void
+        processJob(Job& job, int instance) = 0;
+
+        /** Called on each thread when it starts, before any job.
+
+            @param instance The worker thread instance.
+        */
+        virtual void
+        onThreadStart(int instance)
+        {
+        }
+    };
+
+    WorkStealingPool(
+        Callback& callback,
+        perf::PerfLog* perfLog,
+        std::string const& threadNames,
+        int numberOfThreads);
+
+    /** Stop the threads, once they find no job they can run. */
+    ~WorkStealingPool();
+
+    WorkStealingPool(WorkStealingPool const&) = delete;
+    WorkStealingPool&
+    operator=(WorkStealingPool const&) = delete;
+
+    int
+    getNumberOfThreads() const noexcept;
+
+    /** Add a job to be run.
+
+        @note This function is thread-safe.
+    */
+    void
+    addJob(std::unique_ptr<Job> job);
+
+    /** The number of jobs of a type waiting to run. */
+    int
+    getWaiting(JobType type) const noexcept;
+
+    /** The number of jobs of a type running. */
+    int
+    getRunning(JobType type) const noexcept;
+
+    /** The number of jobs waiting to run. */
+    std::size_t
+    getWaiting() const noexcept;
+
+    /** Returns `true` if no jobs are waiting or running. */
+    bool
+    idle() const noexcept;
+
+    /** Block until no jobs are waiting or running. */
+    void
+    rendezvous();
+
+private:
+    // One bit per job type in a 64 bit mask
+    static constexpr int numberOfTypes = jtNS_WRITE + 1;
+    static_assert(numberOfTypes <= 64);
+
+    struct alignas(64) TypeQueue
+    {
+        boost::lockfree::queue<Job*> injected{64};
+        std::atomic<int> waiting{0};
+        std::atomic<int> running{0};
+        // Jobs of this type in the deques of the threads
+        std::atomic<int> local{0};
+        int limit = 0;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::array<std::deque<Job*>, numberOfTypes> jobs;
+        std::thread thread;
+    };
+
+    Job*
+    pop(TypeQueue& queue, JobType type, int instance);
+
+    Job*
+    take(int instance);
+
+    void
+    execute(Job* job, int instance);
+
+    void
+    wakeOne();
+
+    void
+    run(int instance);
+
+    Callback& callback_;
+    std::string const threadNames_;
+    std::array<TypeQueue, numberOfTypes> types_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Bit n is set when jobs of type n may be waiting
+    std::atomic<std::uint64_t> pending_{0};
+
+    // Jobs waiting or running
+    std::atomic<std::size_t> outstanding_{0};
+
+    // Threads which found no job, and are about to sleep or sleeping
+    std::atomic<int> sleepers_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable idle_;
+    int signals_ = 0;
+    bool stopping_ = false;
+};
+
+}  // namespace ripple
+
+#endif
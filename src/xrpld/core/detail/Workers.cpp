@@ -194,6 +194,8 @@ Workers::Worker::notify()
 void
 Workers::Worker::run()
 {
+    m_workers.m_callback.onThreadStart(instance_);
+
     bool shouldExit = true;
     do
     {
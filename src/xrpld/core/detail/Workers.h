@@ -102,6 +102,15 @@ public:
         */
         virtual void
         processTask(int instance) = 0;
+
+        /** Called on each thread when it starts, before any task.
+
+            @param instance The worker thread instance.
+        */
+        virtual void
+        onThreadStart(int instance)
+        {
+        }
     };
 
     /** Create the object.
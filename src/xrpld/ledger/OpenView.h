@@ -174,6 +174,17 @@ public:
         baseTxCount_ = base.txCount();
     }
 
+    /** Construct a view stacked on a base which is not an OpenView.
+
+        Transactions inserted are numbered from `baseTxCount`, as if they
+        followed that many transactions in the base.
+    */
+    OpenView(batch_view_t, ReadView const* base, std::size_t baseTxCount)
+        : OpenView(base)
+    {
+        baseTxCount_ = baseTxCount;
+    }
+
     /** Construct a new last closed ledger.
 
         Effects:
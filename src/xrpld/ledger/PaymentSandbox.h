@@ -194,6 +194,14 @@ public:
     apply(PaymentSandbox& to);
     /** @} */
 
+    /** Pass the changes to ledger entries to `to`.
+
+        Unlike apply(), this leaves this view as it is, and may be called
+        on a sandbox constructed on top of another.
+    */
+    void
+    visitChanges(RawView& to) const;
+
     // Return a map of balance changes on trust lines. The low account is the
     // first account in the key. If the two accounts are equal, the map contains
     // the total changes in currency regardless of issuer. This is useful to get
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGER_RECORDINGVIEW_H_INCLUDED
+#define RIPPLE_LEDGER_RECORDINGVIEW_H_INCLUDED
+
+#include <xrpld/ledger/RawView.h>
+#include <xrpld/ledger/ReadView.h>
+
+#include <algorithm>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** What was read from a view. */
+struct ReadSet
+{
+    // Entries read, or whose existence was checked
+    std::vector<uint256> keys;
+
+    // Intervals (first, last] over which a successor was looked for. An
+    // interval with no last has no upper bound.
+    std::vector<std::pair<uint256, std::optional<uint256>>> ranges;
+
+    // Set when something was read that any change may affect
+    bool unbounded = false;
+
+    /** Whether a change to the written entries may change what was read. */
+    bool
+    changedBy(std::set<uint256> const& written) const
+    {
+        if (written.empty())
+            return false;
+
+        if (unbounded)
+            return true;
+
+        if (std::any_of(keys.begin(), keys.end(), [&written](auto const& key) {
+                return written.count(key) != 0;
+            }))
+            return true;
+
+        return std::any_of(
+            ranges.begin(), ranges.end(), [&written](auto const& range) {
+                auto const iter = written.upper_bound(range.first);
+                return iter != written.end() &&
+                    (!range.second || *iter <= *range.second);
+            });
+    }
+};
+
+/** A view of a base which records what is read through it.
+
+    The balance and owner count hooks are passed to the base, so that a
+    PaymentSandbox may be the base.
+*/
+class RecordingView final : public ReadView
+{
+    ReadView const& base_;
+    ReadSet& reads_;
+
+public:
+    RecordingView(ReadView const& base, ReadSet& reads)
+        : base_(base), reads_(reads)
+    {
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        reads_.keys.push_back(k.key);
+        return base_.exists(k);
+    }
+
+    std::optional<key_type>
+    succ(
+        key_type const& key,
+        std::optional<key_type> const& last = std::nullopt) const override
+    {
+        auto next = base_.succ(key, last);
+        reads_.ranges.emplace_back(key, next ? next : last);
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        reads_.keys.push_back(k.key);
+        return base_.read(k);
+    }
+
+    STAmount
+    balanceHook(
+        AccountID const& account,
+        AccountID const& issuer,
+        STAmount const& amount) const override
+    {
+        return base_.balanceHook(account, issuer, amount);
+    }
+
+    std::uint32_t
+    ownerCountHook(AccountID const& account, std::uint32_t count)
+        const override
+    {
+        return base_.ownerCountHook(account, count);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        reads_.unbounded = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        reads_.unbounded = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        reads_.unbounded = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        reads_.unbounded = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        reads_.unbounded = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        reads_.unbounded = true;
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        reads_.unbounded = true;
+        return base_.txRead(key);
+    }
+};
+
+/** Records the keys of the entries changed by the view applied to it. */
+class WriteRecorder final : public TxsRawView
+{
+    std::vector<uint256>& keys_;
+
+public:
+    explicit WriteRecorder(std::vector<uint256>& keys) : keys_(keys)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        keys_.push_back(sle->key());
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const&) override
+    {
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const&,
+        std::shared_ptr<Serializer const> const&,
+        std::shared_ptr<Serializer const> const&) override
+    {
+    }
+};
+
+}  // namespace ripple
+
+#endif
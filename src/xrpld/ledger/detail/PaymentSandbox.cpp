@@ -267,6 +267,12 @@ PaymentSandbox::apply(PaymentSandbox& to)
     tab_.apply(to.tab_);
 }
 
+void
+PaymentSandbox::visitChanges(RawView& to) const
+{
+    items_.apply(to);
+}
+
 std::map<std::tuple<AccountID, AccountID, Currency>, STAmount>
 PaymentSandbox::balanceChanges(ReadView const& view) const
 {
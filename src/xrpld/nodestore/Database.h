@@ -23,13 +23,17 @@
 #include <xrpld/nodestore/Backend.h>
 #include <xrpld/nodestore/NodeObject.h>
 #include <xrpld/nodestore/Scheduler.h>
+#include <xrpld/nodestore/Snapshot.h>
 
 #include <xrpl/basics/BasicConfig.h>
 #include <xrpl/basics/Log.h>
 #include <xrpl/basics/TaggedCache.ipp>
 #include <xrpl/protocol/SystemParameters.h>
 
+#include <array>
 #include <condition_variable>
+#include <map>
+#include <mutex>
 
 namespace ripple {
 
@@ -150,16 +154,21 @@ public:
         to refer to the object, or `nullptr` if the object is not present.
         If I/O is required, the I/O is scheduled and `true` is returned
 
+        Requests for a hash that is already queued are coalesced with the
+        queued read, which is promoted if the new request is more urgent.
+
         @note This can be called concurrently.
         @param hash The key of the object to retrieve
         @param ledgerSeq The sequence of the ledger where the
                 object is stored.
+        @param priority How urgently the object is needed.
         @param callback Callback function when read completes
     */
     virtual void
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
+        FetchPriority priority,
         std::function<void(std::shared_ptr<NodeObject> const&)>&& callback);
 
     /** Remove expired entries from the positive and negative caches. */
@@ -200,9 +209,36 @@ public:
         return fetchSz_;
     }
 
-    void
+    virtual void
     getCountsJson(Json::Value& obj);
 
+    /** Serve fetches that miss the caches from a snapshot before the
+        backend.
+
+        Objects are keyed by the hash of their contents, so a snapshot can
+        serve every ledger that shares objects with the one it was taken
+        of. An object fetched from the snapshot to be duplicated is stored
+        in the backend.
+
+        @param snapshot The snapshot to use, or nullptr to stop using one.
+    */
+    void
+    setSnapshot(std::shared_ptr<Snapshot const> snapshot);
+
+    /** The snapshot in use, or nullptr if none is. */
+    std::shared_ptr<Snapshot const>
+    getSnapshot() const;
+
+    /** The number of reads a SHAMap being synchronized keeps in flight.
+
+        Set by the `sync_reads` key of the configuration. The default is 512.
+    */
+    int
+    syncReads() const
+    {
+        return syncReads_;
+    }
+
     /** Returns the number of file descriptors the database expects to need */
     int
     fdRequired() const
@@ -240,11 +276,15 @@ protected:
     // networks should change this value.
     std::uint32_t const earliestLedgerSeq_;
 
-    // The maximum number of requests a thread extracts from the queue in an
-    // attempt to minimize the overhead of mutex acquisition. This is an
-    // advanced tunable, via the config file. The default value is 4.
+    // The maximum number of requests a thread extracts from the queue and
+    // fetches as one batch. This is an advanced tunable, via the config
+    // file. The default value is 16.
     int const requestBundle_;
 
+    // The number of reads getMissingNodes keeps in flight while it walks a
+    // SHAMap. This is an advanced tunable, via the config file.
+    int const syncReads_;
+
     void
     storeStats(std::uint64_t count, std::uint64_t sz)
     {
@@ -259,6 +299,21 @@ protected:
     void
     importInternal(Backend& dstBackend, Database& srcDB);
 
+    /** Fetch several objects at once for the asynchronous read threads.
+
+        The default fetches each object in turn. Derived classes that can
+        look up several objects in one backend call should override this.
+
+        @param requests The hash of each object and the sequence of the
+                        ledger it belongs to.
+        @return The objects, or nullptr for those that were not found, in
+                the order they were requested.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+        FetchReport& fetchReport);
+
     void
     updateFetchMetrics(uint64_t fetches, uint64_t hits, uint64_t duration)
     {
@@ -267,6 +322,22 @@ protected:
         fetchDurationUs_ += duration;
     }
 
+    /** Fetch an object from the snapshot, if one is in use.
+
+        Derived classes call this when their caches miss, before they look
+        in the backend.
+
+        @param duplicate If set, an object found is also stored in the
+                         backend.
+        @return The object, or nullptr if there is no snapshot or it does
+                not hold the object.
+    */
+    std::shared_ptr<NodeObject>
+    fetchFromSnapshot(
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        bool duplicate);
+
 private:
     std::atomic<std::uint64_t> storeCount_{0};
     std::atomic<std::uint64_t> storeSz_{0};
@@ -274,21 +345,65 @@ private:
     std::atomic<std::uint64_t> fetchDurationUs_{0};
     std::atomic<std::uint64_t> storeDurationUs_{0};
 
-    mutable std::mutex readLock_;
-    std::condition_variable readCondVar_;
+    static constexpr std::size_t priorityCount = 3;
 
-    // reads to do
-    std::map<
+    // Pending reads of one priority, with the callbacks of every request
+    // for each hash
+    using ReadQueue = std::map<
         uint256,
         std::vector<std::pair<
             std::uint32_t,
-            std::function<void(std::shared_ptr<NodeObject> const&)>>>>
-        read_;
+            std::function<void(std::shared_ptr<NodeObject> const&)>>>>;
+
+    // The pending reads are split by hash into shards, each with its own
+    // lock and serviced by its own thread, so that callers requesting reads
+    // and the threads servicing them do not all contend on a single mutex.
+    // A thread with nothing to do takes reads from the shards of the others,
+    // so that a slow fetch does not hold up the reads queued behind it.
+    struct ReadShard
+    {
+        std::mutex mutex;
+        std::condition_variable condVar;
+
+        // reads to do, one queue per priority, most urgent first
+        std::array<ReadQueue, priorityCount> queues;
+        std::size_t size = 0;
+
+        // whether the shard's thread is waiting for reads
+        bool waiting = false;
+    };
+
+    std::vector<std::unique_ptr<ReadShard>> readShards_;
 
     std::atomic<bool> readStopping_ = false;
     std::atomic<int> readThreads_ = 0;
     std::atomic<int> runningThreads_ = 0;
 
+    // Read threads waiting for reads
+    std::atomic<int> idleReadThreads_ = 0;
+
+    // Histograms of the number of hashes each read thread found queued and
+    // fetched in one batch. Bucket i counts values in [2^i, 2^(i+1)).
+    using Histogram = std::array<std::atomic<std::uint64_t>, 12>;
+    Histogram readQueueDepths_{};
+    Histogram readBatchSizes_{};
+
+    // Requests for a hash that was already queued
+    std::atomic<std::uint64_t> readCoalesced_{0};
+
+    // Batches a thread took from the shard of another
+    std::atomic<std::uint64_t> readStolen_{0};
+
+    mutable std::mutex snapshotMutex_;
+    std::shared_ptr<Snapshot const> snapshot_;
+
+    // Whether snapshot_ is set, so that fetches need not take the lock
+    // when it is not, as on servers which never use a snapshot
+    std::atomic<bool> hasSnapshot_{false};
+
+    // Fetches served by the snapshot
+    std::atomic<std::uint64_t> snapshotHits_{0};
+
     virtual std::shared_ptr<NodeObject>
     fetchNodeObject(
         uint256 const& hash,
@@ -306,8 +421,25 @@ private:
     virtual void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) = 0;
 
+    ReadShard&
+    readShard(uint256 const& hash);
+
+    // Move a batch of the most urgent reads of a shard, whose mutex is
+    // held, to `read`
+    void
+    takeReads(ReadShard& shard, ReadQueue& read);
+
+    // Take a batch of reads from a shard other than readShards_[own] whose
+    // thread is busy
+    void
+    stealReads(std::size_t own, ReadQueue& read);
+
+    // Wake a waiting read thread, if there is one
+    void
+    wakeIdleReadThread();
+
     void
-    threadEntry();
+    threadEntry(ReadShard& shard, int index);
 };
 
 }  // namespace NodeStore
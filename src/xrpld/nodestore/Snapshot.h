@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_SNAPSHOT_H_INCLUDED
+#define RIPPLE_NODESTORE_SNAPSHOT_H_INCLUDED
+
+#include <xrpld/nodestore/NodeObject.h>
+
+#include <xrpl/basics/Slice.h>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** An immutable file holding the node objects of one ledger.
+
+    The objects are stored back to back, followed by an index sorted by
+    hash. The file is memory mapped, so opening it costs next to nothing and
+    an object is read from the page cache only when it is fetched.
+
+    The file is in the byte order of the server that wrote it. It is meant
+    to speed up the restart of that server, not to be copied between
+    machines.
+
+    @note This can be called concurrently.
+*/
+class Snapshot
+{
+public:
+    /** Open a snapshot.
+
+        @throws std::runtime_error If the file can not be mapped or is not
+                a complete snapshot.
+    */
+    explicit Snapshot(std::string const& path);
+
+    ~Snapshot();
+
+    Snapshot(Snapshot const&) = delete;
+    Snapshot&
+    operator=(Snapshot const&) = delete;
+
+    /** The sequence of the ledger the snapshot was taken of. */
+    std::uint32_t
+    ledgerSeq() const;
+
+    /** The hash of the ledger the snapshot was taken of. */
+    uint256 const&
+    ledgerHash() const;
+
+    /** The number of objects in the snapshot. */
+    std::size_t
+    size() const;
+
+    /** Return a copy of an object, or nullptr if it is not in the snapshot.
+
+        Until verify() has succeeded, the object is checked to hash to its
+        key, and nullptr is returned if it does not.
+    */
+    std::shared_ptr<NodeObject>
+    fetch(uint256 const& hash) const;
+
+    /** Check the whole snapshot.
+
+        Every object must hash to its key, every root must be present and
+        so must every child of every inner node. Together, these mean that
+        every object reachable from the roots is in the snapshot and intact.
+
+        @param roots The hashes the snapshot must hold the trees of, such as
+                     those of the ledger and of its state and transaction
+                     maps.
+        @param stopping Polled while checking. Once it returns true, the
+                        check gives up.
+        @return `true` if the snapshot is intact, `false` if it is not or
+                the check gave up. Once it has returned `true`, fetch() no
+                longer checks the objects it returns.
+    */
+    bool
+    verify(
+        std::vector<uint256> const& roots,
+        std::function<bool()> const& stopping) const;
+
+private:
+    struct Impl;
+
+    std::unique_ptr<Impl> const impl_;
+};
+
+/** Writes a Snapshot.
+
+    The file is written under a temporary name and only renamed into place
+    by finish(), so a snapshot that was not completed never replaces the
+    previous one.
+*/
+class SnapshotWriter
+{
+public:
+    /** Start a snapshot.
+
+        @throws std::runtime_error If the file can not be created.
+    */
+    SnapshotWriter(
+        std::string const& path,
+        std::uint32_t ledgerSeq,
+        uint256 const& ledgerHash);
+
+    /** Remove the temporary file, unless finish() was called. */
+    ~SnapshotWriter();
+
+    SnapshotWriter(SnapshotWriter const&) = delete;
+    SnapshotWriter&
+    operator=(SnapshotWriter const&) = delete;
+
+    /** Add an object. Objects may be added more than once. */
+    void
+    add(NodeObjectType type, uint256 const& hash, Slice data);
+
+    /** Write the index and rename the file into place.
+
+        @throws std::runtime_error If the file can not be written.
+    */
+    void
+    finish();
+
+private:
+    struct Entry
+    {
+        uint256 hash;
+        std::uint64_t offset;
+        std::uint32_t size;
+        NodeObjectType type;
+    };
+
+    std::string const path_;
+    std::string const tempPath_;
+    std::uint32_t const ledgerSeq_;
+    uint256 const ledgerHash_;
+
+    std::ofstream file_;
+    std::uint64_t offset_;
+    std::vector<Entry> entries_;
+    bool finished_ = false;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -51,6 +51,16 @@ enum Status {
     customCode = 100
 };
 
+/** The urgency of an asynchronous fetch.
+
+    Pending asynchronous reads are serviced in this order.
+*/
+enum class FetchPriority {
+    consensus,  // needed to keep up with consensus
+    catchup,    // acquiring ledgers to catch up with the network
+    background  // history backfill, RPC and other deferrable work
+};
+
 /** A batch of NodeObjects to write at once. */
 using Batch = std::vector<std::shared_ptr<NodeObject>>;
 
@@ -26,6 +26,7 @@
 #include <xrpl/basics/contract.h>
 #include <xrpl/beast/utility/instrumentation.h>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 
 #include <nudb/nudb.hpp>
@@ -56,6 +57,12 @@ public:
     std::atomic<bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Needed to read objects compressed with zstd, if any were stored
+    std::unique_ptr<ZstdDictionary const> const dictionary_;
+
+    // Whether new objects are compressed with zstd rather than lz4
+    bool const useDictionary_;
+
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
@@ -68,6 +75,8 @@ public:
         , name_(get(keyValues, "path"))
         , deletePath_(false)
         , scheduler_(scheduler)
+        , dictionary_(loadDictionary(keyValues))
+        , useDictionary_(useDictionary(keyValues, dictionary_ != nullptr))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -88,12 +97,45 @@ public:
         , db_(context)
         , deletePath_(false)
         , scheduler_(scheduler)
+        , dictionary_(loadDictionary(keyValues))
+        , useDictionary_(useDictionary(keyValues, dictionary_ != nullptr))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
                 "nodestore: Missing path in NuDB backend");
     }
 
+    static std::unique_ptr<ZstdDictionary const>
+    loadDictionary(Section const& keyValues)
+    {
+        auto const path = get(keyValues, "compression_dictionary");
+        if (path.empty())
+            return nullptr;
+
+        return ZstdDictionary::load(
+            path, get<int>(keyValues, "compression_level", 3));
+    }
+
+    static bool
+    useDictionary(Section const& keyValues, bool haveDictionary)
+    {
+        auto const compression = get(keyValues, "compression", "lz4");
+        if (boost::iequals(compression, "lz4"))
+            return false;
+
+        if (!boost::iequals(compression, "zstd"))
+            Throw<std::runtime_error>(
+                "nodestore: Unknown compression '" + compression +
+                "' in NuDB backend");
+
+        if (!haveDictionary)
+            Throw<std::runtime_error>(
+                "nodestore: compression=zstd requires a "
+                "compression_dictionary in NuDB backend");
+
+        return true;
+    }
+
     ~NuDBBackend() override
     {
         try
@@ -206,9 +248,10 @@ public:
         nudb::error_code ec;
         db_.fetch(
             key,
-            [key, pno, &status](void const* data, std::size_t size) {
+            [this, key, pno, &status](void const* data, std::size_t size) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, dictionary_.get());
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -250,7 +293,11 @@ public:
         EncodedBlob e(no);
         nudb::error_code ec;
         nudb::detail::buffer bf;
-        auto const result = nodeobject_compress(e.getData(), e.getSize(), bf);
+        auto const result = nodeobject_compress(
+            e.getData(),
+            e.getSize(),
+            bf,
+            useDictionary_ ? dictionary_.get() : nullptr);
         db_.insert(e.getKey(), result.first, result.second, ec);
         if (ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
@@ -305,7 +352,8 @@ public:
                 std::size_t size,
                 nudb::error_code&) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, dictionary_.get());
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
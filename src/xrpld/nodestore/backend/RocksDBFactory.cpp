@@ -333,16 +333,43 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
+        XRPL_ASSERT(
+            m_db,
+            "ripple::NodeStore::RocksDBBackend::fetchBatch : non-null "
+            "database");
+
+        // Look all the keys up in one call so that RocksDB can batch the
+        // block cache lookups and reads.
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
+        for (auto const& h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        std::vector<std::string> values;
+        auto const statuses =
+            m_db->MultiGet(rocksdb::ReadOptions(), keys, &values);
+
         std::vector<std::shared_ptr<NodeObject>> results;
         results.reserve(hashes.size());
-        for (auto const& h : hashes)
+        for (std::size_t i = 0; i < hashes.size(); ++i)
         {
             std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+
+            if (statuses[i].ok())
+            {
+                DecodedBlob decoded(
+                    hashes[i]->data(), values[i].data(), values[i].size());
+
+                if (decoded.wasOk())
+                    nObj = decoded.createObject();
+            }
+            else if (!statuses[i].IsNotFound())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString();
+            }
+
+            results.push_back(std::move(nObj));
         }
 
         return {results, ok};
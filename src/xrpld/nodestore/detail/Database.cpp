@@ -25,11 +25,45 @@
 #include <xrpl/protocol/HashPrefix.h>
 #include <xrpl/protocol/jss.h>
 
+#include <bit>
 #include <chrono>
+#include <numeric>
 
 namespace ripple {
 namespace NodeStore {
 
+namespace {
+
+template <std::size_t N>
+void
+addSample(std::array<std::atomic<std::uint64_t>, N>& histogram, std::size_t n)
+{
+    XRPL_ASSERT(n != 0, "ripple::NodeStore::addSample : nonzero value");
+    auto const bucket =
+        std::min<std::size_t>(std::bit_width(n) - 1, histogram.size() - 1);
+    ++histogram[bucket];
+}
+
+template <std::size_t N>
+Json::Value
+toJson(std::array<std::atomic<std::uint64_t>, N> const& histogram)
+{
+    Json::Value ret(Json::objectValue);
+    for (std::size_t i = 0; i < histogram.size(); ++i)
+    {
+        auto const low = std::size_t{1} << i;
+        auto const high = (low << 1) - 1;
+        std::string const bucket = (i + 1 == histogram.size())
+            ? std::to_string(low) + "+"
+            : (low == high) ? std::to_string(low)
+                            : std::to_string(low) + "-" + std::to_string(high);
+        ret[bucket] = std::to_string(histogram[i].load());
+    }
+    return ret;
+}
+
+}  // namespace
+
 Database::Database(
     Scheduler& scheduler,
     int readThreads,
@@ -39,7 +73,8 @@ Database::Database(
     , scheduler_(scheduler)
     , earliestLedgerSeq_(
           get<std::uint32_t>(config, "earliest_seq", XRP_LEDGER_EARLIEST_SEQ))
-    , requestBundle_(get<int>(config, "rq_bundle", 4))
+    , requestBundle_(get<int>(config, "rq_bundle", 16))
+    , syncReads_(get<int>(config, "sync_reads", 512))
     , readThreads_(std::max(1, readThreads))
 {
     XRPL_ASSERT(
@@ -52,79 +87,17 @@ Database::Database(
     if (requestBundle_ < 1 || requestBundle_ > 64)
         Throw<std::runtime_error>("Invalid rq_bundle");
 
+    if (syncReads_ < 1 || syncReads_ > 65536)
+        Throw<std::runtime_error>("Invalid sync_reads");
+
+    // Each read thread services its own shard of the pending reads
+    for (int i = readThreads_.load(); i != 0; --i)
+        readShards_.push_back(std::make_unique<ReadShard>());
+
     for (int i = readThreads_.load(); i != 0; --i)
     {
         std::thread t(
-            [this](int i) {
-                runningThreads_++;
-
-                beast::setCurrentThreadName(
-                    "db prefetch #" + std::to_string(i));
-
-                decltype(read_) read;
-
-                while (true)
-                {
-                    {
-                        std::unique_lock<std::mutex> lock(readLock_);
-
-                        if (isStopping())
-                            break;
-
-                        if (read_.empty())
-                        {
-                            runningThreads_--;
-                            readCondVar_.wait(lock);
-                            runningThreads_++;
-                        }
-
-                        if (isStopping())
-                            break;
-
-                        // extract multiple object at a time to minimize the
-                        // overhead of acquiring the mutex.
-                        for (int cnt = 0;
-                             !read_.empty() && cnt != requestBundle_;
-                             ++cnt)
-                            read.insert(read_.extract(read_.begin()));
-                    }
-
-                    for (auto it = read.begin(); it != read.end(); ++it)
-                    {
-                        XRPL_ASSERT(
-                            !it->second.empty(),
-                            "ripple::NodeStore::Database::Database : non-empty "
-                            "data");
-
-                        auto const& hash = it->first;
-                        auto const& data = it->second;
-                        auto const seqn = data[0].first;
-
-                        auto obj =
-                            fetchNodeObject(hash, seqn, FetchType::async);
-
-                        // This could be further optimized: if there are
-                        // multiple requests for sequence numbers mapping to
-                        // multiple databases by sorting requests such that all
-                        // indices mapping to the same database are grouped
-                        // together and serviced by a single read.
-                        for (auto const& req : data)
-                        {
-                            req.second(
-                                (seqn == req.first) || isSameDB(req.first, seqn)
-                                    ? obj
-                                    : fetchNodeObject(
-                                          hash, req.first, FetchType::async));
-                        }
-                    }
-
-                    read.clear();
-                }
-
-                --runningThreads_;
-                --readThreads_;
-            },
-            i);
+            &Database::threadEntry, this, std::ref(*readShards_[i - 1]), i);
         t.detach();
     }
 }
@@ -149,14 +122,17 @@ Database::isStopping() const
 void
 Database::stop()
 {
+    if (!readStopping_.exchange(true, std::memory_order_relaxed))
     {
-        std::lock_guard lock(readLock_);
+        JLOG(j_.debug()) << "Clearing read queue because of stop request";
 
-        if (!readStopping_.exchange(true, std::memory_order_relaxed))
+        for (auto& shard : readShards_)
         {
-            JLOG(j_.debug()) << "Clearing read queue because of stop request";
-            read_.clear();
-            readCondVar_.notify_all();
+            std::lock_guard lock(shard->mutex);
+            for (auto& queue : shard->queues)
+                queue.clear();
+            shard->size = 0;
+            shard->condVar.notify_all();
         }
     }
 
@@ -181,19 +157,269 @@ Database::stop()
                      << " millseconds";
 }
 
+Database::ReadShard&
+Database::readShard(uint256 const& hash)
+{
+    // Hashes are uniformly distributed, so any of their bytes will do
+    std::size_t const key = hash.data()[0] | (hash.data()[1] << 8);
+    return *readShards_[key % readShards_.size()];
+}
+
+void
+Database::takeReads(ReadShard& shard, ReadQueue& read)
+{
+    addSample(readQueueDepths_, shard.size);
+
+    // Take a batch of the most urgent reads, so that they can be fetched
+    // together and the mutex is acquired less often.
+    for (auto& queue : shard.queues)
+    {
+        while (!queue.empty() &&
+               read.size() != static_cast<std::size_t>(requestBundle_))
+        {
+            read.insert(queue.extract(queue.begin()));
+            --shard.size;
+        }
+    }
+}
+
+void
+Database::stealReads(std::size_t own, ReadQueue& read)
+{
+    auto const n = readShards_.size();
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        auto& shard = *readShards_[(own + i) % n];
+        std::lock_guard lock(shard.mutex);
+
+        // A waiting thread has been woken for its reads already
+        if (shard.waiting || shard.size == 0)
+            continue;
+
+        takeReads(shard, read);
+        ++readStolen_;
+        return;
+    }
+}
+
+void
+Database::wakeIdleReadThread()
+{
+    for (auto& shard : readShards_)
+    {
+        std::lock_guard lock(shard->mutex);
+        if (shard->waiting)
+        {
+            shard->condVar.notify_one();
+            return;
+        }
+    }
+}
+
+void
+Database::threadEntry(ReadShard& shard, int index)
+{
+    runningThreads_++;
+
+    beast::setCurrentThreadName("db prefetch #" + std::to_string(index));
+
+    ReadQueue read;
+    std::vector<std::pair<uint256, std::uint32_t>> requests;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+
+            if (isStopping())
+                break;
+
+            if (shard.size != 0)
+                takeReads(shard, read);
+        }
+
+        if (read.empty())
+            stealReads(index - 1, read);
+
+        if (read.empty())
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+
+            if (isStopping())
+                break;
+
+            if (shard.size == 0)
+            {
+                runningThreads_--;
+                ++idleReadThreads_;
+                shard.waiting = true;
+                shard.condVar.wait(lock);
+                shard.waiting = false;
+                --idleReadThreads_;
+                runningThreads_++;
+            }
+            continue;
+        }
+
+        requests.clear();
+        for (auto const& [hash, data] : read)
+        {
+            XRPL_ASSERT(
+                !data.empty(),
+                "ripple::NodeStore::Database::threadEntry : non-empty data");
+            requests.emplace_back(hash, data[0].first);
+        }
+
+        addSample(readBatchSizes_, requests.size());
+
+        FetchReport fetchReport(FetchType::async);
+
+        using namespace std::chrono;
+        auto const begin{steady_clock::now()};
+
+        auto const objects = fetchNodeObjects(requests, fetchReport);
+
+        auto const dur = steady_clock::now() - begin;
+        fetchDurationUs_ += duration_cast<microseconds>(dur).count();
+        fetchTotalCount_ += objects.size();
+        for (auto const& obj : objects)
+        {
+            if (obj)
+            {
+                ++fetchHitCount_;
+                fetchSz_ += obj->getData().size();
+            }
+        }
+
+        fetchReport.elapsed = duration_cast<milliseconds>(dur);
+        scheduler_.onFetch(fetchReport);
+
+        std::size_t i = 0;
+        for (auto const& [hash, data] : read)
+        {
+            auto const& obj = objects[i++];
+            auto const seqn = data[0].first;
+
+            // This could be further optimized: if there are multiple
+            // requests for sequence numbers mapping to multiple databases
+            // by sorting requests such that all indices mapping to the same
+            // database are grouped together and serviced by a single read.
+            for (auto const& req : data)
+            {
+                req.second(
+                    (seqn == req.first) || isSameDB(req.first, seqn)
+                        ? obj
+                        : fetchNodeObject(hash, req.first, FetchType::async));
+            }
+        }
+
+        read.clear();
+    }
+
+    --runningThreads_;
+    --readThreads_;
+}
+
 void
 Database::asyncFetch(
     uint256 const& hash,
     std::uint32_t ledgerSeq,
+    FetchPriority priority,
     std::function<void(std::shared_ptr<NodeObject> const&)>&& cb)
 {
-    std::lock_guard lock(readLock_);
+    auto const p = static_cast<std::size_t>(priority);
+    XRPL_ASSERT(
+        p < priorityCount,
+        "ripple::NodeStore::Database::asyncFetch : valid priority");
+
+    auto& shard = readShard(hash);
+    std::unique_lock lock(shard.mutex);
+
+    if (isStopping())
+        return;
+
+    auto& queues = shard.queues;
+
+    // If this hash is already queued, add this request to the queued read
+    // instead, moving the read up if this request is more urgent.
+    for (std::size_t i = 0; i != priorityCount; ++i)
+    {
+        auto it = queues[i].find(hash);
+        if (it == queues[i].end())
+            continue;
+
+        ++readCoalesced_;
+        it->second.emplace_back(ledgerSeq, std::move(cb));
+        if (i > p)
+            queues[p].insert(queues[i].extract(it));
+        return;
+    }
+
+    queues[p][hash].emplace_back(ledgerSeq, std::move(cb));
+    ++shard.size;
+    if (shard.waiting)
+    {
+        shard.condVar.notify_one();
+        return;
+    }
+
+    // The shard's thread is busy, so another may take the read
+    lock.unlock();
+    if (idleReadThreads_ != 0)
+        wakeIdleReadThread();
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchNodeObjects(
+    std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+    FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(requests.size());
+    for (auto const& [hash, ledgerSeq] : requests)
+        results.push_back(fetchNodeObject(hash, ledgerSeq, fetchReport, false));
+    return results;
+}
 
-    if (!isStopping())
+std::shared_ptr<NodeObject>
+Database::fetchFromSnapshot(
+    uint256 const& hash,
+    std::uint32_t ledgerSeq,
+    bool duplicate)
+{
+    auto const snapshot = getSnapshot();
+    if (!snapshot)
+        return {};
+
+    auto nodeObject = snapshot->fetch(hash);
+    if (!nodeObject)
+        return {};
+
+    ++snapshotHits_;
+    if (duplicate)
     {
-        read_[hash].emplace_back(ledgerSeq, std::move(cb));
-        readCondVar_.notify_one();
+        Blob data(nodeObject->getData());
+        store(nodeObject->getType(), std::move(data), hash, ledgerSeq);
     }
+    return nodeObject;
+}
+
+void
+Database::setSnapshot(std::shared_ptr<Snapshot const> snapshot)
+{
+    std::lock_guard lock(snapshotMutex_);
+    snapshot_ = std::move(snapshot);
+    hasSnapshot_.store(snapshot_ != nullptr, std::memory_order_relaxed);
+}
+
+std::shared_ptr<Snapshot const>
+Database::getSnapshot() const
+{
+    if (!hasSnapshot_.load(std::memory_order_relaxed))
+        return {};
+
+    std::lock_guard lock(snapshotMutex_);
+    return snapshot_;
 }
 
 void
@@ -271,14 +497,40 @@ Database::getCountsJson(Json::Value& obj)
         obj.isObject(),
         "ripple::NodeStore::Database::getCountsJson : valid input type");
 
+    std::array<std::size_t, priorityCount> queued{};
+    for (auto& shard : readShards_)
+    {
+        std::lock_guard lock(shard->mutex);
+        for (std::size_t i = 0; i != priorityCount; ++i)
+            queued[i] += shard->queues[i].size();
+    }
+
+    obj["read_queue"] = static_cast<Json::UInt>(
+        std::accumulate(queued.begin(), queued.end(), std::size_t{0}));
     {
-        std::unique_lock<std::mutex> lock(readLock_);
-        obj["read_queue"] = static_cast<Json::UInt>(read_.size());
+        Json::Value& byPriority =
+            (obj["read_queue_priority"] = Json::objectValue);
+        byPriority["consensus"] = static_cast<Json::UInt>(queued[0]);
+        byPriority["catchup"] = static_cast<Json::UInt>(queued[1]);
+        byPriority["background"] = static_cast<Json::UInt>(queued[2]);
     }
+    obj["read_queue_depths"] = toJson(readQueueDepths_);
+    obj["read_batch_sizes"] = toJson(readBatchSizes_);
+    obj["read_coalesced"] = std::to_string(readCoalesced_);
+    obj["read_stolen"] = std::to_string(readStolen_);
 
     obj["read_threads_total"] = readThreads_.load();
     obj["read_threads_running"] = runningThreads_.load();
     obj["read_request_bundle"] = requestBundle_;
+    obj["read_sync_limit"] = syncReads_;
+
+    if (auto const snapshot = getSnapshot())
+    {
+        Json::Value& snap = (obj["snapshot"] = Json::objectValue);
+        snap[jss::ledger_index] = snapshot->ledgerSeq();
+        snap["objects"] = std::to_string(snapshot->size());
+        snap["hits"] = std::to_string(snapshotHits_);
+    }
 
     obj[jss::node_writes] = std::to_string(storeCount_);
     obj[jss::node_reads_total] = std::to_string(fetchTotalCount_);
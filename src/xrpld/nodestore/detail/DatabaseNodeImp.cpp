@@ -33,6 +33,8 @@ DatabaseNodeImp::store(
 
     auto obj = NodeObject::createObject(type, std::move(data), hash);
     backend_->store(obj);
+    if (objectCache_)
+        objectCache_->insert(*obj);
     if (cache_)
     {
         // After the store, replace a negative cache entry if there is one
@@ -47,6 +49,7 @@ void
 DatabaseNodeImp::asyncFetch(
     uint256 const& hash,
     std::uint32_t ledgerSeq,
+    FetchPriority priority,
     std::function<void(std::shared_ptr<NodeObject> const&)>&& callback)
 {
     if (cache_)
@@ -58,7 +61,7 @@ DatabaseNodeImp::asyncFetch(
             return;
         }
     }
-    Database::asyncFetch(hash, ledgerSeq, std::move(callback));
+    Database::asyncFetch(hash, ledgerSeq, priority, std::move(callback));
 }
 
 void
@@ -68,16 +71,44 @@ DatabaseNodeImp::sweep()
         cache_->sweep();
 }
 
+void
+DatabaseNodeImp::getCountsJson(Json::Value& obj)
+{
+    Database::getCountsJson(obj);
+
+    if (objectCache_)
+        obj["object_cache"] = objectCache_->getCountsJson();
+}
+
 std::shared_ptr<NodeObject>
 DatabaseNodeImp::fetchNodeObject(
     uint256 const& hash,
-    std::uint32_t,
+    std::uint32_t ledgerSeq,
     FetchReport& fetchReport,
     bool duplicate)
 {
     std::shared_ptr<NodeObject> nodeObject =
         cache_ ? cache_->fetch(hash) : nullptr;
 
+    if (!nodeObject && objectCache_)
+    {
+        nodeObject = objectCache_->fetch(hash);
+        if (nodeObject && cache_)
+            cache_->canonicalize_replace_client(hash, nodeObject);
+    }
+
+    if (!nodeObject)
+    {
+        nodeObject = fetchFromSnapshot(hash, ledgerSeq, duplicate);
+        if (nodeObject)
+        {
+            if (objectCache_)
+                objectCache_->admit(*nodeObject);
+            if (cache_)
+                cache_->canonicalize_replace_client(hash, nodeObject);
+        }
+    }
+
     if (!nodeObject)
     {
         JLOG(j_.trace()) << "fetchNodeObject " << hash << ": record not "
@@ -100,6 +131,9 @@ DatabaseNodeImp::fetchNodeObject(
         switch (status)
         {
             case ok:
+                if (nodeObject && objectCache_)
+                    objectCache_->admit(*nodeObject);
+
                 if (cache_)
                 {
                     if (nodeObject)
@@ -144,24 +178,97 @@ DatabaseNodeImp::fetchNodeObject(
 std::vector<std::shared_ptr<NodeObject>>
 DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
 {
-    std::vector<std::shared_ptr<NodeObject>> results{hashes.size()};
     using namespace std::chrono;
     auto const before = steady_clock::now();
-    std::unordered_map<uint256 const*, size_t> indexMap;
+
+    std::vector<uint256 const*> ptrs;
+    ptrs.reserve(hashes.size());
+    for (auto const& hash : hashes)
+        ptrs.push_back(&hash);
+
+    std::vector<std::shared_ptr<NodeObject>> results;
+    auto const hits = fetchBatch(ptrs, results);
+
+    JLOG(j_.debug()) << "fetchBatch - cache hits = " << hits
+                     << " - cache misses = " << (hashes.size() - hits);
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        if (!results[i])
+        {
+            JLOG(j_.error()) << "fetchBatch - "
+                             << "record not found in db or cache. hash = "
+                             << strHex(hashes[i]);
+        }
+    }
+
+    auto fetchDurationUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock::now() - before)
+            .count();
+    updateFetchMetrics(hashes.size(), hits, fetchDurationUs);
+    return results;
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseNodeImp::fetchNodeObjects(
+    std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+    FetchReport& fetchReport)
+{
+    std::vector<uint256 const*> hashes;
+    hashes.reserve(requests.size());
+    for (auto const& request : requests)
+        hashes.push_back(&request.first);
+
+    std::vector<std::shared_ptr<NodeObject>> results;
+    fetchBatch(hashes, results);
+
+    for (auto const& nodeObject : results)
+    {
+        if (nodeObject)
+            fetchReport.wasFound = true;
+    }
+
+    return results;
+}
+
+std::uint64_t
+DatabaseNodeImp::fetchBatch(
+    std::vector<uint256 const*> const& hashes,
+    std::vector<std::shared_ptr<NodeObject>>& results)
+{
+    results.assign(hashes.size(), nullptr);
+
+    std::vector<std::size_t> indexes;
     std::vector<uint256 const*> cacheMisses;
-    uint64_t hits = 0;
-    uint64_t fetches = 0;
-    for (size_t i = 0; i < hashes.size(); ++i)
+    std::uint64_t hits = 0;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
     {
-        auto const& hash = hashes[i];
         // See if the object already exists in the cache
-        auto nObj = cache_ ? cache_->fetch(hash) : nullptr;
-        ++fetches;
+        auto nObj = cache_ ? cache_->fetch(*hashes[i]) : nullptr;
+        if (!nObj && objectCache_)
+        {
+            nObj = objectCache_->fetch(*hashes[i]);
+            if (nObj && cache_)
+                cache_->canonicalize_replace_client(*hashes[i], nObj);
+        }
+
         if (!nObj)
         {
+            nObj = fetchFromSnapshot(*hashes[i], 0, false);
+            if (nObj)
+            {
+                if (objectCache_)
+                    objectCache_->admit(*nObj);
+                if (cache_)
+                    cache_->canonicalize_replace_client(*hashes[i], nObj);
+                results[i] = std::move(nObj);
+                continue;
+            }
+
             // Try the database
-            indexMap[&hash] = i;
-            cacheMisses.push_back(&hash);
+            indexes.push_back(i);
+            cacheMisses.push_back(hashes[i]);
         }
         else
         {
@@ -171,45 +278,46 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
     }
 
-    JLOG(j_.debug()) << "fetchBatch - cache hits = "
-                     << (hashes.size() - cacheMisses.size())
-                     << " - cache misses = " << cacheMisses.size();
-    auto dbResults = backend_->fetchBatch(cacheMisses).first;
+    if (cacheMisses.empty())
+        return hits;
+
+    std::vector<std::shared_ptr<NodeObject>> dbResults;
+    try
+    {
+        dbResults = backend_->fetchBatch(cacheMisses).first;
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "fetchBatch - Exception fetching from backend: "
+                         << e.what();
+        Rethrow();
+    }
 
-    for (size_t i = 0; i < dbResults.size(); ++i)
+    for (std::size_t i = 0; i < dbResults.size(); ++i)
     {
         auto nObj = std::move(dbResults[i]);
-        size_t index = indexMap[cacheMisses[i]];
-        auto const& hash = hashes[index];
+        auto const& hash = *cacheMisses[i];
 
         if (nObj)
         {
+            if (objectCache_)
+                objectCache_->admit(*nObj);
+
             // Ensure all threads get the same object
             if (cache_)
                 cache_->canonicalize_replace_client(hash, nObj);
         }
-        else
+        else if (cache_)
         {
-            JLOG(j_.error())
-                << "fetchBatch - "
-                << "record not found in db or cache. hash = " << strHex(hash);
-            if (cache_)
-            {
-                auto notFound = NodeObject::createObject(hotDUMMY, {}, hash);
-                cache_->canonicalize_replace_client(hash, notFound);
-                if (notFound->getType() != hotDUMMY)
-                    nObj = std::move(notFound);
-            }
+            auto notFound = NodeObject::createObject(hotDUMMY, {}, hash);
+            cache_->canonicalize_replace_client(hash, notFound);
+            if (notFound->getType() != hotDUMMY)
+                nObj = std::move(notFound);
         }
-        results[index] = std::move(nObj);
+        results[indexes[i]] = std::move(nObj);
     }
 
-    auto fetchDurationUs =
-        std::chrono::duration_cast<std::chrono::microseconds>(
-            steady_clock::now() - before)
-            .count();
-    updateFetchMetrics(fetches, hits, fetchDurationUs);
-    return results;
+    return hits;
 }
 
 }  // namespace NodeStore
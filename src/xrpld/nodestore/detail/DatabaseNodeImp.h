@@ -21,7 +21,9 @@
 #define RIPPLE_NODESTORE_DATABASENODEIMP_H_INCLUDED
 
 #include <xrpld/nodestore/Database.h>
+#include <xrpld/nodestore/detail/NodeObjectCache.h>
 
+#include <xrpl/basics/ByteUtilities.h>
 #include <xrpl/basics/TaggedCache.h>
 #include <xrpl/basics/chrono.h>
 
@@ -77,6 +79,20 @@ public:
                 j);
         }
 
+        if (config.exists("object_cache_mb"))
+        {
+            auto const objectCacheMB = get<int>(config, "object_cache_mb");
+            if (objectCacheMB < 0)
+            {
+                Throw<std::runtime_error>(
+                    "Specified negative value for object_cache_mb");
+            }
+
+            if (objectCacheMB > 0)
+                objectCache_ = std::make_unique<NodeObjectCache>(
+                    megabytes(objectCacheMB), j);
+        }
+
         XRPL_ASSERT(
             backend_,
             "ripple::NodeStore::DatabaseNodeImp::DatabaseNodeImp : non-null "
@@ -130,16 +146,23 @@ public:
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
+        FetchPriority priority,
         std::function<void(std::shared_ptr<NodeObject> const&)>&& callback)
         override;
 
     void
     sweep() override;
 
+    void
+    getCountsJson(Json::Value& obj) override;
+
 private:
     // Cache for database objects. This cache is not always initialized. Check
     // for null before using.
     std::shared_ptr<TaggedCache<uint256, NodeObject>> cache_;
+    // Byte-budgeted cache of object data below cache_. This cache is not
+    // always initialized. Check for null before using.
+    std::unique_ptr<NodeObjectCache> objectCache_;
     // Persistent key/value storage
     std::shared_ptr<Backend> backend_;
 
@@ -150,6 +173,18 @@ private:
         FetchReport& fetchReport,
         bool duplicate) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+        FetchReport& fetchReport) override;
+
+    // Look the hashes up in the cache and fetch the rest from the backend
+    // in one batch. Returns the number of cache hits.
+    std::uint64_t
+    fetchBatch(
+        std::vector<uint256 const*> const& hashes,
+        std::vector<std::shared_ptr<NodeObject>>& results);
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
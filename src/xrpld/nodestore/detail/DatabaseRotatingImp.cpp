@@ -127,7 +127,7 @@ DatabaseRotatingImp::sweep()
 std::shared_ptr<NodeObject>
 DatabaseRotatingImp::fetchNodeObject(
     uint256 const& hash,
-    std::uint32_t,
+    std::uint32_t ledgerSeq,
     FetchReport& fetchReport,
     bool duplicate)
 {
@@ -160,7 +160,13 @@ DatabaseRotatingImp::fetchNodeObject(
         return nodeObject;
     };
 
-    // See if the node object exists in the cache
+    // There is no cache, so the snapshot is looked in first
+    if (auto nodeObject = fetchFromSnapshot(hash, ledgerSeq, duplicate))
+    {
+        fetchReport.wasFound = true;
+        return nodeObject;
+    }
+
     std::shared_ptr<NodeObject> nodeObject;
 
     auto [writable, archive] = [&] {
@@ -194,6 +200,102 @@ DatabaseRotatingImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchNodeObjects(
+    std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+    FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results(requests.size());
+
+    // The indexes of the requests not yet found, and their hashes
+    std::vector<std::size_t> indexes;
+    std::vector<uint256 const*> misses;
+    indexes.reserve(requests.size());
+    misses.reserve(requests.size());
+
+    // There is no cache, so the snapshot is looked in first
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+        auto const& [hash, ledgerSeq] = requests[i];
+        results[i] = fetchFromSnapshot(hash, ledgerSeq, false);
+        if (!results[i])
+        {
+            indexes.push_back(i);
+            misses.push_back(&hash);
+        }
+    }
+
+    if (misses.empty())
+    {
+        fetchReport.wasFound = !requests.empty();
+        return results;
+    }
+
+    auto [writable, archive] = [&] {
+        std::lock_guard lock(mutex_);
+        return std::make_pair(writableBackend_, archiveBackend_);
+    }();
+
+    // Fetch the misses from a backend, leaving those still missing
+    auto fetch = [&](std::shared_ptr<Backend> const& backend) {
+        std::pair<std::vector<std::shared_ptr<NodeObject>>, Status> batch;
+        try
+        {
+            batch = backend->fetchBatch(misses);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.fatal()) << "Exception, " << e.what();
+            Rethrow();
+        }
+
+        if (batch.second != ok && batch.second != notFound)
+            JLOG(j_.warn()) << "Batch fetch status=" << batch.second;
+
+        Batch found;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < misses.size(); ++i)
+        {
+            if (auto& nodeObject = batch.first[i])
+            {
+                found.push_back(nodeObject);
+                results[indexes[i]] = std::move(nodeObject);
+            }
+            else
+            {
+                indexes[kept] = indexes[i];
+                misses[kept] = misses[i];
+                ++kept;
+            }
+        }
+        indexes.resize(kept);
+        misses.resize(kept);
+        return found;
+    };
+
+    fetch(writable);
+    if (!misses.empty())
+    {
+        auto const found = fetch(archive);
+        if (!found.empty())
+        {
+            {
+                // Refresh the writable backend pointer
+                std::lock_guard lock(mutex_);
+                writable = writableBackend_;
+            }
+
+            // Update writable backend with data from the archive backend
+            writable->storeBatch(found);
+        }
+    }
+
+    if (misses.size() != requests.size())
+        fetchReport.wasFound = true;
+
+    return results;
+}
+
 void
 DatabaseRotatingImp::for_each(
     std::function<void(std::shared_ptr<NodeObject>)> f)
@@ -93,6 +93,14 @@ private:
         FetchReport& fetchReport,
         bool duplicate) override;
 
+    // Fetch from the writable backend in one batch, then fetch what it
+    // lacks from the archive backend in another, copying those found
+    // forward.
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<std::pair<uint256, std::uint32_t>> const& requests,
+        FetchReport& fetchReport) override;
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
 };
@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/nodestore/detail/NodeObjectCache.h>
+
+#include <xrpl/basics/ByteUtilities.h>
+#include <xrpl/basics/Log.h>
+#include <xrpl/beast/utility/instrumentation.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace ripple {
+namespace NodeStore {
+
+NodeObjectCache::FrequencySketch::FrequencySketch(std::size_t width)
+    : counters_(depth * width, 0), mask_(width - 1), sampleSize_(10 * width)
+{
+    XRPL_ASSERT(
+        std::has_single_bit(width),
+        "ripple::NodeStore::NodeObjectCache::FrequencySketch::"
+        "FrequencySketch : power of two width");
+}
+
+std::size_t
+NodeObjectCache::FrequencySketch::index(uint256 const& hash, std::size_t row)
+    const
+{
+    // The hash is uniformly distributed, so each row can simply use a
+    // different part of it.
+    std::uint64_t word;
+    std::memcpy(&word, hash.data() + row * sizeof(word), sizeof(word));
+    return row * (mask_ + 1) + (word & mask_);
+}
+
+void
+NodeObjectCache::FrequencySketch::increment(uint256 const& hash)
+{
+    for (std::size_t row = 0; row != depth; ++row)
+    {
+        auto& counter = counters_[index(hash, row)];
+        if (counter < maxCount)
+            ++counter;
+    }
+
+    // Age the counts, so that the sketch reflects recent accesses
+    if (++samples_ >= sampleSize_)
+    {
+        for (auto& counter : counters_)
+            counter >>= 1;
+        samples_ /= 2;
+    }
+}
+
+std::uint8_t
+NodeObjectCache::FrequencySketch::estimate(uint256 const& hash) const
+{
+    std::uint8_t count = maxCount;
+    for (std::size_t row = 0; row != depth; ++row)
+        count = std::min(count, counters_[index(hash, row)]);
+    return count;
+}
+
+//------------------------------------------------------------------------------
+
+NodeObjectCache::NodeObjectCache(std::size_t budget, beast::Journal journal)
+    : j_(journal)
+    , slabSize_(std::clamp<std::size_t>(
+          std::bit_floor(std::max<std::size_t>(budget / shardCount / 8, 1)),
+          kilobytes(4),
+          megabytes(1)))
+    , maxSlabs_(std::max<std::size_t>(budget / shardCount / slabSize_, 2))
+{
+    // Roughly one counter per row for every object a shard can hold
+    auto const sketchWidth = std::bit_ceil(
+        std::max<std::size_t>(maxSlabs_ * slabSize_ / 128, 64));
+
+    shards_.reserve(shardCount);
+    for (std::size_t i = 0; i != shardCount; ++i)
+        shards_.push_back(std::make_unique<Shard>(sketchWidth));
+
+    JLOG(j_.info()) << "Node object cache: " << shardCount << " shards of "
+                    << maxSlabs_ << " slabs of " << slabSize_ << " bytes";
+}
+
+NodeObjectCache::Shard&
+NodeObjectCache::shard(uint256 const& hash)
+{
+    // Use the byte that the frequency sketch does not look at
+    return *shards_[hash.data()[hash.size() - 1] % shardCount];
+}
+
+std::shared_ptr<NodeObject>
+NodeObjectCache::fetch(uint256 const& hash)
+{
+    auto& s = shard(hash);
+
+    NodeObjectType type;
+    Blob data;
+    {
+        std::lock_guard lock(s.mutex);
+
+        s.sketch.increment(hash);
+
+        auto const it = s.entries.find(hash);
+        if (it == s.entries.end())
+        {
+            ++misses_;
+            return nullptr;
+        }
+
+        auto const& entry = it->second;
+        auto const& slab = s.slabs[entry.slab - s.firstSlab];
+        auto const begin = slab.data.get() + entry.offset;
+
+        type = entry.type;
+        data.assign(begin, begin + entry.size);
+    }
+
+    ++hits_;
+    return NodeObject::createObject(type, std::move(data), hash);
+}
+
+void
+NodeObjectCache::admit(NodeObject const& object)
+{
+    insert(shard(object.getHash()), object, false);
+}
+
+void
+NodeObjectCache::insert(NodeObject const& object)
+{
+    insert(shard(object.getHash()), object, true);
+}
+
+void
+NodeObjectCache::insert(Shard& s, NodeObject const& object, bool force)
+{
+    auto const& hash = object.getHash();
+    auto const& data = object.getData();
+
+    // Large objects would waste the end of too many slabs
+    if (data.empty() || data.size() > slabSize_ / 4)
+        return;
+
+    std::lock_guard lock(s.mutex);
+
+    if (s.entries.count(hash) != 0)
+        return;
+
+    bool const slabFull =
+        s.slabs.empty() || (s.slabs.back().used + data.size() > slabSize_);
+
+    if (slabFull && s.slabs.size() == maxSlabs_ && !force &&
+        s.sketch.estimate(hash) < frequentAccesses)
+    {
+        ++rejections_;
+        return;
+    }
+
+    if (slabFull)
+        addSlab(s);
+
+    s.entries.emplace(
+        hash, copyIn(s, hash, object.getType(), data.data(), data.size()));
+    bytes_ += data.size();
+    ++entries_;
+}
+
+NodeObjectCache::Entry
+NodeObjectCache::copyIn(
+    Shard& s,
+    uint256 const& hash,
+    NodeObjectType type,
+    std::uint8_t const* data,
+    std::size_t size)
+{
+    auto& slab = s.slabs.back();
+
+    XRPL_ASSERT(
+        slab.used + size <= slabSize_,
+        "ripple::NodeStore::NodeObjectCache::copyIn : slab has room");
+
+    std::memcpy(slab.data.get() + slab.used, data, size);
+    slab.hashes.push_back(hash);
+
+    Entry const entry{
+        s.firstSlab + s.slabs.size() - 1,
+        static_cast<std::uint32_t>(slab.used),
+        static_cast<std::uint32_t>(size),
+        type};
+    slab.used += size;
+    return entry;
+}
+
+void
+NodeObjectCache::addSlab(Shard& s)
+{
+    Slab slab;
+    slab.data = s.spare ? std::move(s.spare)
+                        : std::make_unique_for_overwrite<std::uint8_t[]>(
+                              slabSize_);
+
+    if (s.slabs.size() < maxSlabs_)
+    {
+        s.slabs.push_back(std::move(slab));
+        ++slabs_;
+        return;
+    }
+
+    // Recycle the oldest slab. The objects in it that are accessed often
+    // are copied into the new slab, up to three quarters of it so there is
+    // room for new objects; the others are evicted.
+    auto victim = std::move(s.slabs.front());
+    auto const victimSlab = s.firstSlab++;
+    s.slabs.pop_front();
+    s.slabs.push_back(std::move(slab));
+
+    for (auto const& hash : victim.hashes)
+    {
+        auto it = s.entries.find(hash);
+        if (it == s.entries.end() || it->second.slab != victimSlab)
+            continue;
+
+        auto const& entry = it->second;
+
+        if (s.sketch.estimate(hash) >= frequentAccesses &&
+            s.slabs.back().used + entry.size <= slabSize_ / 4 * 3)
+        {
+            it->second = copyIn(
+                s,
+                hash,
+                entry.type,
+                victim.data.get() + entry.offset,
+                entry.size);
+            ++retained_;
+        }
+        else
+        {
+            bytes_ -= entry.size;
+            --entries_;
+            ++evictions_;
+            s.entries.erase(it);
+        }
+    }
+
+    s.spare = std::move(victim.data);
+}
+
+std::size_t
+NodeObjectCache::size() const
+{
+    return bytes_;
+}
+
+Json::Value
+NodeObjectCache::getCountsJson() const
+{
+    Json::Value ret(Json::objectValue);
+
+    auto const hits = hits_.load();
+    auto const misses = misses_.load();
+
+    ret["hits"] = std::to_string(hits);
+    ret["misses"] = std::to_string(misses);
+    ret["hit_ratio"] = (hits + misses) == 0
+        ? 0.0
+        : static_cast<double>(hits) / (hits + misses);
+    ret["bytes"] = std::to_string(bytes_);
+    ret["bytes_allocated"] = std::to_string(slabs_ * slabSize_);
+    ret["bytes_budget"] =
+        std::to_string(shardCount * maxSlabs_ * slabSize_);
+    ret["entries"] = std::to_string(entries_);
+    ret["evictions"] = std::to_string(evictions_);
+    ret["retained"] = std::to_string(retained_);
+    ret["rejected"] = std::to_string(rejections_);
+    return ret;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
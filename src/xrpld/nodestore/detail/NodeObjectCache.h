@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_NODEOBJECTCACHE_H_INCLUDED
+#define RIPPLE_NODESTORE_NODEOBJECTCACHE_H_INCLUDED
+
+#include <xrpld/nodestore/NodeObject.h>
+
+#include <xrpl/basics/hardened_hash.h>
+#include <xrpl/beast/utility/Journal.h>
+#include <xrpl/json/json_value.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A cache of node object blobs with a fixed memory budget.
+
+    The blobs are copied into large slabs rather than kept alive through one
+    shared_ptr each, so the memory used is bounded by the budget and not by
+    the number of objects. Slabs are filled in order and, once the budget is
+    reached, the oldest slab is recycled.
+
+    Which objects are kept is decided by how often they are accessed, as
+    estimated by a TinyLFU frequency sketch. Once the cache is full, an
+    object fetched from the backend is only admitted if it was requested
+    before, and an object in a recycled slab is only kept if it was accessed
+    repeatedly. A scan that touches every object once therefore cannot
+    push the frequently used objects out of the cache.
+
+    @note This can be called concurrently.
+*/
+class NodeObjectCache
+{
+public:
+    /** Create a cache.
+
+        @param budget The maximum number of bytes of slab memory to use.
+        @param journal Destination for logging output.
+    */
+    NodeObjectCache(std::size_t budget, beast::Journal journal);
+
+    NodeObjectCache(NodeObjectCache const&) = delete;
+    NodeObjectCache&
+    operator=(NodeObjectCache const&) = delete;
+
+    /** Return a copy of a cached object, or nullptr if it is not cached.
+
+        Every fetch counts as an access to the object, whether or not it is
+        found.
+    */
+    std::shared_ptr<NodeObject>
+    fetch(uint256 const& hash);
+
+    /** Cache an object that was fetched from the backend.
+
+        Once the cache is full, the object is only cached if it has been
+        accessed before.
+    */
+    void
+    admit(NodeObject const& object);
+
+    /** Cache an object that was just stored. */
+    void
+    insert(NodeObject const& object);
+
+    /** Return the number of bytes of object data currently cached. */
+    std::size_t
+    size() const;
+
+    /** Return the hit ratio, bytes used and eviction counts. */
+    Json::Value
+    getCountsJson() const;
+
+private:
+    // Count-min sketch of the recent access frequency of each hash, with
+    // byte counters saturating at 15 that are halved periodically so that
+    // old accesses are forgotten.
+    class FrequencySketch
+    {
+    public:
+        explicit FrequencySketch(std::size_t width);
+
+        void
+        increment(uint256 const& hash);
+
+        std::uint8_t
+        estimate(uint256 const& hash) const;
+
+    private:
+        static constexpr std::size_t depth = 4;
+        static constexpr std::uint8_t maxCount = 15;
+
+        std::size_t
+        index(uint256 const& hash, std::size_t row) const;
+
+        std::vector<std::uint8_t> counters_;
+        std::size_t const mask_;
+        std::size_t const sampleSize_;
+        std::size_t samples_ = 0;
+    };
+
+    struct Entry
+    {
+        // The sequence number of the slab holding the data
+        std::uint64_t slab;
+        std::uint32_t offset;
+        std::uint32_t size;
+        NodeObjectType type;
+    };
+
+    struct Slab
+    {
+        std::unique_ptr<std::uint8_t[]> data;
+        std::size_t used = 0;
+
+        // The hashes of the objects copied into this slab
+        std::vector<uint256> hashes;
+    };
+
+    // The cache is split by hash into shards with their own lock, budget
+    // and sketch.
+    struct Shard
+    {
+        explicit Shard(std::size_t sketchWidth) : sketch(sketchWidth)
+        {
+        }
+
+        std::mutex mutex;
+        std::unordered_map<uint256, Entry, hardened_hash<>> entries;
+
+        // The slabs, oldest first. The front slab has sequence firstSlab.
+        std::deque<Slab> slabs;
+        std::uint64_t firstSlab = 0;
+
+        // A recycled slab buffer, kept to avoid reallocating it
+        std::unique_ptr<std::uint8_t[]> spare;
+
+        FrequencySketch sketch;
+    };
+
+    static constexpr std::size_t shardCount = 16;
+
+    // Objects accessed at least this often are admitted to a full cache
+    // and survive the recycling of their slab.
+    static constexpr std::uint8_t frequentAccesses = 2;
+
+    Shard&
+    shard(uint256 const& hash);
+
+    void
+    insert(Shard& shard, NodeObject const& object, bool force);
+
+    // Copy an object into the newest slab, which must have room for it,
+    // and return where it is
+    Entry
+    copyIn(
+        Shard& shard,
+        uint256 const& hash,
+        NodeObjectType type,
+        std::uint8_t const* data,
+        std::size_t size);
+
+    // Start a new slab, recycling the oldest one if the shard is full
+    void
+    addSlab(Shard& shard);
+
+    beast::Journal const j_;
+    std::size_t const slabSize_;
+    std::size_t const maxSlabs_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> entries_{0};
+    std::atomic<std::uint64_t> slabs_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+    std::atomic<std::uint64_t> retained_{0};
+    std::atomic<std::uint64_t> rejections_{0};
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
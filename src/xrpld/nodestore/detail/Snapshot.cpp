@@ -0,0 +1,415 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/nodestore/Snapshot.h>
+
+#include <xrpl/basics/contract.h>
+#include <xrpl/beast/utility/instrumentation.h>
+#include <xrpl/protocol/HashPrefix.h>
+#include <xrpl/protocol/digest.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+constexpr char fileMagic[8] = {'X', 'R', 'P', 'L', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t fileVersion = 1;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t ledgerSeq;
+    std::uint8_t ledgerHash[32];
+    std::uint64_t count;
+    std::uint64_t indexOffset;
+};
+static_assert(sizeof(Header) == 64);
+
+// The index follows the objects. It begins with a table that gives, for
+// each value of the first two bytes of a hash, the number of entries with
+// a lower value, so that a search starts from a few entries.
+constexpr std::size_t fanoutSize = 65537;
+
+struct IndexEntry
+{
+    std::uint8_t hash[32];
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::uint32_t type;
+};
+static_assert(sizeof(IndexEntry) == 48);
+
+// An inner node, as stored: a prefix and the hash of each of 16 children
+constexpr std::size_t innerNodeSize = 4 + 16 * uint256::bytes;
+
+std::size_t
+fanoutSlot(std::uint8_t const* hash)
+{
+    return (std::size_t{hash[0]} << 8) | hash[1];
+}
+
+bool
+isInnerNode(Slice data)
+{
+    if (data.size() != innerNodeSize)
+        return false;
+
+    auto const prefix = (std::uint32_t{data[0]} << 24) |
+        (std::uint32_t{data[1]} << 16) | (std::uint32_t{data[2]} << 8) |
+        std::uint32_t{data[3]};
+    return prefix == static_cast<std::uint32_t>(HashPrefix::innerNode);
+}
+
+}  // namespace
+
+struct Snapshot::Impl
+{
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+
+    std::uint8_t const* base = nullptr;
+    Header header;
+    uint256 ledgerHash;
+
+    // Set once verify() has checked every object
+    std::atomic<bool> verified{false};
+    std::uint8_t const* index = nullptr;
+
+    // The mapping is only byte aligned as far as the compiler knows, so
+    // fields are copied out rather than read in place.
+    std::uint64_t
+    fanout(std::size_t slot) const
+    {
+        std::uint64_t n;
+        std::memcpy(
+            &n, base + header.indexOffset + slot * sizeof(n), sizeof(n));
+        return n;
+    }
+
+    IndexEntry
+    entry(std::size_t i) const
+    {
+        IndexEntry e;
+        std::memcpy(&e, index + i * sizeof(IndexEntry), sizeof(e));
+        return e;
+    }
+
+    std::optional<std::size_t>
+    find(uint256 const& hash) const
+    {
+        auto const slot = fanoutSlot(hash.data());
+        std::size_t lo = fanout(slot);
+        std::size_t hi = fanout(slot + 1);
+        if (lo > hi || hi > header.count)
+            return std::nullopt;
+
+        while (lo < hi)
+        {
+            auto const mid = lo + (hi - lo) / 2;
+            auto const c = std::memcmp(
+                index + mid * sizeof(IndexEntry), hash.data(), hash.size());
+            if (c == 0)
+                return mid;
+            if (c < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return std::nullopt;
+    }
+
+    // The data of an entry, or nothing if the entry points outside of the
+    // objects
+    std::optional<Slice>
+    data(IndexEntry const& e) const
+    {
+        if (e.offset < sizeof(Header) || e.offset > header.indexOffset ||
+            e.size > header.indexOffset - e.offset)
+            return std::nullopt;
+        return Slice(base + e.offset, e.size);
+    }
+};
+
+Snapshot::Snapshot(std::string const& path) : impl_(std::make_unique<Impl>())
+{
+    using namespace boost::interprocess;
+
+    try
+    {
+        impl_->file = file_mapping(path.c_str(), read_only);
+        impl_->region = mapped_region(impl_->file, read_only);
+    }
+    catch (interprocess_exception const& e)
+    {
+        Throw<std::runtime_error>(
+            "snapshot: unable to map " + path + ": " + e.what());
+    }
+
+    // Objects are fetched in no particular order, so read ahead is wasted
+    impl_->region.advise(mapped_region::advice_random);
+
+    auto const size = impl_->region.get_size();
+    impl_->base = static_cast<std::uint8_t const*>(impl_->region.get_address());
+
+    auto& header = impl_->header;
+    if (size < sizeof(Header))
+        Throw<std::runtime_error>("snapshot: " + path + " is too short");
+    std::memcpy(&header, impl_->base, sizeof(Header));
+
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        header.version != fileVersion)
+        Throw<std::runtime_error>("snapshot: " + path + " is not a snapshot");
+
+    auto const indexSize = fanoutSize * sizeof(std::uint64_t);
+    if (header.indexOffset < sizeof(Header) || header.indexOffset % 8 != 0 ||
+        header.indexOffset > size || size - header.indexOffset < indexSize ||
+        (size - header.indexOffset - indexSize) / sizeof(IndexEntry) !=
+            header.count ||
+        (size - header.indexOffset - indexSize) % sizeof(IndexEntry) != 0)
+        Throw<std::runtime_error>("snapshot: " + path + " is incomplete");
+
+    impl_->index = impl_->base + header.indexOffset + indexSize;
+    impl_->ledgerHash = uint256::fromVoid(header.ledgerHash);
+
+    if (impl_->fanout(0) != 0 || impl_->fanout(fanoutSize - 1) != header.count)
+        Throw<std::runtime_error>("snapshot: " + path + " is incomplete");
+}
+
+Snapshot::~Snapshot() = default;
+
+std::uint32_t
+Snapshot::ledgerSeq() const
+{
+    return impl_->header.ledgerSeq;
+}
+
+uint256 const&
+Snapshot::ledgerHash() const
+{
+    return impl_->ledgerHash;
+}
+
+std::size_t
+Snapshot::size() const
+{
+    return impl_->header.count;
+}
+
+std::shared_ptr<NodeObject>
+Snapshot::fetch(uint256 const& hash) const
+{
+    auto const i = impl_->find(hash);
+    if (!i)
+        return {};
+
+    auto const e = impl_->entry(*i);
+    auto const data = impl_->data(e);
+    if (!data)
+        return {};
+
+    if (!impl_->verified.load(std::memory_order_acquire))
+    {
+        sha512_half_hasher h;
+        h(data->data(), data->size());
+        if (static_cast<uint256>(h) != hash)
+            return {};
+    }
+
+    return NodeObject::createObject(
+        static_cast<NodeObjectType>(e.type),
+        Blob(data->begin(), data->end()),
+        hash);
+}
+
+bool
+Snapshot::verify(
+    std::vector<uint256> const& roots,
+    std::function<bool()> const& stopping) const
+{
+    for (auto const& root : roots)
+    {
+        if (!impl_->find(root))
+            return false;
+    }
+
+    for (std::size_t i = 0; i != impl_->header.count; ++i)
+    {
+        if (i % 4096 == 0 && stopping && stopping())
+            return false;
+
+        auto const e = impl_->entry(i);
+
+        // Sorted, so that every object can be found
+        auto const slot = fanoutSlot(e.hash);
+        if (i < impl_->fanout(slot) || i >= impl_->fanout(slot + 1))
+            return false;
+        if (i != 0 &&
+            std::memcmp(
+                impl_->index + (i - 1) * sizeof(IndexEntry),
+                e.hash,
+                sizeof(e.hash)) >= 0)
+            return false;
+
+        // Intact
+        auto const data = impl_->data(e);
+        if (!data)
+            return false;
+
+        sha512_half_hasher h;
+        h(data->data(), data->size());
+        if (static_cast<uint256>(h) != uint256::fromVoid(e.hash))
+            return false;
+
+        // Complete
+        if (isInnerNode(*data))
+        {
+            for (int branch = 0; branch != 16; ++branch)
+            {
+                auto const child = uint256::fromVoid(
+                    data->data() + 4 + branch * uint256::bytes);
+                if (child.isNonZero() && !impl_->find(child))
+                    return false;
+            }
+        }
+    }
+
+    impl_->verified.store(true, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+SnapshotWriter::SnapshotWriter(
+    std::string const& path,
+    std::uint32_t ledgerSeq,
+    uint256 const& ledgerHash)
+    : path_(path)
+    , tempPath_(path + ".tmp")
+    , ledgerSeq_(ledgerSeq)
+    , ledgerHash_(ledgerHash)
+    , file_(tempPath_, std::ios::binary | std::ios::trunc)
+    , offset_(sizeof(Header))
+{
+    if (!file_)
+        Throw<std::runtime_error>("snapshot: unable to create " + tempPath_);
+
+    // The header is written last, once the file is complete
+    char const zeros[sizeof(Header)] = {};
+    file_.write(zeros, sizeof(zeros));
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    if (!finished_)
+    {
+        file_.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tempPath_, ec);
+    }
+}
+
+void
+SnapshotWriter::add(NodeObjectType type, uint256 const& hash, Slice data)
+{
+    XRPL_ASSERT(
+        !finished_, "ripple::NodeStore::SnapshotWriter::add : not finished");
+    XRPL_ASSERT(
+        data.size() <= std::numeric_limits<std::uint32_t>::max(),
+        "ripple::NodeStore::SnapshotWriter::add : valid size");
+
+    file_.write(reinterpret_cast<char const*>(data.data()), data.size());
+    entries_.push_back(
+        {hash, offset_, static_cast<std::uint32_t>(data.size()), type});
+    offset_ += data.size();
+}
+
+void
+SnapshotWriter::finish()
+{
+    std::sort(
+        entries_.begin(), entries_.end(), [](Entry const& a, Entry const& b) {
+            return a.hash < b.hash;
+        });
+    entries_.erase(
+        std::unique(
+            entries_.begin(),
+            entries_.end(),
+            [](Entry const& a, Entry const& b) { return a.hash == b.hash; }),
+        entries_.end());
+
+    char const zeros[8] = {};
+    file_.write(zeros, (8 - offset_ % 8) % 8);
+    auto const indexOffset = offset_ + (8 - offset_ % 8) % 8;
+
+    std::vector<std::uint64_t> fanout(fanoutSize, 0);
+    for (auto const& e : entries_)
+        ++fanout[fanoutSlot(e.hash.data()) + 1];
+    std::partial_sum(fanout.begin(), fanout.end(), fanout.begin());
+    file_.write(
+        reinterpret_cast<char const*>(fanout.data()),
+        fanout.size() * sizeof(std::uint64_t));
+
+    for (auto const& e : entries_)
+    {
+        IndexEntry ie;
+        std::memcpy(ie.hash, e.hash.data(), sizeof(ie.hash));
+        ie.offset = e.offset;
+        ie.size = e.size;
+        ie.type = e.type;
+        file_.write(reinterpret_cast<char const*>(&ie), sizeof(ie));
+    }
+
+    Header header;
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.ledgerSeq = ledgerSeq_;
+    std::memcpy(header.ledgerHash, ledgerHash_.data(), ledgerHash_.size());
+    header.count = entries_.size();
+    header.indexOffset = indexOffset;
+    file_.seekp(0);
+    file_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    file_.close();
+    if (!file_)
+        Throw<std::runtime_error>("snapshot: unable to write " + tempPath_);
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tempPath_, path_, ec);
+    if (ec)
+        Throw<std::runtime_error>(
+            "snapshot: unable to rename " + tempPath_ + ": " + ec.message());
+
+    finished_ = true;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,230 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/nodestore/detail/ZstdDictionary.h>
+
+#include <xrpl/basics/contract.h>
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+struct CCtxDeleter
+{
+    void
+    operator()(ZSTD_CCtx* p) const
+    {
+        ZSTD_freeCCtx(p);
+    }
+};
+
+struct DCtxDeleter
+{
+    void
+    operator()(ZSTD_DCtx* p) const
+    {
+        ZSTD_freeDCtx(p);
+    }
+};
+
+// Contexts hold the working memory of a compression or decompression and
+// can not be shared between threads, so each thread keeps its own.
+ZSTD_CCtx*
+compressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> const ctx(
+        ZSTD_createCCtx());
+    if (!ctx)
+        Throw<std::bad_alloc>();
+    return ctx.get();
+}
+
+ZSTD_DCtx*
+decompressionContext()
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> const ctx(
+        ZSTD_createDCtx());
+    if (!ctx)
+        Throw<std::bad_alloc>();
+    return ctx.get();
+}
+
+std::uint32_t
+dictionaryId(Blob const& dictionary)
+{
+    auto const id =
+        ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    if (id == 0)
+        Throw<std::runtime_error>("zstd: not a trained dictionary");
+    return id;
+}
+
+}  // namespace
+
+struct ZstdDictionary::Impl
+{
+    struct CDictDeleter
+    {
+        void
+        operator()(ZSTD_CDict* p) const
+        {
+            ZSTD_freeCDict(p);
+        }
+    };
+
+    struct DDictDeleter
+    {
+        void
+        operator()(ZSTD_DDict* p) const
+        {
+            ZSTD_freeDDict(p);
+        }
+    };
+
+    std::unique_ptr<ZSTD_CDict, CDictDeleter> cdict;
+    std::unique_ptr<ZSTD_DDict, DDictDeleter> ddict;
+};
+
+ZstdDictionary::ZstdDictionary(Blob dictionary, int level)
+    : dictionary_(std::move(dictionary))
+    , id_(dictionaryId(dictionary_))
+    , impl_(std::make_unique<Impl>())
+{
+    impl_->cdict.reset(
+        ZSTD_createCDict(dictionary_.data(), dictionary_.size(), level));
+    impl_->ddict.reset(
+        ZSTD_createDDict(dictionary_.data(), dictionary_.size()));
+    if (!impl_->cdict || !impl_->ddict)
+        Throw<std::runtime_error>("zstd: invalid dictionary");
+}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+std::unique_ptr<ZstdDictionary>
+ZstdDictionary::load(std::string const& path, int level)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        Throw<std::runtime_error>("zstd: unable to open dictionary " + path);
+
+    Blob dictionary(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    if (file.bad())
+        Throw<std::runtime_error>("zstd: unable to read dictionary " + path);
+
+    return std::make_unique<ZstdDictionary>(std::move(dictionary), level);
+}
+
+Blob
+ZstdDictionary::train(std::vector<Blob> const& samples, std::size_t maxSize)
+{
+    // The trainer wants the samples back to back with a list of sizes
+    Blob buffer;
+    std::vector<std::size_t> sizes;
+    sizes.reserve(samples.size());
+    for (auto const& sample : samples)
+    {
+        buffer.insert(buffer.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    Blob dictionary(maxSize);
+    auto const size = ZDICT_trainFromBuffer(
+        dictionary.data(),
+        dictionary.size(),
+        buffer.data(),
+        sizes.data(),
+        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size))
+        Throw<std::runtime_error>(
+            std::string("zstd: dictionary training failed: ") +
+            ZDICT_getErrorName(size));
+
+    dictionary.resize(size);
+    return dictionary;
+}
+
+std::uint32_t
+ZstdDictionary::id() const
+{
+    return id_;
+}
+
+std::size_t
+ZstdDictionary::compressBound(std::size_t size)
+{
+    return ZSTD_compressBound(size);
+}
+
+std::size_t
+ZstdDictionary::compress(
+    void const* in,
+    std::size_t inSize,
+    void* out,
+    std::size_t outSize) const
+{
+    auto const size = ZSTD_compress_usingCDict(
+        compressionContext(), out, outSize, in, inSize, impl_->cdict.get());
+    if (ZSTD_isError(size))
+        Throw<std::runtime_error>(
+            std::string("zstd compress: ") + ZSTD_getErrorName(size));
+    return size;
+}
+
+std::size_t
+ZstdDictionary::decompressedSize(void const* in, std::size_t inSize) const
+{
+    if (ZSTD_getDictID_fromFrame(in, inSize) != id_)
+        Throw<std::runtime_error>(
+            "zstd decompress: blob was compressed with dictionary " +
+            std::to_string(ZSTD_getDictID_fromFrame(in, inSize)) +
+            ", not " + std::to_string(id_));
+
+    auto const size = ZSTD_getFrameContentSize(in, inSize);
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR)
+        Throw<std::runtime_error>("zstd decompress: invalid blob");
+    return static_cast<std::size_t>(size);
+}
+
+void
+ZstdDictionary::decompress(
+    void const* in,
+    std::size_t inSize,
+    void* out,
+    std::size_t outSize) const
+{
+    auto const size = ZSTD_decompress_usingDDict(
+        decompressionContext(), out, outSize, in, inSize, impl_->ddict.get());
+    if (ZSTD_isError(size))
+        Throw<std::runtime_error>(
+            std::string("zstd decompress: ") + ZSTD_getErrorName(size));
+    if (size != outSize)
+        Throw<std::runtime_error>("zstd decompress: short blob");
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
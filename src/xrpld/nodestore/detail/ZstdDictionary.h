@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2025 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_ZSTDDICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_ZSTDDICTIONARY_H_INCLUDED
+
+#include <xrpl/basics/Blob.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A zstd dictionary used to compress small node objects.
+
+    Account state leaves are small and share most of their structure, so
+    there is little for a compressor to find within a single one. A
+    dictionary trained on a sample of a node's own objects provides that
+    shared structure up front.
+
+    Every compressed frame records the id of the dictionary it was
+    compressed with, so a blob is never decoded with the wrong dictionary.
+
+    @note This can be called concurrently.
+*/
+class ZstdDictionary
+{
+public:
+    /** Prepare a dictionary for use.
+
+        @param dictionary The dictionary, as produced by train().
+        @param level The zstd compression level.
+
+        @throws std::runtime_error If the dictionary is not valid.
+    */
+    ZstdDictionary(Blob dictionary, int level);
+
+    ~ZstdDictionary();
+
+    ZstdDictionary(ZstdDictionary const&) = delete;
+    ZstdDictionary&
+    operator=(ZstdDictionary const&) = delete;
+
+    /** Load a dictionary from a file.
+
+        @throws std::runtime_error If the file can not be read or does not
+                hold a valid dictionary.
+    */
+    static std::unique_ptr<ZstdDictionary>
+    load(std::string const& path, int level);
+
+    /** Train a dictionary on a sample of serialized objects.
+
+        @param samples The objects to train on. A few thousand are enough.
+        @param maxSize The maximum size of the dictionary in bytes.
+
+        @throws std::runtime_error If training fails, for example because
+                there are too few samples.
+    */
+    static Blob
+    train(std::vector<Blob> const& samples, std::size_t maxSize);
+
+    /** The id recorded in every frame compressed with this dictionary. */
+    std::uint32_t
+    id() const;
+
+    /** The largest compressed size of an input of the given size. */
+    static std::size_t
+    compressBound(std::size_t size);
+
+    /** Compress into a buffer of at least compressBound(inSize) bytes.
+
+        @return The compressed size.
+    */
+    std::size_t
+    compress(void const* in, std::size_t inSize, void* out, std::size_t outSize)
+        const;
+
+    /** The size of the data in a compressed frame.
+
+        @throws std::runtime_error If the frame was not compressed with
+                this dictionary or does not record its size.
+    */
+    std::size_t
+    decompressedSize(void const* in, std::size_t inSize) const;
+
+    /** Decompress a frame into a buffer of decompressedSize() bytes.
+
+        @throws std::runtime_error If the frame is corrupt.
+    */
+    void
+    decompress(
+        void const* in,
+        std::size_t inSize,
+        void* out,
+        std::size_t outSize) const;
+
+private:
+    struct Impl;
+
+    Blob const dictionary_;
+    std::uint32_t const id_;
+    std::unique_ptr<Impl> const impl_;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
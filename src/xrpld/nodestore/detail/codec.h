@@ -24,6 +24,7 @@
 #define LZ4_DISABLE_DEPRECATE_WARNINGS
 
 #include <xrpld/nodestore/NodeObject.h>
+#include <xrpld/nodestore/detail/ZstdDictionary.h>
 #include <xrpld/nodestore/detail/varint.h>
 
 #include <xrpl/basics/contract.h>
@@ -95,6 +96,34 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     return result;
 }
 
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+zstd_decompress(
+    void const* in,
+    std::size_t in_size,
+    ZstdDictionary const& dictionary,
+    BufferFactory&& bf)
+{
+    auto const outSize = dictionary.decompressedSize(in, in_size);
+    void* const out = bf(outSize);
+    dictionary.decompress(in, in_size, out, outSize);
+    return {out, outSize};
+}
+
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+zstd_compress(
+    void const* in,
+    std::size_t in_size,
+    ZstdDictionary const& dictionary,
+    BufferFactory&& bf)
+{
+    // The frame records the size of the data and the dictionary id
+    auto const out_max = ZstdDictionary::compressBound(in_size);
+    void* const out = bf(out_max);
+    return {out, dictionary.compress(in, in_size, out, out_max)};
+}
+
 //------------------------------------------------------------------------------
 
 /*
@@ -104,11 +133,16 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = zstd compressed with a dictionary
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    ZstdDictionary const* dictionary = nullptr)
 {
     using namespace nudb::detail;
 
@@ -202,6 +236,15 @@ nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
             write(os, is(512), 512);
             break;
         }
+        case 4:  // zstd
+        {
+            if (!dictionary)
+                Throw<std::runtime_error>(
+                    "nodeobject codec: zstd blob, but no dictionary is "
+                    "configured");
+            result = zstd_decompress(p, in_size, *dictionary, bf);
+            break;
+        }
         default:
             Throw<std::runtime_error>(
                 "nodeobject codec: bad type=" + std::to_string(type));
@@ -217,9 +260,15 @@ zero32()
     return v.data();
 }
 
+// Inner nodes always use their own encoding. Other objects are compressed
+// with zstd if a dictionary is given, and with lz4 otherwise.
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    ZstdDictionary const* dictionary = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -283,7 +332,7 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
     std::array<std::uint8_t, varint_traits<std::size_t>::max> vi;
 
-    constexpr std::size_t codecType = 1;
+    std::size_t const codecType = dictionary ? 4 : 1;
     auto const vn = write_varint(vi.data(), codecType);
     std::pair<void const*, std::size_t> result;
     switch (codecType)
@@ -302,6 +351,19 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
             result.second = vn + lzr.second;
             break;
         }
+        case 4:  // zstd
+        {
+            std::uint8_t* p;
+            auto const zr = NodeStore::zstd_compress(
+                in, in_size, *dictionary, [&p, &vn, &bf](std::size_t n) {
+                    p = reinterpret_cast<std::uint8_t*>(bf(vn + n));
+                    return p + vn;
+                });
+            std::memcpy(p, vi.data(), vn);
+            result.first = p;
+            result.second = vn + zr.second;
+            break;
+        }
         default:
             Throw<std::logic_error>(
                 "nodeobject codec: unknown=" + std::to_string(codecType));
@@ -119,6 +119,7 @@ private:
     std::atomic<Peer::id_t> next_id_;
     int timer_count_;
     std::atomic<uint64_t> jqTransOverflow_{0};
+    std::atomic<int> batchedTransactions_{0};
     std::atomic<uint64_t> peerDisconnects_{0};
     std::atomic<uint64_t> peerDisconnectsCharges_{0};
 
@@ -362,6 +363,23 @@ public:
         return jqTransOverflow_;
     }
 
+    /** Count transactions of TMTransactions messages queued to be checked.
+
+        Each message is checked by a single job, so the job count alone
+        understates how many transactions are waiting.
+    */
+    void
+    addBatchedTransactions(int count)
+    {
+        batchedTransactions_ += count;
+    }
+
+    int
+    getBatchedTransactions() const
+    {
+        return batchedTransactions_;
+    }
+
     void
     incPeerDisconnect() override
     {
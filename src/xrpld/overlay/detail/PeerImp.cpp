@@ -1260,7 +1260,8 @@ void
 PeerImp::handleTransaction(
     std::shared_ptr<protocol::TMTransaction> const& m,
     bool eraseTxQueue,
-    bool batch)
+    bool batch,
+    std::vector<BatchedTransaction>* batched)
 {
     XRPL_ASSERT(
         eraseTxQueue != batch,
@@ -1348,12 +1349,18 @@ PeerImp::handleTransaction(
                 << "No new transactions until synchronized";
         }
         else if (
-            app_.getJobQueue().getJobCount(jtTRANSACTION) >
+            app_.getJobQueue().getJobCount(jtTRANSACTION) +
+                overlay_.getBatchedTransactions() +
+                (batched ? static_cast<int>(batched->size()) : 0) >
             app_.config().MAX_TRANSACTIONS)
         {
             overlay_.incJqTransOverflow();
             JLOG(p_journal_.info()) << "Transaction queue is full";
         }
+        else if (batched)
+        {
+            batched->push_back({flags, checkSignature, stx});
+        }
         else
         {
             app_.getJobQueue().addJob(
@@ -2680,12 +2687,33 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransactions> const& m)
 
     overlay_.addTxMetrics(m->transactions_size());
 
+    std::vector<BatchedTransaction> batched;
     for (std::uint32_t i = 0; i < m->transactions_size(); ++i)
         handleTransaction(
             std::shared_ptr<protocol::TMTransaction>(
                 m->mutable_transactions(i), [](protocol::TMTransaction*) {}),
             false,
-            true);
+            true,
+            &batched);
+
+    if (!batched.empty())
+    {
+        // The transactions count against MAX_TRANSACTIONS until checked
+        auto const count = static_cast<int>(batched.size());
+        overlay_.addBatchedTransactions(count);
+        if (!app_.getJobQueue().addJob(
+                jtTRANSACTION,
+                "recvTransactions->checkTransactions",
+                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                 &overlay = overlay_,
+                 count,
+                 batched = std::move(batched)]() {
+                    if (auto peer = weak.lock())
+                        peer->checkTransactions(batched);
+                    overlay.addBatchedTransactions(-count);
+                }))
+            overlay_.addBatchedTransactions(-count);
+    }
 }
 
 void
@@ -2968,6 +2996,39 @@ PeerImp::checkTransaction(
     }
 }
 
+void
+PeerImp::checkTransactions(std::vector<BatchedTransaction> const& batched)
+{
+    // Checks of the signatures which checkTransaction would skip are not
+    // worth making
+    std::vector<std::shared_ptr<STTx const>> txs;
+    txs.reserve(batched.size());
+    for (auto const& tx : batched)
+    {
+        if (tx.checkSignature && !tx.stx->isFlag(tfInnerBatchTxn) &&
+            !isPseudoTx(*tx.stx))
+            txs.push_back(tx.stx);
+    }
+
+    try
+    {
+        checkValidity(
+            app_.getHashRouter(),
+            txs,
+            app_.getLedgerMaster().getValidatedRules(),
+            app_.config(),
+            app_.getJobQueue());
+    }
+    catch (std::exception const& ex)
+    {
+        JLOG(p_journal_.warn())
+            << "Exception in " << __func__ << ": " << ex.what();
+    }
+
+    for (auto const& tx : batched)
+        checkTransaction(tx.flags, tx.checkSignature, tx.stx, true);
+}
+
 // Called from our JobQueue
 void
 PeerImp::checkPropose(
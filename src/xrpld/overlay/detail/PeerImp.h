@@ -164,6 +164,15 @@ private:
         }
     };
 
+    // A transaction of a TMTransactions message, checked along with the
+    // others of the message
+    struct BatchedTransaction
+    {
+        int flags;
+        bool checkSignature;
+        std::shared_ptr<STTx const> stx;
+    };
+
     std::mutex mutable recentLock_;
     protocol::TMStatusChange last_status_;
     Resource::Consumer usage_;
@@ -502,12 +511,15 @@ private:
        @param batch is false when called from onMessage(TMTransaction)
        and is true when called from onMessage(TMTransactions). If true, then the
        transaction is part of a batch, and should not be charged an extra fee.
+       @param batched if set, the transaction is added to it to be checked
+       along with the others of the batch, rather than by a job of its own.
      */
     void
     handleTransaction(
         std::shared_ptr<protocol::TMTransaction> const& m,
         bool eraseTxQueue,
-        bool batch);
+        bool batch,
+        std::vector<BatchedTransaction>* batched = nullptr);
 
     /** Handle protocol message with hashes of transactions that have not
        been relayed by an upstream node down to its peers - request
@@ -617,6 +629,11 @@ private:
         std::shared_ptr<STTx const> const& stx,
         bool batch);
 
+    // Checks the transactions of a batch, after checking their signatures
+    // on many threads.
+    void
+    checkTransactions(std::vector<BatchedTransaction> const& batched);
+
     void
     checkPropose(
         bool isTrusted,
@@ -23,6 +23,7 @@
 #include <xrpld/app/main/Application.h>
 #include <xrpld/app/misc/NetworkOPs.h>
 #include <xrpld/app/rdb/backend/SQLiteDatabase.h>
+#include <xrpld/core/JobQueue.h>
 #include <xrpld/nodestore/Database.h>
 #include <xrpld/rpc/Context.h>
 
@@ -127,6 +128,7 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::uptime] = uptime;
 
     app.getNodeStore().getCountsJson(ret);
+    app.getJobQueue().getCountsJson(ret);
 
     return ret;
 }
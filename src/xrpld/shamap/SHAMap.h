@@ -41,6 +41,7 @@
 
 namespace ripple {
 
+class JobQueue;
 class SHAMapNodeID;
 class SHAMapSyncFilter;
 
@@ -246,6 +247,33 @@ public:
     void
     visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const;
 
+    /**  Visit a node of this SHAMap and every node below it
+
+         @param node the node to start at, such as one returned by
+                splitNodes.
+         @param function called with every node visited.
+         If function returns false, visitNodes exits.
+    */
+    void
+    visitNodes(
+        intr_ptr::SharedPtr<SHAMapTreeNode> const& node,
+        std::function<bool(SHAMapTreeNode&)> const& function) const;
+
+    /**  Split this SHAMap into subtrees that can be walked in parallel
+
+         Visits every node above the given depth, and returns the nodes at
+         that depth. Visiting each of them with visitNodes visits the rest
+         of the map, so every node is visited exactly once.
+
+         @param depth the depth of the subtrees, where the root is at 0.
+         @param function called with every node above that depth.
+         If function returns false, splitNodes returns no subtrees.
+    */
+    std::vector<intr_ptr::SharedPtr<SHAMapTreeNode>>
+    splitNodes(
+        int depth,
+        std::function<bool(SHAMapTreeNode&)> const& function) const;
+
     /**  Visit every node in this SHAMap that
          is not present in the specified SHAMap
 
@@ -276,10 +304,14 @@ public:
 
         @param maxNodes The maximum number of found nodes to return
         @param filter The filter to use when retrieving nodes
+        @param priority The priority of the reads from the node store
         @param return The nodes known to be missing
     */
     std::vector<std::pair<SHAMapNodeID, uint256>>
-    getMissingNodes(int maxNodes, SHAMapSyncFilter* filter);
+    getMissingNodes(
+        int maxNodes,
+        SHAMapSyncFilter* filter,
+        NodeStore::FetchPriority priority = NodeStore::FetchPriority::catchup);
 
     bool
     getNodeFat(
@@ -346,10 +378,29 @@ public:
     int
     unshare();
 
-    /** Flush modified nodes to the nodestore and convert them to shared. */
+    /** Flush modified nodes to the nodestore and convert them to shared.
+
+        @param t The type of node object to write.
+        @return The number of nodes flushed.
+    */
     int
     flushDirty(NodeObjectType t);
 
+    /** Flush modified nodes, sharing the subtrees below the root out to
+        jobs.
+
+        @param t The type of node object to write.
+        @param jobQueue The queue whose threads help to flush.
+        @param threads The most threads, the caller's included, flushing
+                       at once. The subtrees are independent, so the
+                       resulting hashes and the set of stored objects are
+                       the same regardless of the value. A value of 1
+                       flushes serially on the calling thread.
+        @return The number of nodes flushed.
+    */
+    int
+    flushDirty(NodeObjectType t, JobQueue& jobQueue, unsigned int threads);
+
     void
     walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
     bool
@@ -470,6 +521,7 @@ private:
         SHAMapInnerNode* parent,
         int branch,
         SHAMapSyncFilter* filter,
+        NodeStore::FetchPriority priority,
         bool& pending,
         descendCallback&&) const;
 
@@ -506,7 +558,44 @@ private:
         Delta& differences,
         int& maxCount) const;
     int
-    walkSubTree(bool doWrite, NodeObjectType t);
+    walkSubTree(
+        bool doWrite,
+        NodeObjectType t,
+        JobQueue* jobQueue = nullptr,
+        unsigned int threads = 1);
+
+    /** Flush the modified subtree rooted at an inner node.
+
+        The modified nodes are flushed one level at a time, deepest first,
+        so that every inner node's hash covers the final hashes of its
+        children. The nodes on a level are hashed as one batch.
+
+        @param node The inner node, which must already be unshared.
+        @param flushed Incremented by the number of nodes flushed.
+        @return The flushed, shareable node.
+    */
+    intr_ptr::SharedPtr<SHAMapInnerNode>
+    flushInnerNode(
+        intr_ptr::SharedPtr<SHAMapInnerNode> node,
+        bool doWrite,
+        NodeObjectType t,
+        int& flushed) const;
+
+    /** Flush the modified children of an inner node on several threads.
+
+        Each modified child heads an independent subtree; the subtrees are
+        split into at most `threads` slices, which the calling thread and
+        jobs flush, before the flushed children are hooked back into
+        `node`. The node itself is left for the caller to flush.
+    */
+    void
+    flushChildrenParallel(
+        SHAMapInnerNode& node,
+        bool doWrite,
+        NodeObjectType t,
+        JobQueue& jobQueue,
+        unsigned int threads,
+        int& flushed) const;
 
     // Structure to track information about call to
     // getMissingNodes while it's in progress
@@ -520,7 +609,8 @@ private:
         // basic parameters
         int max_;
         SHAMapSyncFilter* filter_;
-        int const maxDefer_;
+        NodeStore::FetchPriority const priority_;
+        int const maxDefer_;  // the most reads to keep in flight
         std::uint32_t generation_;
 
         // nodes we have discovered to be missing
@@ -547,9 +637,10 @@ private:
             SHAMapInnerNode*,                      // parent node
             SHAMapNodeID,                          // parent node ID
             int,                                   // branch
-            intr_ptr::SharedPtr<SHAMapTreeNode>>;  // node
+            intr_ptr::SharedPtr<SHAMapTreeNode>,   // node
+            bool>;                                 // whether it was prefetched
 
-        int deferred_;
+        int deferred_;  // reads issued and not yet processed
         std::mutex deferLock_;
         std::condition_variable deferCondVar_;
         std::vector<DeferredNode> finishedReads_;
@@ -561,10 +652,12 @@ private:
         MissingNodes(
             int max,
             SHAMapSyncFilter* filter,
+            NodeStore::FetchPriority priority,
             int maxDefer,
             std::uint32_t generation)
             : max_(max)
             , filter_(filter)
+            , priority_(priority)
             , maxDefer_(maxDefer)
             , generation_(generation)
             , deferred_(0)
@@ -577,8 +670,30 @@ private:
     // getMissingNodes helper functions
     void
     gmn_ProcessNodes(MissingNodes&, MissingNodes::StackEntry& node);
+
+    // Process finished reads until no more than maxPending are in flight
     void
-    gmn_ProcessDeferredReads(MissingNodes&);
+    gmn_ProcessDeferredReads(MissingNodes&, int maxPending);
+
+    // Read the children of an inner node that just arrived, before the
+    // walk gets to it
+    void
+    gmn_Prefetch(
+        MissingNodes&,
+        SHAMapInnerNode* node,
+        SHAMapNodeID const& nodeID,
+        int pending);
+
+    // Descend to a child, queueing a read that completes into mn if it is
+    // not in memory
+    SHAMapTreeNode*
+    gmn_Descend(
+        MissingNodes& mn,
+        SHAMapInnerNode* node,
+        SHAMapNodeID const& nodeID,
+        int branch,
+        bool prefetch,
+        bool& pending);
 
     // fetch from DB helper function
     intr_ptr::SharedPtr<SHAMapTreeNode>
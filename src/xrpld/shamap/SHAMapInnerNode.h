@@ -173,6 +173,10 @@ public:
     void
     updateHashDeep();
 
+    /** Refresh the stored hashes of all children, but not of this node. */
+    void
+    updateChildHashes();
+
     void
     serializeForWire(Serializer&) const override;
 
@@ -29,6 +29,7 @@
 #include <xrpl/protocol/Serializer.h>
 
 #include <cstdint>
+#include <span>
 #include <string>
 
 namespace ripple {
@@ -140,6 +141,16 @@ public:
     virtual void
     updateHash() = 0;
 
+    /** Recalculate the hashes of several nodes at once.
+
+        This produces the same hashes as calling updateHash on each node,
+        but hashes the nodes as a batch so that several of them can be
+        processed in parallel by the SHA-512 engine. The children of inner
+        nodes must already have their hashes updated.
+    */
+    static void
+    updateHashes(std::span<SHAMapTreeNode* const> nodes);
+
     /** Return the hash of this node. */
     SHAMapHash const&
     getHash() const
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <xrpld/core/JobQueue.h>
 #include <xrpld/shamap/SHAMap.h>
 #include <xrpld/shamap/SHAMapAccountStateLeafNode.h>
 #include <xrpld/shamap/SHAMapNodeID.h>
@@ -27,6 +28,8 @@
 #include <xrpl/basics/TaggedCache.ipp>
 #include <xrpl/basics/contract.h>
 
+#include <array>
+
 namespace ripple {
 
 [[nodiscard]] intr_ptr::SharedPtr<SHAMapLeafNode>
@@ -395,6 +398,7 @@ SHAMap::descendAsync(
     SHAMapInnerNode* parent,
     int branch,
     SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority,
     bool& pending,
     descendCallback&& callback) const
 {
@@ -417,6 +421,7 @@ SHAMap::descendAsync(
             f_.db().asyncFetch(
                 hash.as_uint256(),
                 ledgerSeq_,
+                priority,
                 [this, hash, cb{std::move(callback)}](
                     std::shared_ptr<NodeObject> const& object) {
                     auto node = finishFetch(hash, object);
@@ -1041,7 +1046,17 @@ SHAMap::flushDirty(NodeObjectType t)
 }
 
 int
-SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
+SHAMap::flushDirty(NodeObjectType t, JobQueue& jobQueue, unsigned int threads)
+{
+    return walkSubTree(backed_, t, &jobQueue, threads);
+}
+
+int
+SHAMap::walkSubTree(
+    bool doWrite,
+    NodeObjectType t,
+    JobQueue* jobQueue,
+    unsigned int threads)
 {
     XRPL_ASSERT(
         !doWrite || backed_, "ripple::SHAMap::walkSubTree : valid input");
@@ -1071,104 +1086,188 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         return 1;
     }
 
-    // Stack of {parent,index,child} pointers representing
-    // inner nodes we are in the process of flushing
-    using StackEntry = std::pair<intr_ptr::SharedPtr<SHAMapInnerNode>, int>;
-    std::stack<StackEntry, std::vector<StackEntry>> stack;
-
     node = preFlushNode(std::move(node));
 
-    int pos = 0;
+    // Flush the subtrees below the root concurrently. Once they are done
+    // the serial walk below only has the root itself left to flush.
+    if (jobQueue && threads > 1)
+        flushChildrenParallel(*node, doWrite, t, *jobQueue, threads, flushed);
 
-    // We can't flush an inner node until we flush its children
-    while (1)
+    // Last inner node is the new root_
+    root_ = flushInnerNode(std::move(node), doWrite, t, flushed);
+
+    return flushed;
+}
+
+intr_ptr::SharedPtr<SHAMapInnerNode>
+SHAMap::flushInnerNode(
+    intr_ptr::SharedPtr<SHAMapInnerNode> node,
+    bool doWrite,
+    NodeObjectType t,
+    int& flushed) const
+{
+    // The modified nodes of the subtree, grouped by depth. Each entry
+    // remembers the parent and branch it has to be hooked back into.
+    struct Entry
+    {
+        SHAMapInnerNode* parent;
+        int branch;
+        intr_ptr::SharedPtr<SHAMapTreeNode> node;
+    };
+    std::vector<std::vector<Entry>> levels;
+    levels.push_back({{nullptr, 0, std::move(node)}});
+
+    for (std::size_t depth = 0; depth < levels.size(); ++depth)
     {
-        while (pos < branchFactor)
+        std::vector<Entry> next;
+
+        for (auto const& entry : levels[depth])
         {
-            if (node->isEmptyBranch(pos))
-            {
-                ++pos;
-            }
-            else
+            if (!entry.node->isInner())
+                continue;
+
+            auto inner = static_cast<SHAMapInnerNode*>(entry.node.get());
+
+            XRPL_ASSERT(
+                inner->cowid() == cowid_,
+                "ripple::SHAMap::flushInnerNode : node cowid do match");
+
+            for (int branch = 0; branch < branchFactor; ++branch)
             {
+                if (inner->isEmptyBranch(branch))
+                    continue;
+
                 // No need to do I/O. If the node isn't linked,
                 // it can't need to be flushed
-                int branch = pos;
-                auto child = node->getChild(pos++);
+                auto child = inner->getChild(branch);
 
                 if (child && (child->cowid() != 0))
-                {
-                    // This is a node that needs to be flushed
-
-                    child = preFlushNode(std::move(child));
+                    next.push_back(
+                        {inner, branch, preFlushNode(std::move(child))});
+            }
+        }
 
-                    if (child->isInner())
-                    {
-                        // save our place and work on this node
-
-                        stack.emplace(std::move(node), branch);
-                        // The semantics of this changes when we move to c++-20
-                        // Right now no move will occur; With c++-20 child will
-                        // be moved from.
-                        node = intr_ptr::static_pointer_cast<SHAMapInnerNode>(
-                            std::move(child));
-                        pos = 0;
-                    }
-                    else
-                    {
-                        // flush this leaf
-                        ++flushed;
+        if (!next.empty())
+            levels.push_back(std::move(next));
+    }
 
-                        XRPL_ASSERT(
-                            node->cowid() == cowid_,
-                            "ripple::SHAMap::walkSubTree : node cowid do "
-                            "match");
-                        child->updateHash();
-                        child->unshare();
+    // We can't flush an inner node until we flush its children
+    std::vector<SHAMapTreeNode*> batch;
 
-                        if (doWrite)
-                            child = writeNode(t, std::move(child));
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+        batch.clear();
+        for (auto const& entry : *level)
+        {
+            if (entry.node->isInner())
+                static_cast<SHAMapInnerNode&>(*entry.node)
+                    .updateChildHashes();
 
-                        node->shareChild(branch, child);
-                    }
-                }
-            }
+            batch.push_back(entry.node.get());
         }
 
-        // update the hash of this inner node
-        node->updateHashDeep();
+        SHAMapTreeNode::updateHashes(batch);
 
-        // This inner node can now be shared
-        node->unshare();
+        for (auto& entry : *level)
+        {
+            // This node can now be shared
+            entry.node->unshare();
 
-        if (doWrite)
-            node = intr_ptr::static_pointer_cast<SHAMapInnerNode>(
-                writeNode(t, std::move(node)));
+            if (doWrite)
+                entry.node = writeNode(t, std::move(entry.node));
 
-        ++flushed;
+            ++flushed;
 
-        if (stack.empty())
-            break;
+            // Hook this node to its parent
+            if (entry.parent)
+                entry.parent->shareChild(entry.branch, entry.node);
+        }
+    }
 
-        auto parent = std::move(stack.top().first);
-        pos = stack.top().second;
-        stack.pop();
+    return intr_ptr::static_pointer_cast<SHAMapInnerNode>(
+        std::move(levels.front().front().node));
+}
 
-        // Hook this inner node to its parent
-        XRPL_ASSERT(
-            parent->cowid() == cowid_,
-            "ripple::SHAMap::walkSubTree : parent cowid do match");
-        parent->shareChild(pos, node);
+void
+SHAMap::flushChildrenParallel(
+    SHAMapInnerNode& node,
+    bool doWrite,
+    NodeObjectType t,
+    JobQueue& jobQueue,
+    unsigned int threads,
+    int& flushed) const
+{
+    XRPL_ASSERT(
+        node.cowid() == cowid_,
+        "ripple::SHAMap::flushChildrenParallel : node cowid do match");
+
+    std::array<intr_ptr::SharedPtr<SHAMapTreeNode>, branchFactor> children;
+    std::array<int, branchFactor> counts{};
+    std::vector<int> branches;
+    branches.reserve(branchFactor);
 
-        // Continue with parent's next child, if any
-        node = std::move(parent);
-        ++pos;
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        if (node.isEmptyBranch(branch))
+            continue;
+
+        auto child = node.getChild(branch);
+        if (child && (child->cowid() != 0))
+        {
+            children[branch] = preFlushNode(std::move(child));
+            branches.push_back(branch);
+        }
     }
 
-    // Last inner node is the new root_
-    root_ = std::move(node);
+    if (branches.empty())
+        return;
 
-    return flushed;
+    // No more slices than threads, so no more than that many flush at once
+    auto const sliceSize = (branches.size() + threads - 1) / threads;
+
+    JLOG(journal_.trace()) << "Flushing " << branches.size()
+                           << " subtrees in slices of " << sliceSize;
+
+    // Each slice only touches its own slots of `children` and `counts`
+    jobQueue.parallelFor(
+        jtACCEPT,
+        "SHAMap::flushDirty",
+        branches.size(),
+        sliceSize,
+        [&](std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; ++i)
+            {
+                int const branch = branches[i];
+                auto& child = children[branch];
+
+                if (child->isInner())
+                {
+                    child = flushInnerNode(
+                        intr_ptr::static_pointer_cast<SHAMapInnerNode>(
+                            std::move(child)),
+                        doWrite,
+                        t,
+                        counts[branch]);
+                }
+                else
+                {
+                    child->updateHash();
+                    child->unshare();
+
+                    if (doWrite)
+                        child = writeNode(t, std::move(child));
+
+                    ++counts[branch];
+                }
+            }
+        });
+
+    // Hook the flushed subtrees back into the node in branch order
+    for (int const branch : branches)
+    {
+        node.shareChild(branch, children[branch]);
+        flushed += counts[branch];
+    }
 }
 
 void
@@ -215,6 +215,13 @@ SHAMapInnerNode::updateHash()
 
 void
 SHAMapInnerNode::updateHashDeep()
+{
+    updateChildHashes();
+    updateHash();
+}
+
+void
+SHAMapInnerNode::updateChildHashes()
 {
     SHAMapHash* hashes;
     intr_ptr::SharedPtr<SHAMapTreeNode>* children;
@@ -225,7 +232,6 @@ SHAMapInnerNode::updateHashDeep()
         if (auto p = children[indexNum].get())
             hashes[indexNum] = p->getHash();
     });
-    updateHash();
 }
 
 void
@@ -42,15 +42,24 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     if (!root_)
         return;
 
-    function(*root_);
+    visitNodes(root_, function);
+}
 
-    if (!root_->isInner())
+void
+SHAMap::visitNodes(
+    intr_ptr::SharedPtr<SHAMapTreeNode> const& start,
+    std::function<bool(SHAMapTreeNode&)> const& function) const
+{
+    if (!function(*start))
+        return;
+
+    if (!start->isInner())
         return;
 
     using StackEntry = std::pair<int, intr_ptr::SharedPtr<SHAMapInnerNode>>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
-    auto node = intr_ptr::static_pointer_cast<SHAMapInnerNode>(root_);
+    auto node = intr_ptr::static_pointer_cast<SHAMapInnerNode>(start);
     int pos = 0;
 
     while (true)
@@ -98,6 +107,48 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     }
 }
 
+std::vector<intr_ptr::SharedPtr<SHAMapTreeNode>>
+SHAMap::splitNodes(
+    int depth,
+    std::function<bool(SHAMapTreeNode&)> const& function) const
+{
+    std::vector<intr_ptr::SharedPtr<SHAMapTreeNode>> subtrees;
+
+    if (!root_)
+        return subtrees;
+
+    if (depth == 0)
+    {
+        subtrees.push_back(root_);
+        return subtrees;
+    }
+
+    // The nodes above the split, a level at a time
+    std::vector<intr_ptr::SharedPtr<SHAMapTreeNode>> level{root_};
+    for (int d = 0; d < depth && !level.empty(); ++d)
+    {
+        std::vector<intr_ptr::SharedPtr<SHAMapTreeNode>> next;
+        for (auto const& node : level)
+        {
+            if (!function(*node))
+                return {};
+
+            if (!node->isInner())
+                continue;
+
+            auto& inner = static_cast<SHAMapInnerNode&>(*node);
+            for (int branch = 0; branch < 16; ++branch)
+            {
+                if (!inner.isEmptyBranch(branch))
+                    next.push_back(descendNoStore(inner, branch));
+            }
+        }
+        level = std::move(next);
+    }
+
+    return level;
+}
+
 void
 SHAMap::visitDifferences(
     SHAMap const* have,
@@ -197,20 +248,7 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
             !f_.getFullBelowCache()->touch_if_exists(childHash.as_uint256()))
         {
             bool pending = false;
-            auto d = descendAsync(
-                node,
-                branch,
-                mn.filter_,
-                pending,
-                [node, nodeID, branch, &mn](
-                    intr_ptr::SharedPtr<SHAMapTreeNode> found,
-                    SHAMapHash const&) {
-                    // a read completed asynchronously
-                    std::unique_lock<std::mutex> lock{mn.deferLock_};
-                    mn.finishedReads_.emplace_back(
-                        node, nodeID, branch, std::move(found));
-                    mn.deferCondVar_.notify_one();
-                });
+            auto d = gmn_Descend(mn, node, nodeID, branch, false, pending);
 
             if (pending)
             {
@@ -260,21 +298,78 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
     node = nullptr;
 }
 
+SHAMapTreeNode*
+SHAMap::gmn_Descend(
+    MissingNodes& mn,
+    SHAMapInnerNode* node,
+    SHAMapNodeID const& nodeID,
+    int branch,
+    bool prefetch,
+    bool& pending)
+{
+    return descendAsync(
+        node,
+        branch,
+        mn.filter_,
+        mn.priority_,
+        pending,
+        [node, nodeID, branch, prefetch, &mn](
+            intr_ptr::SharedPtr<SHAMapTreeNode> found, SHAMapHash const&) {
+            // a read completed asynchronously
+            std::unique_lock<std::mutex> lock{mn.deferLock_};
+            mn.finishedReads_.emplace_back(
+                node, nodeID, branch, std::move(found), prefetch);
+            mn.deferCondVar_.notify_one();
+        });
+}
+
+// An inner node that arrived from a deferred read will be walked once the
+// reads in flight drain. Its children are needed then, so read the whole
+// group now while there is room in the pipeline.
+void
+SHAMap::gmn_Prefetch(
+    MissingNodes& mn,
+    SHAMapInnerNode* node,
+    SHAMapNodeID const& nodeID,
+    int pending)
+{
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (pending >= mn.maxDefer_ || mn.max_ <= 0)
+            return;
+
+        if (node->isEmptyBranch(branch) || node->getChildPointer(branch))
+            continue;
+
+        auto const& childHash = node->getChildHash(branch);
+
+        if (mn.missingHashes_.count(childHash) != 0 ||
+            f_.getFullBelowCache()->touch_if_exists(childHash.as_uint256()))
+            continue;
+
+        bool deferred = false;
+        gmn_Descend(mn, node, nodeID, branch, true, deferred);
+
+        // Children found at once are now attached to the node, and those
+        // that are missing are recorded when the walk gets to them
+        if (deferred)
+        {
+            ++mn.deferred_;
+            ++pending;
+        }
+    }
+}
+
 // Wait for deferred reads to finish and
 // process their results
 void
-SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
+SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn, int maxPending)
 {
-    // Process all deferred reads
+    // Reads finish in any order, so take them as they come
     int complete = 0;
-    while (complete != mn.deferred_)
+    while (mn.deferred_ - complete > maxPending)
     {
-        std::tuple<
-            SHAMapInnerNode*,
-            SHAMapNodeID,
-            int,
-            intr_ptr::SharedPtr<SHAMapTreeNode>>
-            deferredNode;
+        MissingNodes::DeferredNode deferredNode;
         {
             std::unique_lock<std::mutex> lock{mn.deferLock_};
 
@@ -287,6 +382,7 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
         auto const& parentID = std::get<1>(deferredNode);
         auto branch = std::get<2>(deferredNode);
         auto nodePtr = std::get<3>(deferredNode);
+        auto const prefetched = std::get<4>(deferredNode);
         auto const& nodeHash = parent->getChildHash(branch);
 
         if (nodePtr)
@@ -294,8 +390,21 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
             nodePtr = parent->canonicalizeChild(branch, std::move(nodePtr));
 
             // When we finish this stack, we need to restart
-            // with the parent of this node
-            mn.resumes_[parent] = parentID;
+            // with the parent of this node. The walk has not reached the
+            // parent of a prefetched node yet, and will find it there.
+            if (!prefetched)
+                mn.resumes_[parent] = parentID;
+
+            if (backed_ && nodePtr->isInner())
+            {
+                auto inner = static_cast<SHAMapInnerNode*>(nodePtr.get());
+                if (!inner->isFullBelow(mn.generation_))
+                    gmn_Prefetch(
+                        mn,
+                        inner,
+                        parentID.getChildNodeID(branch),
+                        mn.deferred_ - complete);
+            }
         }
         else if ((mn.max_ > 0) && (mn.missingHashes_.insert(nodeHash).second))
         {
@@ -305,9 +414,12 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
         }
     }
 
-    mn.finishedReads_.clear();
-    mn.finishedReads_.reserve(mn.maxDefer_);
-    mn.deferred_ = 0;
+    {
+        std::unique_lock<std::mutex> lock{mn.deferLock_};
+        mn.finishedReads_.erase(
+            mn.finishedReads_.begin(), mn.finishedReads_.begin() + complete);
+    }
+    mn.deferred_ -= complete;
 }
 
 /** Get a list of node IDs and hashes for nodes that are part of this SHAMap
@@ -315,7 +427,10 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
     nodes that are not permanently stored locally
 */
 std::vector<std::pair<SHAMapNodeID, uint256>>
-SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
+SHAMap::getMissingNodes(
+    int max,
+    SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority)
 {
     XRPL_ASSERT(
         root_->getHash().isNonZero(),
@@ -325,7 +440,8 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
     MissingNodes mn(
         max,
         filter,
-        512,  // number of async reads per pass
+        priority,
+        f_.db().syncReads(),  // number of async reads in flight
         f_.getFullBelowCache()->getGeneration());
 
     if (!root_->isInner() ||
@@ -386,12 +502,21 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
         }
 
         // We have either emptied the stack or
-        // posted as many deferred reads as we can
+        // posted as many deferred reads as we can.
+        // While the walk can go on, only wait until half the reads are done
+        // so that the rest overlap with it. Nodes that could not be
+        // finished are rechecked once every read is in.
         if (mn.deferred_)
-            gmn_ProcessDeferredReads(mn);
+            gmn_ProcessDeferredReads(
+                mn, (node != nullptr && mn.max_ > 0) ? mn.maxDefer_ / 2 : 0);
 
         if (mn.max_ <= 0)
+        {
+            // No read may complete after mn is gone
+            if (mn.deferred_)
+                gmn_ProcessDeferredReads(mn, 0);
             return std::move(mn.missingNodes_);
+        }
 
         if (node == nullptr)
         {  // We weren't in the middle of processing a node
@@ -178,6 +178,61 @@ SHAMapTreeNode::makeFromPrefix(Slice rawNode, SHAMapHash const& hash)
         ")");
 }
 
+void
+SHAMapTreeNode::updateHashes(std::span<SHAMapTreeNode* const> nodes)
+{
+    // Serialize a bounded number of nodes at a time so that hashing a
+    // large level of the tree does not need a copy of all of it.
+    constexpr std::size_t chunkSize = 1024;
+
+    Serializer s(
+        static_cast<int>(std::min(nodes.size(), chunkSize) * 16 * 32 + 4));
+    std::vector<SHAMapTreeNode*> pending;
+    std::vector<std::size_t> offsets;
+    std::vector<Slice> messages;
+    std::vector<uint256> digests;
+
+    while (!nodes.empty())
+    {
+        auto const chunk = nodes.first(std::min(nodes.size(), chunkSize));
+        nodes = nodes.subspan(chunk.size());
+
+        s.erase();
+        pending.clear();
+        offsets.clear();
+
+        for (auto node : chunk)
+        {
+            // An empty inner node has no serialization; its hash is zero.
+            if (node->isInner() &&
+                static_cast<SHAMapInnerNode*>(node)->isEmpty())
+            {
+                node->hash_.zero();
+                continue;
+            }
+
+            offsets.push_back(s.size());
+            node->serializeWithPrefix(s);
+            pending.push_back(node);
+        }
+        offsets.push_back(s.size());
+
+        messages.clear();
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            messages.emplace_back(
+                static_cast<std::uint8_t const*>(s.data()) + offsets[i],
+                offsets[i + 1] - offsets[i]);
+        }
+
+        digests.resize(pending.size());
+        sha512HalfBatch(messages, digests);
+
+        for (std::size_t i = 0; i < pending.size(); ++i)
+            pending[i]->hash_ = SHAMapHash{digests[i]};
+    }
+}
+
 std::string
 SHAMapTreeNode::getString(SHAMapNodeID const& id) const
 {